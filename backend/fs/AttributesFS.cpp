@@ -8,6 +8,17 @@
 
 #include "AttributesFS.hpp"
 
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace bfs = boost::filesystem;
 namespace y = YAML;
 
@@ -16,6 +27,132 @@ namespace file {
 
 #define ATTRIBUTES_FILE std::string("attributes")
 
+namespace {
+
+typedef std::map<std::string, std::weak_ptr<void>> CacheMap;
+
+// never destroyed, attributes may still be flushed during static destruction
+std::mutex &registry_mutex() {
+    static std::mutex *mutex = new std::mutex();
+    return *mutex;
+}
+
+CacheMap &registry() {
+    static CacheMap *caches = new CacheMap();
+    return *caches;
+}
+
+// errors of write-backs by released caches, reported by flushAll()
+std::map<std::string, std::string> &failed_writes() {
+    static std::map<std::string, std::string> *errors = new std::map<std::string, std::string>();
+    return *errors;
+}
+
+// symbolic links to entities share the attributes of the target
+std::string cache_key(const bfs::path &p) {
+    boost::system::error_code ec;
+    bfs::path canonical = bfs::canonical(p, ec);
+    return ec ? bfs::absolute(p).string() : canonical.string();
+}
+
+bool is_below(const std::string &key, const std::string &prefix) {
+    return key.compare(0, prefix.size(), prefix) == 0 &&
+           (key.size() == prefix.size() || key[prefix.size()] == bfs::path::preferred_separator);
+}
+
+} // anonymous namespace
+
+
+AttributesFS::Cache::~Cache() {
+    std::string error;
+    try {
+        flush();
+    } catch (const std::exception &e) {
+        error = e.what();
+    } catch (...) {
+        error = "Could not write " + file.string();
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    if (!error.empty()) {
+        failed_writes()[key] = error;
+    }
+    CacheMap::iterator it = registry().find(key);
+    if (it != registry().end() && it->second.expired()) {
+        registry().erase(it);
+    }
+}
+
+
+void AttributesFS::Cache::flush() {
+    if (!dirty || detached) {
+        return;
+    }
+    // the entity was removed behind our back
+    if (!bfs::exists(file.parent_path())) {
+        dirty = false;
+        return;
+    }
+
+    std::stringstream out;
+    out << node << std::endl;
+    replaceFile(file, out.str());
+    dirty = false;
+}
+
+
+void AttributesFS::replaceFile(const bfs::path &file, const std::string &content) {
+    bfs::path temp = file;
+    temp += ".tmp";
+
+#ifdef _WIN32
+    std::ofstream ofs(temp.string(), std::ofstream::trunc | std::ofstream::binary);
+    ofs << content;
+    ofs.close();
+    if (!ofs) {
+        throw std::runtime_error("Could not write " + temp.string());
+    }
+    bfs::rename(temp, file);
+#else
+    int fd = ::open(temp.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Could not create " + temp.string());
+    }
+
+    const char *ptr = content.data();
+    size_t left = content.size();
+    bool ok = true;
+    while (ok && left > 0) {
+        ssize_t n = ::write(fd, ptr, left);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        ok = n > 0;
+        if (ok) {
+            ptr += n;
+            left -= static_cast<size_t>(n);
+        }
+    }
+    // without the sync the rename may reach the disk before the data
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok) {
+        boost::system::error_code ec;
+        bfs::remove(temp, ec);
+        throw std::runtime_error("Could not write " + temp.string());
+    }
+
+    bfs::rename(temp, file);
+
+    int dir = ::open(file.parent_path().string().c_str(), O_RDONLY);
+    if (dir >= 0) {
+        ::fsync(dir);
+        ::close(dir);
+    }
+#endif
+}
+
+
 AttributesFS::AttributesFS() { }
 
 
@@ -32,8 +169,25 @@ AttributesFS::AttributesFS(const bfs::path &file_path, FileMode mode)
 
 
 void AttributesFS::open_or_create() {
+    if (cache && !cache->detached) {
+        return;
+    }
+
     bfs::path attr(ATTRIBUTES_FILE);
     bfs::path temp = location() / attr;
+    std::string key = cache_key(location()) + bfs::path::preferred_separator + ATTRIBUTES_FILE;
+
+    // a detached cache must be released after the lock, its destructor takes it
+    std::shared_ptr<Cache> old;
+    old.swap(cache);
+
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    std::weak_ptr<void> &entry = registry()[key];
+    cache = std::static_pointer_cast<Cache>(entry.lock());
+    if (cache) {
+        return;
+    }
+
     if (!bfs::exists(temp)) {
         if (mode > FileMode::ReadOnly) {
             std::ofstream ofs;
@@ -43,27 +197,92 @@ void AttributesFS::open_or_create() {
             throw std::logic_error("Trying to create new attributes in ReadOnly mode!");
         }
     }
-    node = y::LoadFile(temp.string());
+
+    cache = std::make_shared<Cache>();
+    cache->file = temp;
+    cache->key = key;
+    cache->node = y::LoadFile(temp.string());
+    entry = cache;
 }
 
 
 bool AttributesFS::has(const std::string &name) {
     open_or_create();
-    return (node.size() > 0) && (node[name]);
+    return (cache->node.size() > 0) && (cache->node[name]);
 }
 
 
 void AttributesFS::flush() {
-    std::ofstream ofs;
-    bfs::path temp = location() / bfs::path(ATTRIBUTES_FILE);
-    ofs.open(temp.string(), std::ofstream::trunc);
-    if (ofs.is_open()) {
-        ofs << node << std::endl;
+    if (cache) {
+        cache->flush();
     }
-    else {
-        throw std::runtime_error("Could not write to attributes file!");
+}
+
+
+void AttributesFS::flushAll(const bfs::path &location) {
+    const std::string prefix = cache_key(location);
+    std::vector<std::shared_ptr<Cache>> dirty;
+
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (CacheMap::iterator it = registry().lower_bound(prefix);
+             it != registry().end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+            if (is_below(it->first, prefix)) {
+                dirty.push_back(std::static_pointer_cast<Cache>(it->second.lock()));
+            }
+        }
+    }
+
+    for (const std::shared_ptr<Cache> &c : dirty) {
+        if (c) {
+            c->flush();
+        }
+    }
+
+    std::vector<std::string> errors;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        std::map<std::string, std::string> &failed = failed_writes();
+        std::map<std::string, std::string>::iterator it = failed.lower_bound(prefix);
+        while (it != failed.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+            if (is_below(it->first, prefix)) {
+                errors.push_back(it->second);
+                it = failed.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (!errors.empty()) {
+        throw std::runtime_error("Attributes of " + std::to_string(errors.size()) +
+                                 " entities were lost: " + errors.front());
+    }
+}
+
+
+void AttributesFS::invalidate(const bfs::path &location) {
+    if (bfs::is_symlink(location)) {
+        return;
+    }
+
+    const std::string prefix = cache_key(location);
+    std::vector<std::shared_ptr<Cache>> dropped;
+
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    CacheMap::iterator it = registry().lower_bound(prefix);
+    while (it != registry().end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+        if (!is_below(it->first, prefix)) {
+            ++it;
+            continue;
+        }
+        // released after the lock, the destructor takes it again
+        dropped.push_back(std::static_pointer_cast<Cache>(it->second.lock()));
+        if (dropped.back()) {
+            dropped.back()->detached = true;
+        }
+        it = registry().erase(it);
     }
-    ofs.close();
 }
 
 bfs::path AttributesFS::location() const {
@@ -72,7 +291,7 @@ bfs::path AttributesFS::location() const {
 
 nix::ndsize_t AttributesFS::attributeCount() {
     open_or_create();
-    return node.size();
+    return cache->node.size();
 }
 
 void AttributesFS::remove(const std::string &name) {
@@ -80,10 +299,10 @@ void AttributesFS::remove(const std::string &name) {
     if (mode == FileMode::ReadOnly) {
         throw std::logic_error("Trying to remove an attributes in ReadOnly mode!");
     }
-    if (node[name]) {
-        node.remove(name);
+    if (cache->node[name]) {
+        cache->node.remove(name);
+        cache->dirty = true;
     }
-    flush();
 }
 
 } //namespace file
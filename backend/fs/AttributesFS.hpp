@@ -13,6 +13,8 @@
 #include <boost/filesystem.hpp>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <string>
 
 #include <nix/Platform.hpp>
 #include <nix/NDSize.hpp>
@@ -21,17 +23,40 @@
 namespace nix {
 namespace file {
 
+/**
+ * The attributes of an entity, stored as a YAML map in the file "attributes"
+ * in the entity's directory.
+ *
+ * The parsed map is kept in memory and shared by all AttributesFS objects
+ * that refer to the same file, so that changes made through one entity
+ * handle are seen by all others. Changes are written back once, when the
+ * last object referring to the file goes away or when flushAll() is called
+ * for an enclosing directory (File::flush(), File::close()). The file is
+ * replaced atomically, see replaceFile(). Errors of write-backs that happen
+ * when the last object goes away are reported by the next flushAll() of an
+ * enclosing directory.
+ */
 class AttributesFS {
 
 private:
+    struct Cache {
+        boost::filesystem::path file;
+        std::string key;
+        YAML::Node node;
+        bool dirty = false;
+        bool detached = false;
+
+        ~Cache();
+
+        void flush();
+    };
+
     boost::filesystem::path loc;
     FileMode mode;
-    YAML::Node node;
+    std::shared_ptr<Cache> cache;
 
     void open_or_create();
 
-    void flush();
-
 public:
     AttributesFS();
 
@@ -52,12 +77,37 @@ public:
     template <typename T> void set(const std::string &name, const T &value);
 
     ndsize_t attributeCount();
+
+    /**
+     * Write pending changes of these attributes to disk.
+     */
+    void flush();
+
+    /**
+     * Write pending changes of all cached attributes in or below location.
+     * Throws if these or earlier write-backs in location failed.
+     */
+    static void flushAll(const boost::filesystem::path &location);
+
+    /**
+     * Replace the contents of file so that a crash leaves either the old or
+     * the new contents: they are written to a temporary file, which is
+     * synced to disk and renamed over file; then the directory is synced.
+     */
+    static void replaceFile(const boost::filesystem::path &file, const std::string &content);
+
+    /**
+     * Drop all cached attributes in or below location without writing
+     * them, to be called before the directories are removed or moved.
+     * Symbolic links are ignored, the attributes belong to their target.
+     */
+    static void invalidate(const boost::filesystem::path &location);
 };
 
 template <typename T> void AttributesFS::get(const std::string &name, T &value) {
     open_or_create();
     if (has(name)) {
-        value = node[name].as<T>();
+        value = cache->node[name].as<T>();
     }
 }
 
@@ -66,11 +116,11 @@ template <typename T> void AttributesFS::set(const std::string &name, const T &v
     if (mode == FileMode::ReadOnly) {
         throw std::logic_error("Trying to set an attributes in ReadOnly mode!");
     }
-    if (node[name]) {
-        node.remove(name);
+    if (cache->node[name]) {
+        cache->node.remove(name);
     }
-    this->node[name] = value;
-    this->flush();
+    cache->node[name] = value;
+    cache->dirty = true;
 }
 
 } // namespace file
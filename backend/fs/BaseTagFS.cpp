@@ -127,7 +127,7 @@ ndsize_t BaseTagFS::featureCount() const {
 
 std::shared_ptr<base::IFeature> BaseTagFS::getFeature(const std::string &name_or_id) const {
     std::shared_ptr<base::IFeature> feature;
-    boost::optional<bfs::path> p = feature_group.findByNameOrAttribute("name", name_or_id);
+    boost::optional<bfs::path> p = feature_group.findByNameOrAttribute("entity_id", name_or_id);
     if (p) {
         return std::make_shared<FeatureFS>(file(), block(), p->string());
     } else {
@@ -162,7 +162,7 @@ std::shared_ptr<base::IFeature>  BaseTagFS::createFeature(const std::string &nam
 
 
 bool BaseTagFS::deleteFeature(const std::string &name_or_id) {
-    return feature_group.removeObjectByNameOrAttribute("name", name_or_id);
+    return feature_group.removeObjectByNameOrAttribute("entity_id", name_or_id);
 }
 
 
@@ -221,6 +221,21 @@ bool BlockFS::removeEntity(const nix::Identity &ident) {
     return p->removeObjectByNameOrAttribute("entity_id", name);
 }
 
+bool BlockFS::findEntities(ObjectType type, const util::Criterion &criterion,
+                           std::vector<std::shared_ptr<base::IEntity>> &entities) const {
+    // entity directories are named after the entity, everything else
+    // would need the attributes of every entity to be loaded anyway
+    if (criterion.field != util::Criterion::Field::Name || !criterion.value) {
+        return false;
+    }
+
+    std::shared_ptr<base::IEntity> e = getEntity({*criterion.value, "", type});
+    if (e) {
+        entities.push_back(e);
+    }
+    return true;
+}
+
 //--------------------------------------------------
 // Methods concerning sources
 //--------------------------------------------------
@@ -271,7 +286,8 @@ std::shared_ptr<base::IDataArray> BlockFS::createDataArray(const std::string &na
 std::shared_ptr<base::IDataFrame> BlockFS::createDataFrame(const std::string &name,
                                                            const std::string &type,
                                                            const std::vector<Column> &cols,
-                                                           const Compression &compression) {
+                                                           const Compression &compression,
+                                                           DataFrameLayout layout) {
     throw std::runtime_error("not implemented");
 }
 
@@ -88,6 +88,9 @@ public:
 
     bool removeEntity(const nix::Identity &ident);
 
+    bool findEntities(ObjectType type, const util::Criterion &criterion,
+                      std::vector<std::shared_ptr<base::IEntity>> &entities) const;
+
     void addEntity(const nix::Identity &ident);
 
     //--------------------------------------------------
@@ -126,7 +129,8 @@ public:
     std::shared_ptr<base::IDataFrame> createDataFrame(const std::string &name,
                                                       const std::string &type,
                                                       const std::vector<Column> &cols,
-                                                      const Compression &compression);
+                                                      const Compression &compression,
+                                                      DataFrameLayout layout);
 
 
     //--------------------------------------------------
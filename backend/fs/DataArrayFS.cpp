@@ -9,7 +9,6 @@
 #include <nix/util/util.hpp>
 
 #include "DataArrayFS.hpp"
-#include "hdf5/h5x/H5DataSet.hpp" // FIXME
 #include "DimensionFS.hpp"
 
 namespace nix {
@@ -241,87 +240,64 @@ DataArrayFS::~DataArrayFS() {
 }
 
 void DataArrayFS::createData(DataType dtype, const NDSize &size, const Compression &compression) {
-    setDtype(dtype);
-    dataExtent(size);
-    /*
-    if (group().hasData("data")) {
-        throw new std::runtime_error("DataArray alread exists"); //TODO: FIXME, better exception
+    if (hasData()) {
+        throw ConsistencyError("DataArray's data directory already exists!");
     }
 
-    group().createData("data", dtype, size); //FIXME: check if this 2-step creation is needed
-    DataSet ds = group().openData("data");
-    */ //FIXME
+    NDSize chunks = DataSetFS::guessChunking(size, data_type_to_size(dtype));
+    std::vector<ndsize_t> chunk_shape(chunks.begin(), chunks.end());
+
+    bfs::create_directories(dataLocation());
+    Directory::invalidate(dataLocation());
+    setDtype(dtype);
+    setAttr("chunks", chunk_shape);
+    dataExtent(size);
 }
 
 bool DataArrayFS::hasData() const {
     return hasObject("data");
 }
 
-void DataArrayFS::write(DataType dtype, const void *data, const NDSize &count, const NDSize &offset) {
-    /*
-    DataSet ds;
+bfs::path DataArrayFS::dataLocation() const {
+    return bfs::path(location()) / bfs::path("data");
+}
 
-    if (!group().hasData("data")) {
-        //FIXME: this case should actually never be possible, replace with exception?
-        ds = group().createData("data", dtype, count);
-    } else {
-        ds = group().openData("data");
+DataSetFS DataArrayFS::dataSet() const {
+    if (!hasData()) {
+        throw ConsistencyError("DataArray with missing data directory");
     }
 
-    if (offset.size()) {
-        Selection fileSel = ds.createSelection();
-        fileSel.select(count, offset);
-        Selection memSel(DataSpace::create(count, false));
+    std::vector<ndsize_t> chunks;
+    getAttr("chunks", chunks);
+    return DataSetFS(dataLocation(), dataType(), dataExtent(), NDSize(chunks), fileMode());
+}
 
-        ds.write(dtype, data, fileSel, memSel);
-    } else {
-        ds.write(dtype, count, data);
-    }
-    */ // FIXME
+void DataArrayFS::write(DataType dtype, const void *data, const NDSize &count, const NDSize &offset) {
+    DataSetFS ds = dataSet();
+    ds.write(dtype, data, count, offset);
 }
 
 void DataArrayFS::read(DataType dtype, void *data, const NDSize &count, const NDSize &offset) const {
-    if (!hasObject("data")) {
-        return;
-    }
-    /*
-    DataSet ds = group().openData("data");
-
-    if (offset.size()) {
-        Selection fileSel = ds.createSelection();
-        // if count.size() == 0, i.e. we want to read a scalar,
-        // we have to supply something that fileSel can make sense of
-        fileSel.select(count ? count : NDSize(offset.size(), 1), offset);
-        Selection memSel(DataSpace::create(count, false));
-
-        ds.read(dtype, data, fileSel, memSel);
-    } else {
-        ds.read(dtype, count, data);
-    }
-    */
+    DataSetFS ds = dataSet();
+    ds.read(dtype, data, count, offset);
 }
 
 NDSize DataArrayFS::dataExtent(void) const {
     if (!hasAttr("extent")) {
         return NDSize{};
     }
-    std::vector<int> ext;
+    std::vector<ndsize_t> ext;
     getAttr("extent", ext);
-    NDSize extent(ext.size());
-    for (ndsize_t i = 0; i < ext.size(); i++) {
-        extent[i] = ext[i];
-    }
-    return extent;
+    return NDSize(ext);
 }
 
 void DataArrayFS::dataExtent(const NDSize &extent) {
-    std::vector<int> ext;
-    for (ndsize_t i = 0; i < extent.size(); i++) {
-        ext.push_back(extent[i]);
-    }
-    if (hasAttr("extent")){
+    if (hasAttr("extent")) {
+        DataSetFS ds = dataSet();
+        ds.setExtent(extent);
         removeAttr("extent");
     }
+    std::vector<ndsize_t> ext(extent.begin(), extent.end());
     setAttr("extent", ext);
 }
 
@@ -335,6 +311,34 @@ DataType DataArrayFS::dataType(void) const {
 }
 
 
+void DataArrayFS::writeBufferSize(size_t bytes) {
+    write_buffer_size = bytes;
+}
+
+
+size_t DataArrayFS::writeBufferSize() const {
+    return write_buffer_size;
+}
+
+
+void DataArrayFS::readAheadSize(size_t bytes) {
+    read_ahead_size = bytes;
+}
+
+
+size_t DataArrayFS::readAheadSize() const {
+    return read_ahead_size;
+}
+
+
+std::shared_ptr<const void> DataArrayFS::mapData(DataType dtype) const {
+    if (!hasData() || dtype == DataType::String) {
+        return std::shared_ptr<const void>();
+    }
+    return dataSet().map(dtype);
+}
+
+
 void DataArrayFS::setDtype(nix::DataType dtype) {
     if (hasAttr("dtype")) {
         removeAttr("dtype");
@@ -20,6 +20,7 @@
 
 #include <boost/multi_array.hpp>
 #include "Directory.hpp"
+#include "DataSetFS.hpp"
 
 
 namespace nix {
@@ -35,8 +36,15 @@ private:
     static const NDSize MAX_SIZE_1D;
 
     Directory dimensions;
+    size_t write_buffer_size = 0;
+    size_t read_ahead_size = 0;
 
     void setDtype(nix::DataType dtype);
+
+    boost::filesystem::path dataLocation() const;
+
+    DataSetFS dataSet() const;
+
 public:
 
     /**
@@ -160,6 +168,28 @@ public:
 
     DataType dataType(void) const;
 
+    /**
+     * The data is written into memory mapped chunk files, so writes are not
+     * buffered; the size is only kept.
+     */
+    void writeBufferSize(size_t bytes);
+
+
+    size_t writeBufferSize() const;
+
+
+    /**
+     * The chunk files are memory mapped and read ahead by the operating
+     * system already; the size is only kept.
+     */
+    void readAheadSize(size_t bytes);
+
+
+    size_t readAheadSize() const;
+
+
+    std::shared_ptr<const void> mapData(DataType dtype) const;
+
 };
 
 
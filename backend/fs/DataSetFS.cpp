@@ -0,0 +1,685 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include "DataSetFS.hpp"
+#include "Directory.hpp"
+
+#include <nix/Exception.hpp>
+#include "hdf5/h5x/H5DataType.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bfs = boost::filesystem;
+
+namespace nix {
+namespace file {
+
+#define CHUNK_MAX 1024*1024
+#define CHUNK_EXT std::string(".npy")
+
+namespace {
+
+#define NPY_MAGIC std::string("\x93NUMPY", 6)
+
+bool host_is_little_endian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const unsigned char *>(&probe) == 1;
+}
+
+
+void swap_bytes(char *data, size_t nelms, size_t esize) {
+    if (esize < 2) {
+        return;
+    }
+    for (size_t i = 0; i < nelms; i++) {
+        std::reverse(data + i * esize, data + (i + 1) * esize);
+    }
+}
+
+
+std::string npy_descr(DataType dtype) {
+    switch (dtype) {
+        case DataType::Bool:   return "|b1";
+        case DataType::Char:   return "|S1";
+        case DataType::Int8:   return "|i1";
+        case DataType::UInt8:  return "|u1";
+        case DataType::Int16:  return "<i2";
+        case DataType::UInt16: return "<u2";
+        case DataType::Int32:  return "<i4";
+        case DataType::UInt32: return "<u4";
+        case DataType::Int64:  return "<i8";
+        case DataType::UInt64: return "<u8";
+        case DataType::Float:  return "<f4";
+        case DataType::Double: return "<f8";
+        default:
+            throw std::invalid_argument("DataSetFS: unsupported data type " + data_type_to_string(dtype));
+    }
+}
+
+
+std::string npy_shape(const NDSize &shape) {
+    std::string str = "(";
+    for (size_t i = 0; i < shape.size(); i++) {
+        str += std::to_string(shape[i]);
+        str += shape.size() == 1 ? "," : (i + 1 < shape.size() ? ", " : "");
+    }
+    return str + ")";
+}
+
+
+/*
+ * The header of a version 1.0 NPY file, formatted like numpy.save does:
+ * the magic string, the version, the length of the header dict and the
+ * dict itself, padded with spaces and a newline to a multiple of 64 bytes
+ * so that the payload is aligned.
+ */
+std::string npy_header(DataType dtype, const NDSize &shape) {
+    std::string dict = "{'descr': '" + npy_descr(dtype) + "', 'fortran_order': False, 'shape': " +
+                       npy_shape(shape) + ", }";
+
+    const size_t prefix = NPY_MAGIC.size() + 4;
+    const size_t total = (prefix + dict.size() + 1 + 63) / 64 * 64;
+    dict.append(total - prefix - dict.size() - 1, ' ');
+    dict += '\n';
+
+    std::string header = NPY_MAGIC;
+    header += '\x01';
+    header += '\x00';
+    header += static_cast<char>(dict.size() & 0xff);
+    header += static_cast<char>((dict.size() >> 8) & 0xff);
+    return header + dict;
+}
+
+
+/*
+ * Check the header of an NPY file against the expected header and return
+ * the offset of the payload. Files written by numpy itself are accepted as
+ * long as type, order and shape match, regardless of version and padding.
+ */
+size_t npy_payload_offset(const char *data, size_t size, const std::string &expected, const bfs::path &path) {
+    const std::string error = "DataSetFS: not a matching NPY file " + path.string();
+
+    if (size >= expected.size() && std::equal(expected.begin(), expected.end(), data)) {
+        return expected.size();
+    }
+
+    if (size < 10 || std::string(data, NPY_MAGIC.size()) != NPY_MAGIC) {
+        throw std::runtime_error(error);
+    }
+
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    size_t start = 0, len = 0;
+    if (bytes[6] == 1) {
+        start = 10;
+        len = bytes[8] | (bytes[9] << 8);
+    } else if ((bytes[6] == 2 || bytes[6] == 3) && size >= 12) {
+        start = 12;
+        len = bytes[8] | (bytes[9] << 8) | (bytes[10] << 16) | (static_cast<size_t>(bytes[11]) << 24);
+    } else {
+        throw std::runtime_error(error);
+    }
+    if (start + len > size) {
+        throw std::runtime_error(error);
+    }
+
+    // the dict of the expected header, without the padding
+    const size_t dict_start = NPY_MAGIC.size() + 4;
+    const std::string want = expected.substr(dict_start, expected.find('}') - dict_start);
+    const std::string dict(data + start, len);
+
+    const size_t descr = want.find("'descr': ");
+    const size_t order = want.find("'fortran_order': ");
+    const size_t shape = want.find("'shape': ");
+    const std::string items[] = {
+        want.substr(descr, want.find(',', descr) - descr),
+        want.substr(order, want.find(',', order) - order),
+        want.substr(shape, want.find(')', shape) + 1 - shape)
+    };
+    for (const std::string &item : items) {
+        if (dict.find(item) == std::string::npos) {
+            throw std::runtime_error(error);
+        }
+    }
+
+    return start + len;
+}
+
+
+/*
+ * A chunk file mapped into memory. Files opened for writing are created
+ * with the given NPY header and the payload of a whole chunk if necessary;
+ * files opened for reading that do not exist are reported as !present().
+ * data() points to the payload behind the header.
+ */
+class MappedChunk {
+
+public:
+    MappedChunk(const bfs::path &path, const std::string &header, size_t nbytes, bool writable)
+        : path(path), length(0), writable(writable), ptr(nullptr), offset(0) {
+#ifdef _WIN32
+        std::ifstream ifs(path.string(), std::ios::binary);
+        if (!ifs && !writable) {
+            return;
+        }
+        if (ifs) {
+            buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        } else {
+            buffer.assign(header.begin(), header.end());
+            buffer.resize(header.size() + nbytes, 0);
+        }
+        length = buffer.size();
+        ptr = buffer.data();
+#else
+        int fd = ::open(path.string().c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (fd < 0) {
+            if (!writable && errno == ENOENT) {
+                return;
+            }
+            throw std::runtime_error("DataSetFS: could not open chunk " + path.string());
+        }
+
+        struct stat st;
+        bool ok = ::fstat(fd, &st) == 0;
+        length = ok ? static_cast<size_t>(st.st_size) : 0;
+        if (ok && length == 0 && writable) {
+            // new chunk, the payload is zeroed by ftruncate
+            ok = ::pwrite(fd, header.data(), header.size(), 0) == static_cast<ssize_t>(header.size()) &&
+                 ::ftruncate(fd, static_cast<off_t>(header.size() + nbytes)) == 0;
+            length = header.size() + nbytes;
+        }
+
+        void *addr = MAP_FAILED;
+        if (ok && length > 0) {
+            int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+            addr = ::mmap(nullptr, length, prot, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("DataSetFS: could not map chunk " + path.string());
+        }
+        ptr = static_cast<char *>(addr);
+#endif
+        offset = npy_payload_offset(ptr, length, header, path);
+        if (length - offset < nbytes) {
+            release();
+            throw std::runtime_error("DataSetFS: truncated chunk " + path.string());
+        }
+    }
+
+    ~MappedChunk() {
+        release();
+    }
+
+    MappedChunk(const MappedChunk &) = delete;
+    MappedChunk &operator=(const MappedChunk &) = delete;
+
+    bool present() const { return ptr != nullptr; }
+
+    char *data() { return ptr + offset; }
+
+private:
+
+    void release() {
+        if (ptr == nullptr) {
+            return;
+        }
+#ifdef _WIN32
+        if (writable) {
+            std::ofstream ofs(path.string(), std::ios::binary | std::ios::trunc);
+            ofs.write(buffer.data(), length);
+        }
+#else
+        ::munmap(ptr, length);
+#endif
+        ptr = nullptr;
+    }
+
+    bfs::path path;
+    size_t    length;
+    bool      writable;
+    char     *ptr;
+    size_t    offset;
+#ifdef _WIN32
+    std::vector<char> buffer;
+#endif
+};
+
+
+NDSize row_major_strides(const NDSize &shape) {
+    NDSize strides(shape.size(), 1);
+    for (size_t i = shape.size(); i > 1; i--) {
+        strides[i - 2] = strides[i - 1] * shape[i - 1];
+    }
+    return strides;
+}
+
+
+/*
+ * Call f(chunk_pos, buf_pos, n) for every contiguous run of n elements
+ * in the intersection of the chunk that starts at origin with the
+ * selection [offset, offset + count). Positions are element indices
+ * into the chunk and into the (row-major) selection buffer.
+ */
+template<typename F>
+void for_each_run(const NDSize &origin, const NDSize &chunks,
+                  const NDSize &offset, const NDSize &count, F f) {
+    const size_t rank = chunks.size();
+    NDSize start(rank), end(rank);
+
+    for (size_t i = 0; i < rank; i++) {
+        start[i] = std::max(origin[i], offset[i]);
+        end[i] = std::min(origin[i] + chunks[i], offset[i] + count[i]);
+        if (start[i] >= end[i]) {
+            return;
+        }
+    }
+
+    const NDSize cstrides = row_major_strides(chunks);
+    const NDSize bstrides = row_major_strides(count);
+    const size_t n = static_cast<size_t>(end[rank - 1] - start[rank - 1]);
+
+    NDSize pos(start);
+    while (true) {
+        ndsize_t cpos = 0, bpos = 0;
+        for (size_t i = 0; i < rank; i++) {
+            cpos += (pos[i] - origin[i]) * cstrides[i];
+            bpos += (pos[i] - offset[i]) * bstrides[i];
+        }
+        f(static_cast<size_t>(cpos), static_cast<size_t>(bpos), n);
+
+        // advance all but the last dimension
+        size_t d = rank - 1;
+        bool done = true;
+        while (d-- > 0) {
+            if (++pos[d] < end[d]) {
+                done = false;
+                break;
+            }
+            pos[d] = start[d];
+        }
+        if (done) {
+            return;
+        }
+    }
+}
+
+
+/*
+ * Call f(index) for the grid index of every chunk that intersects the
+ * selection [offset, offset + count).
+ */
+template<typename F>
+void for_each_chunk(const NDSize &chunks, const NDSize &offset, const NDSize &count, F f) {
+    const size_t rank = chunks.size();
+    NDSize first(rank), last(rank);
+
+    for (size_t i = 0; i < rank; i++) {
+        if (count[i] == 0) {
+            return;
+        }
+        first[i] = offset[i] / chunks[i];
+        last[i] = (offset[i] + count[i] - 1) / chunks[i];
+    }
+
+    NDSize index(first);
+    while (true) {
+        f(index);
+
+        size_t d = rank;
+        bool done = true;
+        while (d-- > 0) {
+            if (++index[d] <= last[d]) {
+                done = false;
+                break;
+            }
+            index[d] = first[d];
+        }
+        if (done) {
+            return;
+        }
+    }
+}
+
+
+void convert_values(DataType source, DataType destination, void *data, size_t nelms) {
+    hdf5::h5x::DataType h5_src = hdf5::data_type_to_h5_memtype(source);
+    hdf5::h5x::DataType h5_dst = hdf5::data_type_to_h5_memtype(destination);
+
+    hdf5::HErr res = H5Tconvert(h5_src.h5id(), h5_dst.h5id(), nelms, data, nullptr, H5P_DEFAULT);
+    res.check("DataSetFS: could not convert data");
+}
+
+
+void check_numeric(DataType dtype) {
+    if (dtype == DataType::String || dtype == DataType::Nothing || dtype == DataType::Opaque) {
+        throw std::invalid_argument("DataSetFS: unsupported data type " + data_type_to_string(dtype));
+    }
+}
+
+} // anonymous namespace
+
+
+DataSetFS::DataSetFS(const bfs::path &location, DataType dtype,
+                     const NDSize &extent, const NDSize &chunks, FileMode mode)
+    : loc(location), dtype(dtype), extent(extent), chunks(chunks), mode(mode) {
+
+    // scalar data is stored as a single element in a single chunk
+    if (this->chunks.size() == 0) {
+        this->chunks = NDSize{1};
+    }
+    if (this->extent.size() && this->extent.size() != this->chunks.size()) {
+        throw IncompatibleDimensions("Rank of chunks and extent differ", "DataSetFS::DataSetFS");
+    }
+    header = npy_header(dtype, this->chunks);
+}
+
+
+NDSize DataSetFS::guessChunking(NDSize dims, size_t element_size) {
+    if (dims.size() == 0) {
+        return NDSize{1};
+    }
+
+    // the chunks split the first growing axis only; further growing axes
+    // have no known extent, their guess is halved until a row fits. A
+    // fixed extent may still grow later, along its first axis
+    size_t grow = dims.size();
+    for (size_t i = 0; i < dims.size() && grow == dims.size(); i++) {
+        if (dims[i] == 0) {
+            grow = i;
+        }
+    }
+    const bool fixed = grow == dims.size();
+    if (fixed) {
+        grow = 0;
+    }
+
+    std::vector<bool> guessed(dims.size(), false);
+    for (size_t i = grow + 1; i < dims.size(); i++) {
+        if (dims[i] == 0) {
+            dims[i] = 1024;
+            guessed[i] = true;
+        }
+    }
+
+    ndsize_t row_bytes = element_size;
+    for (size_t i = 0; i < dims.size(); i++) {
+        if (i != grow) {
+            row_bytes *= dims[i];
+        }
+    }
+    for (size_t i = dims.size() - 1; i > grow && row_bytes > CHUNK_MAX; i--) {
+        while (guessed[i] && dims[i] > 1 && row_bytes > CHUNK_MAX) {
+            row_bytes /= dims[i];
+            dims[i] = (dims[i] + 1) / 2;
+            row_bytes *= dims[i];
+        }
+    }
+
+    // a power of two of rows, up to 1 MiB; a fixed extent keeps all of
+    // its rows in the first chunk, so that it stays in one file until it grows
+    ndsize_t rows = 1;
+    while (rows * 2 * row_bytes <= CHUNK_MAX) {
+        rows *= 2;
+    }
+    dims[grow] = fixed ? std::max(dims[grow], rows) : rows;
+    return dims;
+}
+
+
+bfs::path DataSetFS::chunkPath(const NDSize &index) const {
+    std::string name;
+    for (size_t i = 0; i < index.size(); i++) {
+        if (i) {
+            name += '.';
+        }
+        name += std::to_string(index[i]);
+    }
+    return loc / bfs::path(name + CHUNK_EXT);
+}
+
+
+size_t DataSetFS::chunkBytes() const {
+    return check::fits_in_size_t(chunks.nelms() * data_type_to_size(dtype),
+                                 "DataSetFS: chunk size exceeds memory");
+}
+
+
+void DataSetFS::select(const NDSize &count, const NDSize &offset, NDSize &sel_count, NDSize &sel_offset) const {
+    const NDSize grid = extent.size() ? extent : NDSize{1};
+    const size_t rank = grid.size();
+
+    if (!offset) {
+        sel_offset = NDSize(rank, 0);
+        sel_count = grid;
+    } else {
+        if (extent.size() && offset.size() != rank) {
+            throw IncompatibleDimensions("Rank of offset and data differ", "DataSetFS::select");
+        }
+        sel_offset = extent.size() ? offset : NDSize{0};
+        sel_count = NDSize(rank, 1);
+        for (size_t i = 0; i < rank && i < count.size(); i++) {
+            sel_count[i] = count[i];
+        }
+    }
+
+    if (count && count.nelms() != sel_count.nelms()) {
+        throw IncompatibleDimensions("Number of elements of count and selection differ", "DataSetFS::select");
+    }
+
+    for (size_t i = 0; i < rank; i++) {
+        if (sel_offset[i] + sel_count[i] > grid[i]) {
+            throw OutOfBounds("DataSetFS: selection exceeds the extent of the data", sel_offset[i] + sel_count[i]);
+        }
+    }
+}
+
+
+void DataSetFS::read(DataType memtype, void *data, const NDSize &count, const NDSize &offset) const {
+    check_numeric(memtype);
+
+    NDSize sel_count, sel_offset;
+    select(count, offset, sel_count, sel_offset);
+
+    const size_t nelms = check::fits_in_size_t(sel_count.nelms(), "DataSetFS: selection exceeds memory");
+    const size_t esize = data_type_to_size(dtype);
+    const size_t msize = data_type_to_size(memtype);
+
+    // the selection is gathered in the file type, converted in place
+    // afterwards, so the buffer must hold the larger of both types
+    std::vector<char> tmp;
+    char *buffer = static_cast<char *>(data);
+    if (memtype != dtype) {
+        tmp.resize(nelms * std::max(esize, msize));
+        buffer = tmp.data();
+    }
+
+    const size_t nbytes = chunkBytes();
+    for_each_chunk(chunks, sel_offset, sel_count, [&](const NDSize &index) {
+        MappedChunk chunk(chunkPath(index), header, nbytes, false);
+        const NDSize origin = index * chunks;
+
+        if (chunk.present()) {
+            const char *src = chunk.data();
+            for_each_run(origin, chunks, sel_offset, sel_count, [&](size_t cpos, size_t bpos, size_t n) {
+                std::memcpy(buffer + bpos * esize, src + cpos * esize, n * esize);
+            });
+        } else {
+            for_each_run(origin, chunks, sel_offset, sel_count, [&](size_t, size_t bpos, size_t n) {
+                std::memset(buffer + bpos * esize, 0, n * esize);
+            });
+        }
+    });
+
+    if (!host_is_little_endian()) {
+        swap_bytes(buffer, nelms, esize);
+    }
+    if (memtype != dtype) {
+        convert_values(dtype, memtype, buffer, nelms);
+        std::memcpy(data, buffer, nelms * msize);
+    }
+}
+
+
+std::shared_ptr<const void> DataSetFS::map(DataType memtype) const {
+    // the data is one piece only if it fits in the first chunk and the
+    // chunk has its shape in all but the first dimension
+    bool whole = memtype == dtype && host_is_little_endian() && extent.size() > 0 && extent.nelms() > 0;
+    for (size_t i = 0; whole && i < extent.size(); i++) {
+        whole = i == 0 ? extent[i] <= chunks[i] : extent[i] == chunks[i];
+    }
+    if (!whole) {
+        return std::shared_ptr<const void>();
+    }
+
+    std::shared_ptr<MappedChunk> chunk = std::make_shared<MappedChunk>(chunkPath(NDSize(extent.size(), 0)),
+                                                                       header, chunkBytes(), false);
+    if (!chunk->present()) {
+        return std::shared_ptr<const void>();
+    }
+    return std::shared_ptr<const void>(chunk, chunk->data());
+}
+
+
+void DataSetFS::write(DataType memtype, const void *data, const NDSize &count, const NDSize &offset) {
+    if (mode == FileMode::ReadOnly) {
+        throw std::logic_error("DataSetFS: trying to write data in ReadOnly mode!");
+    }
+    check_numeric(memtype);
+
+    NDSize sel_count, sel_offset;
+    select(count, offset, sel_count, sel_offset);
+
+    const size_t nelms = check::fits_in_size_t(sel_count.nelms(), "DataSetFS: selection exceeds memory");
+    const size_t esize = data_type_to_size(dtype);
+    const size_t msize = data_type_to_size(memtype);
+
+    // the payload is always little-endian
+    std::vector<char> tmp;
+    const char *buffer = static_cast<const char *>(data);
+    if (memtype != dtype || !host_is_little_endian()) {
+        tmp.resize(nelms * std::max(esize, msize));
+        std::memcpy(tmp.data(), data, nelms * msize);
+        if (memtype != dtype) {
+            convert_values(memtype, dtype, tmp.data(), nelms);
+        }
+        if (!host_is_little_endian()) {
+            swap_bytes(tmp.data(), nelms, esize);
+        }
+        buffer = tmp.data();
+    }
+
+    if (!bfs::exists(loc)) {
+        bfs::create_directories(loc);
+        Directory::invalidate(loc);
+    }
+
+    const size_t nbytes = chunkBytes();
+    for_each_chunk(chunks, sel_offset, sel_count, [&](const NDSize &index) {
+        MappedChunk chunk(chunkPath(index), header, nbytes, true);
+        const NDSize origin = index * chunks;
+
+        char *dst = chunk.data();
+        for_each_run(origin, chunks, sel_offset, sel_count, [&](size_t cpos, size_t bpos, size_t n) {
+            std::memcpy(dst + cpos * esize, buffer + bpos * esize, n * esize);
+        });
+    });
+}
+
+
+void DataSetFS::setExtent(const NDSize &new_extent) {
+    if (mode == FileMode::ReadOnly) {
+        throw std::logic_error("DataSetFS: trying to change the extent in ReadOnly mode!");
+    }
+    if (new_extent.size() != extent.size()) {
+        throw IncompatibleDimensions("Cannot change the rank of the data", "DataSetFS::setExtent");
+    }
+
+    bool shrinks = false;
+    for (size_t i = 0; i < extent.size(); i++) {
+        shrinks = shrinks || new_extent[i] < extent[i];
+    }
+
+    if (shrinks && bfs::exists(loc)) {
+        const size_t rank = chunks.size();
+        const size_t esize = data_type_to_size(dtype);
+        const size_t nbytes = chunkBytes();
+
+        std::vector<bfs::path> files;
+        std::copy(bfs::directory_iterator(loc), bfs::directory_iterator(), std::back_inserter(files));
+
+        for (const bfs::path &file : files) {
+            // chunk files are named "i.j.k.npy"
+            if (file.extension().string() != CHUNK_EXT) {
+                continue;
+            }
+            std::string name = file.stem().string();
+            NDSize index(rank);
+            size_t parsed = 0;
+            const char *p = name.c_str();
+            char *next = nullptr;
+            while (parsed < rank && *p) {
+                index[parsed++] = std::strtoull(p, &next, 10);
+                if (next == p || (*next != '.' && *next != '\0')) {
+                    parsed = rank + 1;
+                    break;
+                }
+                p = *next ? next + 1 : next;
+            }
+            if (parsed != rank || *p) {
+                continue;
+            }
+
+            const NDSize origin = index * chunks;
+            bool outside = false, edge = false;
+            for (size_t i = 0; i < rank; i++) {
+                outside = outside || origin[i] >= new_extent[i];
+                edge = edge || origin[i] + chunks[i] > new_extent[i];
+            }
+
+            if (outside) {
+                bfs::remove(file);
+            } else if (edge) {
+                MappedChunk chunk(file, header, nbytes, true);
+                char *dst = chunk.data();
+                for (size_t d = 0; d < rank; d++) {
+                    if (origin[d] + chunks[d] <= new_extent[d]) {
+                        continue;
+                    }
+                    NDSize tail_offset(origin), tail_count(chunks);
+                    tail_offset[d] = new_extent[d];
+                    tail_count[d] = origin[d] + chunks[d] - new_extent[d];
+                    for_each_run(origin, chunks, tail_offset, tail_count, [&](size_t cpos, size_t, size_t n) {
+                        std::memset(dst + cpos * esize, 0, n * esize);
+                    });
+                }
+            }
+        }
+    }
+
+    extent = new_extent;
+}
+
+} // namespace file
+} // namespace nix
@@ -0,0 +1,112 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_DATASETFS_HPP
+#define NIX_DATASETFS_HPP
+
+#include <nix/DataType.hpp>
+#include <nix/NDSize.hpp>
+#include <nix/base/IFile.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <memory>
+#include <string>
+
+namespace nix {
+namespace file {
+
+/**
+ * @brief Chunked raw binary storage of n-dimensional data in a directory.
+ *
+ * The data is split into chunks of a fixed shape, every chunk is stored
+ * in its own file named after its index in the chunk grid, e.g. "0.3.npy"
+ * for the chunk that starts at {0, 3 * chunks[1]}. A chunk file is a NumPy
+ * NPY file (version 1.0) of the shape of the chunk that holds its elements
+ * in row-major and little-endian order, so it can be loaded, or mapped with
+ * numpy.load(path, mmap_mode='r'), without conversion. This holds also for
+ * the chunks at the edge that are only partially inside the extent. Data
+ * created with a fixed extent is stored as a single chunk; growing data is
+ * split along one axis only, so the chunks concatenated in the order of
+ * their index are the whole array.
+ * Chunks that were never written are not stored and read as zeros.
+ *
+ * Reads and writes of hyperslabs map the affected chunk files into memory
+ * and copy the selected runs of elements directly from and to the payload
+ * behind the NPY header; changing the extent only touches
+ * files if the data shrinks.
+ *
+ * The data type, extent and chunk shape are not stored here but passed in
+ * by the owner, see DataArrayFS.
+ */
+class DataSetFS {
+
+public:
+
+    DataSetFS(const boost::filesystem::path &location, DataType dtype,
+              const NDSize &extent, const NDSize &chunks, FileMode mode = FileMode::ReadOnly);
+
+    /**
+     * @brief Guess a chunk shape for data of the given extent.
+     *
+     * The first dimension of size 0, or the first dimension if there is
+     * none, is assumed to grow and split into runs of a power of two of
+     * rows of up to 1 MiB; the other dimensions are kept whole, further
+     * dimensions of size 0 get a guess. Without dimensions of size 0 the
+     * first chunk holds at least the whole extent, i.e. data that does not
+     * grow is stored in a single file.
+     */
+    static NDSize guessChunking(NDSize dims, size_t element_size);
+
+    void read(DataType dtype, void *data, const NDSize &count, const NDSize &offset) const;
+
+    void write(DataType dtype, const void *data, const NDSize &count, const NDSize &offset);
+
+    /**
+     * @brief Map the data read-only into memory, if it is stored in a
+     *        single chunk file in the given type; empty otherwise.
+     */
+    std::shared_ptr<const void> map(DataType dtype) const;
+
+    /**
+     * @brief Change the extent of the data.
+     *
+     * Chunks outside of the new extent are removed and the parts of the
+     * chunks at the new edge that fall outside of it are zeroed, so that
+     * growing the data again reveals zeros, as in the HDF5 backend.
+     */
+    void setExtent(const NDSize &extent);
+
+    NDSize size() const { return extent; }
+
+    NDSize chunking() const { return chunks; }
+
+    DataType dataType() const { return dtype; }
+
+    boost::filesystem::path location() const { return loc; }
+
+    boost::filesystem::path chunkPath(const NDSize &index) const;
+
+private:
+
+    void select(const NDSize &count, const NDSize &offset, NDSize &sel_count, NDSize &sel_offset) const;
+
+    size_t chunkBytes() const;
+
+    boost::filesystem::path loc;
+    std::string header;
+    DataType dtype;
+    NDSize   extent;
+    NDSize   chunks;
+    FileMode mode;
+};
+
+} // namespace file
+} // namespace nix
+
+#endif //NIX_DATASETFS_HPP
@@ -9,11 +9,256 @@
 #include <iostream>
 #include "Directory.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <set>
+
 namespace bfs = boost::filesystem;
 
 namespace nix {
 namespace file {
 
+#define INDEX_FILE std::string(".entity_ids")
+
+namespace {
+
+typedef std::map<std::string, std::weak_ptr<void>> ListingMap;
+
+// never destroyed, listings may still be flushed during static destruction
+std::mutex &registry_mutex() {
+    static std::mutex *mutex = new std::mutex();
+    return *mutex;
+}
+
+ListingMap &registry() {
+    static ListingMap *listings = new ListingMap();
+    return *listings;
+}
+
+// counts removed entries, symbolic links to them are dangling now
+std::atomic<size_t> removals(0);
+
+std::string dir_key(const bfs::path &p) {
+    boost::system::error_code ec;
+    bfs::path canonical = bfs::canonical(p, ec);
+    return ec ? bfs::absolute(p).string() : canonical.string();
+}
+
+bool is_below(const std::string &key, const std::string &prefix) {
+    return key.compare(0, prefix.size(), prefix) == 0 &&
+           (key.size() == prefix.size() || key[prefix.size()] == bfs::path::preferred_separator);
+}
+
+} // anonymous namespace
+
+
+struct Directory::Listing {
+    bfs::path dir;
+    bool loaded = false;
+    bool has_links = false;
+    size_t checked = 0;
+    bool ids_loaded = false;
+    bool writable = false;
+    bool dirty = false;
+
+    std::vector<std::string> names;           // sorted names of the sub directories
+    std::set<std::string> pending;            // sub directories not yet in the id index
+    std::map<std::string, std::string> ids;   // entity id -> name
+    std::map<std::string, std::string> id_of; // name -> entity id
+
+    ~Listing();
+
+    void load();
+    void clear();
+    void added(const std::string &name);
+    void removed(const std::string &name);
+    void forget(const std::string &name);
+    void loadIds();
+    void reindex();
+    void resolvePending();
+    void flush();
+};
+
+
+Directory::Listing::~Listing() {
+    try {
+        flush();
+    } catch (...) {
+        // the index is rebuilt when it is missing
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    ListingMap::iterator it = registry().find(dir.string());
+    if (it != registry().end() && it->second.expired()) {
+        registry().erase(it);
+    }
+}
+
+
+void Directory::Listing::load() {
+    if (loaded) {
+        return;
+    }
+
+    names.clear();
+    has_links = false;
+    checked = removals;
+    if (bfs::exists(dir)) {
+        for (bfs::directory_iterator it(dir), end; it != end; ++it) {
+            if (bfs::is_directory(it->path())) {
+                names.push_back(it->path().filename().string());
+                has_links = has_links || bfs::is_symlink(it->path());
+            }
+        }
+    }
+    std::sort(names.begin(), names.end());
+    loaded = true;
+
+    if (!ids_loaded) {
+        return;
+    }
+
+    // keep the id index in line with the new listing
+    std::map<std::string, std::string>::iterator it = id_of.begin();
+    while (it != id_of.end()) {
+        if (std::binary_search(names.begin(), names.end(), it->first)) {
+            ++it;
+        } else {
+            ids.erase(it->second);
+            it = id_of.erase(it);
+            dirty = true;
+        }
+    }
+    for (const std::string &name : names) {
+        if (id_of.find(name) == id_of.end()) {
+            pending.insert(name);
+        }
+    }
+}
+
+
+void Directory::Listing::clear() {
+    loaded = ids_loaded = dirty = false;
+    names.clear();
+    pending.clear();
+    ids.clear();
+    id_of.clear();
+}
+
+
+void Directory::Listing::added(const std::string &name) {
+    std::vector<std::string>::iterator it = std::lower_bound(names.begin(), names.end(), name);
+    if (it == names.end() || *it != name) {
+        names.insert(it, name);
+    }
+    has_links = has_links || bfs::is_symlink(dir / bfs::path(name));
+    // might be a different entity than before
+    forget(name);
+    if (ids_loaded) {
+        pending.insert(name);
+    }
+}
+
+
+void Directory::Listing::removed(const std::string &name) {
+    std::vector<std::string>::iterator it = std::lower_bound(names.begin(), names.end(), name);
+    if (it != names.end() && *it == name) {
+        names.erase(it);
+    }
+    pending.erase(name);
+    forget(name);
+}
+
+
+void Directory::Listing::forget(const std::string &name) {
+    std::map<std::string, std::string>::iterator it = id_of.find(name);
+    if (it != id_of.end()) {
+        ids.erase(it->second);
+        id_of.erase(it);
+        dirty = true;
+    }
+}
+
+
+void Directory::Listing::loadIds() {
+    if (ids_loaded) {
+        return;
+    }
+
+    bfs::path index = dir / bfs::path(INDEX_FILE);
+    if (bfs::exists(index)) {
+        YAML::Node node = YAML::LoadFile(index.string());
+        for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+            std::string id = it->first.as<std::string>();
+            std::string name = it->second.as<std::string>();
+            if (std::binary_search(names.begin(), names.end(), name)) {
+                ids[id] = name;
+                id_of[name] = id;
+            } else {
+                dirty = true;
+            }
+        }
+    }
+
+    for (const std::string &name : names) {
+        if (id_of.find(name) == id_of.end()) {
+            pending.insert(name);
+        }
+    }
+    ids_loaded = true;
+}
+
+
+void Directory::Listing::reindex() {
+    ids.clear();
+    id_of.clear();
+    pending.clear();
+    pending.insert(names.begin(), names.end());
+    ids_loaded = true;
+    dirty = true;
+}
+
+
+void Directory::Listing::resolvePending() {
+    for (const std::string &name : pending) {
+        bfs::path p = dir / bfs::path(name);
+        if (!bfs::exists(p / bfs::path("attributes"))) {
+            continue;
+        }
+        AttributesFS attr(p);
+        if (attr.has("entity_id")) {
+            std::string id;
+            attr.get("entity_id", id);
+            ids[id] = name;
+            id_of[name] = id;
+            dirty = true;
+        }
+    }
+    pending.clear();
+}
+
+
+void Directory::Listing::flush() {
+    if (!dirty || !writable || !bfs::exists(dir)) {
+        return;
+    }
+
+    YAML::Emitter out;
+    out << YAML::BeginMap;
+    for (const auto &entry : ids) {
+        out << YAML::Key << entry.first << YAML::Value << entry.second;
+    }
+    out << YAML::EndMap;
+
+    bfs::path index = dir / bfs::path(INDEX_FILE);
+    AttributesFS::replaceFile(index, std::string(out.c_str()) + "\n");
+    dirty = false;
+}
+
+
 Directory::Directory(const bfs::path &location, FileMode mode)
     : loc(location), mode(mode) {
     open_or_create();
@@ -24,7 +269,13 @@ Directory::Directory(const std::string &location, FileMode mode): Directory(bfs:
 void Directory::open_or_create() {
     if (!exists(loc)) {
         if (mode > FileMode::ReadOnly) {
+            // only the parent of the topmost new directory changes
+            bfs::path created = loc;
+            while (created.has_parent_path() && !bfs::exists(created.parent_path())) {
+                created = created.parent_path();
+            }
             create_directories(loc);
+            invalidate(created);
         } else {
             throw std::logic_error("Trying to create new directory in ReadOnly mode!");
         }
@@ -32,6 +283,90 @@ void Directory::open_or_create() {
 }
 
 
+Directory::Listing &Directory::entries() const {
+    if (!listing) {
+        const std::string key = dir_key(loc);
+
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        std::weak_ptr<void> &entry = registry()[key];
+        listing = std::static_pointer_cast<Listing>(entry.lock());
+        if (!listing) {
+            listing = std::make_shared<Listing>();
+            listing->dir = bfs::path(key);
+            entry = listing;
+        }
+    }
+
+    if (mode > FileMode::ReadOnly) {
+        listing->writable = true;
+    }
+    if (listing->has_links && listing->checked != removals) {
+        listing->loaded = false;
+    }
+    listing->load();
+    return *listing;
+}
+
+
+void Directory::invalidate(const bfs::path &entry) {
+    const std::string parent = dir_key(entry.parent_path());
+    const std::string name = entry.filename().string();
+    const std::string key = parent + bfs::path::preferred_separator + name;
+    const bool is_dir = bfs::is_directory(entry);
+    if (!is_dir) {
+        removals++;
+    }
+
+    // released after the lock, their destructors take it again
+    std::vector<std::shared_ptr<Listing>> touched;
+
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    ListingMap::iterator it = registry().find(parent);
+    if (it != registry().end()) {
+        touched.push_back(std::static_pointer_cast<Listing>(it->second.lock()));
+        if (touched.back() && touched.back()->loaded) {
+            if (is_dir) {
+                touched.back()->added(name);
+            } else {
+                touched.back()->removed(name);
+            }
+        }
+    }
+
+    // the entry and everything below it is new or gone
+    for (it = registry().lower_bound(key); it != registry().end() && it->first.compare(0, key.size(), key) == 0; ++it) {
+        if (is_below(it->first, key)) {
+            touched.push_back(std::static_pointer_cast<Listing>(it->second.lock()));
+            if (touched.back()) {
+                touched.back()->clear();
+            }
+        }
+    }
+}
+
+
+void Directory::flushAll(const bfs::path &location) {
+    const std::string prefix = dir_key(location);
+    std::vector<std::shared_ptr<Listing>> listings;
+
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (ListingMap::iterator it = registry().lower_bound(prefix);
+             it != registry().end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+            if (is_below(it->first, prefix)) {
+                listings.push_back(std::static_pointer_cast<Listing>(it->second.lock()));
+            }
+        }
+    }
+
+    for (const std::shared_ptr<Listing> &l : listings) {
+        if (l) {
+            l->flush();
+        }
+    }
+}
+
+
 std::string Directory::location() const {
     return loc.string();
 }
@@ -43,33 +378,28 @@ FileMode Directory::fileMode() const {
 
 
 ndsize_t Directory::subdirCount() const {
-    ndsize_t count = 0;
-    bfs::directory_iterator end;
-    bfs::directory_iterator di(location().c_str());
-    while (di != end) {
-        if (bfs::is_directory(*di))
-            count ++;
-        ++di;
-    }
-    return count;
+    return entries().names.size();
 }
 
 
 void Directory::removeAll() {
     bfs::path p(location());
-    for (bfs::directory_iterator end_it, it(p); it!=end_it; ++it) {
-        bfs::remove_all(it->path());
+    AttributesFS::invalidate(p);
+
+    std::vector<bfs::path> children;
+    std::copy(bfs::directory_iterator(p), bfs::directory_iterator(), std::back_inserter(children));
+    for (const bfs::path &child : children) {
+        bfs::remove_all(child);
+        invalidate(child);
     }
 }
 
 
 boost::filesystem::path Directory::sub_dir_by_index(ndsize_t index) const {
     bfs::path p;
-    std::vector<bfs::path> paths;
-    copy(bfs::directory_iterator(loc), bfs::directory_iterator(), back_inserter(paths));
-    std::sort(paths.begin(), paths.end());
-    if (index < paths.size())
-        p = paths[index];
+    const Listing &l = entries();
+    if (index < l.names.size())
+        p = loc / bfs::path(l.names[index]);
     return p;
 }
 
@@ -80,12 +410,43 @@ boost::optional<bfs::path> Directory::findByNameOrAttribute(const std::string &a
         p = location() / bfs::path(value.c_str());
         return p;
     }
+
+    Listing &l = entries();
     bfs::path attr_path("attributes");
-    bfs::directory_iterator end;
-    bfs::directory_iterator di(location().c_str());
-    while (di != end) {
-        bfs::path temp = *di;
-        if (bfs::is_directory(temp) && exists(temp / attr_path)){
+
+    if (attribute == "entity_id") {
+        l.loadIds();
+        l.resolvePending();
+
+        std::map<std::string, std::string>::const_iterator it = l.ids.find(value);
+        if (it == l.ids.end()) {
+            return p;
+        }
+
+        // the stored index is stale if the file was changed by other means
+        bfs::path temp = loc / bfs::path(it->second);
+        std::string s;
+        if (exists(temp / attr_path)) {
+            AttributesFS attr(temp);
+            attr.get(attribute, s);
+        }
+        if (s != value) {
+            l.reindex();
+            l.resolvePending();
+            it = l.ids.find(value);
+            if (it == l.ids.end()) {
+                return p;
+            }
+            temp = loc / bfs::path(it->second);
+        }
+
+        p = temp;
+        return p;
+    }
+
+    for (const std::string &name : l.names) {
+        bfs::path temp = loc / bfs::path(name);
+        if (exists(temp / attr_path)){
             AttributesFS attr(temp);
             std::string s;
             if (attr.has(attribute)) {
@@ -96,22 +457,14 @@ boost::optional<bfs::path> Directory::findByNameOrAttribute(const std::string &a
                 }
             }
         }
-        ++di;
     }
     return p;
 }
 
 
 bool Directory::hasObject(const std::string &name) const {
-    bfs::directory_iterator end;
-    bfs::directory_iterator di(location().c_str());
-    while (di != end) {
-        bfs::path temp = *di;
-        if (bfs::is_directory(temp) && temp.filename().string() == name)
-            return true;
-        ++di;
-    }
-    return false;
+    const Listing &l = entries();
+    return std::binary_search(l.names.begin(), l.names.end(), name);
 }
 
 bool Directory::removeObjectByNameOrAttribute(const std::string &attribute, const std::string &name_or_id) const {
@@ -125,10 +478,13 @@ bool Directory::removeObjectByNameOrAttribute(const std::string &attribute, cons
                 attr.get("links", links);
                 for (auto &l :links) {
                     bfs::remove_all(bfs::path(l));
+                    invalidate(bfs::path(l));
                 }
             }
         }
+        AttributesFS::invalidate(*p);
         uintmax_t ret = bfs::remove_all(*p);
+        invalidate(*p);
         return ret > 0;
     }
     return false;
@@ -136,8 +492,9 @@ bool Directory::removeObjectByNameOrAttribute(const std::string &attribute, cons
 
 
 void Directory::createDirectoryLink(const std::string &target, const std::string &name) {
-    if (boost::filesystem::exists({target})) {
+    if (boost::filesystem::exists(target)) {
         boost::filesystem::create_directory_symlink(boost::filesystem::path(target), loc / boost::filesystem::path(name));
+        invalidate(loc / boost::filesystem::path(name));
     } else {
         throw std::runtime_error("Directory::createLink: target does not exist");
     }
@@ -147,7 +504,12 @@ void Directory::createDirectoryLink(const std::string &target, const std::string
 void Directory::renameSubdir(const std::string &old_name, const std::string &new_name) {
     bfs::path o(bfs::path(location()) / bfs::path(old_name)), n(bfs::path(location()) / bfs::path(new_name));
     if (hasObject(old_name) && ! hasObject(new_name)) {
+        AttributesFS::flushAll(o);
+        AttributesFS::invalidate(o);
+        flushAll(o);
         rename(o, n);
+        invalidate(o);
+        invalidate(n);
     }
 }
 
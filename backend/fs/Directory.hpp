@@ -13,20 +13,38 @@
 #include "AttributesFS.hpp"
 #include <nix/File.hpp>
 
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace nix {
 namespace file {
 
+/**
+ * A directory that holds the sub directories of entities.
+ *
+ * The sorted list of sub directories and an index from entity id to sub
+ * directory are kept in memory and shared by all Directory objects for
+ * the same location. They are read once and then updated in place when
+ * sub directories are created or removed in this process, through the
+ * methods of this class or by calling invalidate(). The id index is also
+ * stored in the file ".entity_ids" in the directory, so that reopening a
+ * file does not need to read the attributes of all entities; it is written
+ * like the attributes, see AttributesFS.
+ */
 class Directory {
 
 private:
+    struct Listing;
+
     boost::filesystem::path loc;
     FileMode mode;
+    mutable std::shared_ptr<Listing> listing;
 
     void open_or_create();
 
+    Listing &entries() const;
+
 public:
     Directory () {};
 
@@ -55,6 +73,17 @@ public:
     bool isValid() const;
 
     virtual void removeAll();
+
+    /**
+     * Update the cached listings after entry was created, removed or
+     * replaced by other means than the methods of this class.
+     */
+    static void invalidate(const boost::filesystem::path &entry);
+
+    /**
+     * Write the id indices of all directories in or below location.
+     */
+    static void flushAll(const boost::filesystem::path &location);
 };
 
 }
@@ -61,6 +61,7 @@ void DirectoryWithAttributes::createLink(const bfs::path &linker) {
         getAttr("links", links);
     }
     bfs::create_directory_symlink(bfs::path(location()), linker);
+    Directory::invalidate(linker);
     links.push_back(linker.string());
     setAttr("links", links);
 }
@@ -59,7 +59,11 @@ void EntityFS::setUpdatedAt() {
 
 
 void EntityFS::forceUpdatedAt() {
-    time_t t = util::getTime();
+    forceUpdatedAt(util::getTime());
+}
+
+
+void EntityFS::forceUpdatedAt(time_t t) {
     setAttr("updated_at", util::timeToStr(t));
 }
 
@@ -83,6 +87,13 @@ void EntityFS::forceCreatedAt(time_t t) {
     setAttr("created_at", util::timeToStr(t));
 }
 
+
+void EntityFS::forceId(const std::string &id) {
+    setAttr("entity_id", id);
+    // the id index of the parent directory is out of date
+    Directory::invalidate(location());
+}
+
 /*
 string EntityFS::location() const {
     return location();
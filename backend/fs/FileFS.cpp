@@ -190,7 +190,11 @@ void FileFS::setUpdatedAt(){
 
 
 void FileFS::forceUpdatedAt() {
-    time_t t = time(NULL);
+    forceUpdatedAt(time(NULL));
+}
+
+
+void FileFS::forceUpdatedAt(time_t t) {
     setAttr("updated_at", util::timeToStr(t));
 }
 
@@ -208,7 +212,16 @@ void FileFS::forceCreatedAt(time_t t) {
 }
 
 
-void FileFS::close() {} // FIXME not needed?
+bool FileFS::flush() {
+    AttributesFS::flushAll(location());
+    Directory::flushAll(location());
+    return true;
+}
+
+
+void FileFS::close() {
+    flush();
+}
 
 bool FileFS::isOpen() const { //FIXME not needed?
     return true;
@@ -32,7 +32,7 @@ public:
     FileFS(const std::string &name, const FileMode mode = FileMode::ReadWrite, const Compression compression = Compression::Auto);
 
 
-    bool flush() { return true; };
+    bool flush();
 
 
     ndsize_t blockCount() const;
@@ -99,6 +99,9 @@ public:
     void forceUpdatedAt();
 
 
+    void forceUpdatedAt(time_t t);
+
+
     void setCreatedAt();
 
 
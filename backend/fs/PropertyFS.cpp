@@ -66,7 +66,11 @@ void PropertyFS::setUpdatedAt() {
 
 
 void PropertyFS::forceUpdatedAt() {
-    time_t t = util::getTime();
+    forceUpdatedAt(util::getTime());
+}
+
+
+void PropertyFS::forceUpdatedAt(time_t t) {
     setAttr("updated_at", util::timeToStr(t));
 }
 
@@ -91,6 +95,13 @@ void PropertyFS::forceCreatedAt(time_t t) {
 }
 
 
+void PropertyFS::forceId(const std::string &id) {
+    setAttr("entity_id", id);
+    // the id index of the parent directory is out of date
+    Directory::invalidate(location());
+}
+
+
 std::string PropertyFS::name() const {
     std::string name;
     if (hasAttr("name")) {
@@ -220,6 +231,16 @@ void PropertyFS::values(const nix::none_t t) {
 }
 
 
+void PropertyFS::readValues(DataType dtype, void *data, ndsize_t count) const {
+    // FIXME
+}
+
+
+void PropertyFS::writeValues(DataType dtype, const void *data, ndsize_t count) {
+    // FIXME
+}
+
+
 bool PropertyFS::isValidEntity() const {
     return isValid();
 }
@@ -49,12 +49,18 @@ public:
     void forceUpdatedAt();
 
 
+    void forceUpdatedAt(time_t t);
+
+
     void setCreatedAt();
 
 
     void forceCreatedAt(time_t t);
 
 
+    void forceId(const std::string &id);
+
+
     std::string name() const;
 
 
@@ -103,6 +109,12 @@ public:
     void values(const boost::none_t t);
 
 
+    void readValues(DataType dtype, void *data, ndsize_t count) const;
+
+
+    void writeValues(DataType dtype, const void *data, ndsize_t count);
+
+
     bool isValidEntity() const;
 
 
@@ -123,7 +123,7 @@ void SectionFS::link(const std::string &id) {
 std::shared_ptr<base::ISection> SectionFS::link() const {
     std::shared_ptr<base::ISection> sec;
 
-    if (bfs::exists({location() + "/link"})) {
+    if (bfs::exists(location() + "/link")) {
         auto sec_tmp = std::make_shared<SectionFS>(file(), location() + "/link");
         // re-get above section "sec_tmp": parent missing, findSections will set it!
         auto found = File(file()).findSections(util::IdFilter<Section>(sec_tmp->id()));
@@ -136,8 +136,9 @@ std::shared_ptr<base::ISection> SectionFS::link() const {
 
 
 void SectionFS::link(const none_t t) {
-    if (bfs::exists({location() + "/link"})) {
+    if (bfs::exists(location() + "/link")) {
         bfs::remove_all({location() + "/link"});
+        Directory::invalidate({location() + "/link"});
     }
     forceUpdatedAt();
 }
@@ -12,6 +12,7 @@
 #include "DataArrayHDF5.hpp"
 #include "BlockHDF5.hpp"
 #include "FeatureHDF5.hpp"
+#include "FileHDF5.hpp"
 
 using namespace nix::base;
 
@@ -65,7 +66,9 @@ std::shared_ptr<IDataArray>  BaseTagHDF5::getReference(const std::string &name_o
     std::string id = block()->resolveEntityId({name_or_id, ObjectType::DataArray});
     if (g && hasReference(id)) {
         H5Group group = g->openGroup(id);
-        da = std::make_shared<DataArrayHDF5>(file(), block(), group);
+        da = std::dynamic_pointer_cast<FileHDF5>(file())->entity<IDataArray>(group, [this, &group] {
+            return std::make_shared<DataArrayHDF5>(file(), block(), group);
+        });
     }
 
     return da;
@@ -16,6 +16,7 @@
 #include "TagHDF5.hpp"
 #include "MultiTagHDF5.hpp"
 #include "GroupHDF5.hpp"
+#include "FileHDF5.hpp"
 
 #include <boost/range/irange.hpp>
 
@@ -153,57 +154,25 @@ bool BlockHDF5::hasEntity(const nix::Identity &ident) const {
     return !!p;
 }
 
-std::shared_ptr<base::IEntity> BlockHDF5::getEntity(const nix::Identity &ident) const {
-    boost::optional<H5Group> eg = findEntityGroup(ident);
-
-    switch (ident.type()) {
-    case ObjectType::DataArray: {
-        shared_ptr<DataArrayHDF5> da;
-        if (eg) {
-            da = make_shared<DataArrayHDF5>(file(), block(), *eg);
-        }
-        return da;
-    }
+std::shared_ptr<base::IEntity> BlockHDF5::makeEntity(ObjectType type, const H5Group &group) const {
+    switch (type) {
+    case ObjectType::DataArray:
+        return make_shared<DataArrayHDF5>(file(), block(), group);
 
-    case ObjectType::DataFrame: {
-        shared_ptr<DataFrameHDF5> df;
-        if (eg) {
-            df = make_shared<DataFrameHDF5>(file(), block(), *eg);
-        }
-        return df;
-    }
+    case ObjectType::DataFrame:
+        return make_shared<DataFrameHDF5>(file(), block(), group);
 
-    case ObjectType::Tag: {
-        shared_ptr<TagHDF5> tag;
-        if (eg) {
-            tag = make_shared<TagHDF5>(file(), block(), *eg);
-        }
-        return tag;
-    }
+    case ObjectType::Tag:
+        return make_shared<TagHDF5>(file(), block(), group);
 
-    case ObjectType::MultiTag: {
-        shared_ptr<MultiTagHDF5> tag;
-        if (eg) {
-            tag = make_shared<MultiTagHDF5>(file(), block(), *eg);
-        }
-        return tag;
-    }
+    case ObjectType::MultiTag:
+        return make_shared<MultiTagHDF5>(file(), block(), group);
 
-    case ObjectType::Group: {
-        shared_ptr<GroupHDF5> groups;
-        if (eg) {
-            groups = make_shared<GroupHDF5>(file(), block(), *eg);
-        }
-        return groups;
-    }
+    case ObjectType::Group:
+        return make_shared<GroupHDF5>(file(), block(), group);
 
-    case ObjectType::Source: {
-        shared_ptr<SourceHDF5> source;
-        if (eg) {
-           source = make_shared<SourceHDF5>(file(), block(), *eg);
-        }
-        return source;
-    }
+    case ObjectType::Source:
+        return make_shared<SourceHDF5>(file(), block(), group);
 
     default:
         return std::shared_ptr<base::IEntity>();
@@ -212,6 +181,18 @@ std::shared_ptr<base::IEntity> BlockHDF5::getEntity(const nix::Identity &ident)
     return std::shared_ptr<base::IEntity>();
 }
 
+std::shared_ptr<base::IEntity> BlockHDF5::getEntity(const nix::Identity &ident) const {
+    boost::optional<H5Group> eg = findEntityGroup(ident);
+
+    if (!eg) {
+        return std::shared_ptr<base::IEntity>();
+    }
+
+    return dynamic_pointer_cast<FileHDF5>(file())->entity<base::IEntity>(*eg, [this, &ident, &eg] {
+        return makeEntity(ident.type(), *eg);
+    });
+}
+
 std::shared_ptr<base::IEntity>BlockHDF5::getEntity(ObjectType type, ndsize_t index) const {
     boost::optional<H5Group> eg = groupForObjectType(type);
     string name = eg ? eg->objectName(index) : "";
@@ -223,6 +204,60 @@ ndsize_t BlockHDF5::entityCount(ObjectType type) const {
     return g ? g->objectCount() : ndsize_t(0);
 }
 
+bool BlockHDF5::matchEntity(const H5Group &group, const std::string &name, const util::Criterion &criterion) const {
+    typedef util::Criterion::Field Field;
+    std::string value;
+
+    switch (criterion.field) {
+    case Field::Name:
+        return criterion.match(name);
+
+    case Field::Id:
+        return group.getAttr("entity_id", value) && criterion.match(value);
+
+    case Field::Type:
+        return group.getAttr("type", value) && criterion.match(value);
+
+    case Field::Metadata:
+        if (!group.hasGroup("metadata")) {
+            return false;
+        }
+        return group.openGroup("metadata", false).getAttr("entity_id", value) && criterion.match(value);
+
+    case Field::Source:
+        // source links are named by the id of the source
+        return group.hasGroup("sources") && group.openGroup("sources", false).hasGroup(*criterion.value);
+    }
+
+    return false;
+}
+
+bool BlockHDF5::findEntities(ObjectType type, const util::Criterion &criterion,
+                             std::vector<std::shared_ptr<base::IEntity>> &entities) const {
+    boost::optional<H5Group> p = groupForObjectType(type);
+    if (!p) {
+        return true;
+    }
+
+    // entities are stored by name, so no need to look at any other object
+    if (criterion.field == util::Criterion::Field::Name && criterion.value) {
+        const std::string &name = *criterion.value;
+        if (p->hasGroup(name)) {
+            entities.push_back(makeEntity(type, p->openGroup(name, false)));
+        }
+        return true;
+    }
+
+    for (const std::string &name : p->objectNames()) {
+        H5Group g = p->openGroup(name, false);
+        if (matchEntity(g, name, criterion)) {
+            entities.push_back(makeEntity(type, g));
+        }
+    }
+
+    return true;
+}
+
 bool BlockHDF5::removeEntity(const nix::Identity &ident) {
     boost::optional<H5Group> p = groupForObjectType(ident.type());
     boost::optional<H5Group> eg = findEntityGroup(ident);
@@ -258,7 +293,9 @@ shared_ptr<ISource> BlockHDF5::createSource(const string &name, const string &ty
     boost::optional<H5Group> g = source_group(true);
 
     H5Group group = g->openGroup(name, true);
-    return make_shared<SourceHDF5>(file(), block(), group, id, type, name);
+    auto source = make_shared<SourceHDF5>(file(), block(), group, id, type, name);
+    dynamic_pointer_cast<FileHDF5>(file())->addEntity(group, source);
+    return source;
 }
 
 
@@ -296,7 +333,9 @@ shared_ptr<ITag> BlockHDF5::createTag(const std::string &name, const std::string
     boost::optional<H5Group> g = tag_group(true);
 
     H5Group group = g->openGroup(name);
-    return make_shared<TagHDF5>(file(), block(), group, id, type, name, position);
+    auto tag = make_shared<TagHDF5>(file(), block(), group, id, type, name, position);
+    dynamic_pointer_cast<FileHDF5>(file())->addEntity(group, tag);
+    return tag;
 }
 
 //--------------------------------------------------
@@ -317,6 +356,7 @@ shared_ptr<IDataArray> BlockHDF5::createDataArray(const std::string &name,
 
     // now create the actual H5::DataSet
     da->createData(data_type, shape, compression == Compression::Auto ? compr : compression);
+    dynamic_pointer_cast<FileHDF5>(file())->addEntity(group, da);
     return da;
 }
 
@@ -327,14 +367,16 @@ shared_ptr<IDataArray> BlockHDF5::createDataArray(const std::string &name,
 std::shared_ptr<IDataFrame> BlockHDF5::createDataFrame(const std::string &name,
                                                        const std::string &type,
                                                        const std::vector<Column> &cols,
-                                                       const Compression &compression) {
+                                                       const Compression &compression,
+                                                       DataFrameLayout layout) {
 
     string id = util::createId();
     boost::optional<H5Group> g = data_frame_group(true);
     H5Group group = g->openGroup(name, true);
 
     auto df = make_shared<DataFrameHDF5>(file(), block(), group, id, type, name);
-    df->createData(cols, compression == Compression::Auto ? compr : compression);
+    df->createData(cols, compression == Compression::Auto ? compr : compression, layout);
+    dynamic_pointer_cast<FileHDF5>(file())->addEntity(group, df);
     return df;
 }
 
@@ -349,7 +391,9 @@ shared_ptr<IMultiTag> BlockHDF5::createMultiTag(const std::string &name, const s
     boost::optional<H5Group> g = multi_tag_group(true);
 
     H5Group group = g->openGroup(name);
-    return make_shared<MultiTagHDF5>(file(), block(), group, id, type, name, positions);
+    auto tag = make_shared<MultiTagHDF5>(file(), block(), group, id, type, name, positions);
+    dynamic_pointer_cast<FileHDF5>(file())->addEntity(group, tag);
+    return tag;
 }
 
 //--------------------------------------------------
@@ -361,7 +405,9 @@ shared_ptr<IGroup> BlockHDF5::createGroup(const std::string &name, const std::st
     boost::optional<H5Group> g = groups_group(true);
 
     H5Group group = g->openGroup(name);
-    return make_shared<GroupHDF5>(file(), block(), group, id, type, name);
+    auto grp = make_shared<GroupHDF5>(file(), block(), group, id, type, name);
+    dynamic_pointer_cast<FileHDF5>(file())->addEntity(group, grp);
+    return grp;
 }
 
 
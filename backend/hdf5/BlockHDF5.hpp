@@ -71,6 +71,10 @@ private:
 
     boost::optional<H5Group> findEntityGroup(const nix::Identity &ident) const;
 
+    std::shared_ptr<base::IEntity> makeEntity(ObjectType type, const H5Group &group) const;
+
+    bool matchEntity(const H5Group &group, const std::string &name, const util::Criterion &criterion) const;
+
 public:
     //--------------------------------------------------
     // Generic entity methods
@@ -87,6 +91,9 @@ public:
 
     bool removeEntity(const nix::Identity &ident);
 
+    bool findEntities(ObjectType type, const util::Criterion &criterion,
+                      std::vector<std::shared_ptr<base::IEntity>> &entities) const;
+
 
     //--------------------------------------------------
     // Methods concerning sources
@@ -124,7 +131,8 @@ public:
     std::shared_ptr<base::IDataFrame> createDataFrame(const std::string &name,
                                                       const std::string &type,
                                                       const std::vector<Column> &cols,
-                                                      const Compression &compression);
+                                                      const Compression &compression,
+                                                      DataFrameLayout layout);
 
     //--------------------------------------------------
     // Methods concerning tags.
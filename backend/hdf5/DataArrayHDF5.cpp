@@ -10,14 +10,29 @@
 
 #include "DataArrayHDF5.hpp"
 #include "h5x/H5DataSet.hpp"
+#include "FileHDF5.hpp"
 #include "DimensionHDF5.hpp"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 using namespace nix::base;
 
 namespace nix {
 namespace hdf5 {
 
+namespace {
+
+// looked up on every data access, so the names are not built each time
+const std::string EXPANSION_ORIGIN("expansion_origin");
+const std::string POLYNOM_COEFFICIENTS("polynom_coefficients");
+
+}
+
 
 DataArrayHDF5::DataArrayHDF5(const std::shared_ptr<base::IFile> &file, const std::shared_ptr<base::IBlock> &block, const H5Group &group)
         : EntityWithSourcesHDF5(file, block, group) {
@@ -97,7 +112,7 @@ void DataArrayHDF5::unit(const none_t t) {
 boost::optional<double> DataArrayHDF5::expansionOrigin() const {
     boost::optional<double> ret;
     double expansion_origin;
-    bool have_attr = group().getAttr("expansion_origin", expansion_origin);
+    bool have_attr = group().getAttr(EXPANSION_ORIGIN, expansion_origin);
     if (have_attr) {
         ret = expansion_origin;
     }
@@ -106,14 +121,14 @@ boost::optional<double> DataArrayHDF5::expansionOrigin() const {
 
 
 void DataArrayHDF5::expansionOrigin(double expansion_origin) {
-    group().setAttr("expansion_origin", expansion_origin);
+    group().setAttr(EXPANSION_ORIGIN, expansion_origin);
     forceUpdatedAt();
 }
 
 
 void DataArrayHDF5::expansionOrigin(const none_t t) {
-    if (group().hasAttr("expansion_origin")) {
-        group().removeAttr("expansion_origin");
+    if (group().hasAttr(EXPANSION_ORIGIN)) {
+        group().removeAttr(EXPANSION_ORIGIN);
     }
     forceUpdatedAt();
 }
@@ -122,8 +137,8 @@ void DataArrayHDF5::expansionOrigin(const none_t t) {
 vector<double> DataArrayHDF5::polynomCoefficients() const {
     vector<double> polynom_coefficients;
 
-    if (group().hasData("polynom_coefficients")) {
-        DataSet ds = group().openData("polynom_coefficients");
+    if (group().hasData(POLYNOM_COEFFICIENTS)) {
+        DataSet ds = group().openData(POLYNOM_COEFFICIENTS);
         ds.read(polynom_coefficients, true);
     }
 
@@ -133,11 +148,11 @@ vector<double> DataArrayHDF5::polynomCoefficients() const {
 
 void DataArrayHDF5::polynomCoefficients(const vector<double> &coefficients, const Compression &compression) {
     DataSet ds;
-    if (group().hasData("polynom_coefficients")) {
-        ds = group().openData("polynom_coefficients");
+    if (group().hasData(POLYNOM_COEFFICIENTS)) {
+        ds = group().openData(POLYNOM_COEFFICIENTS);
         ds.setExtent({coefficients.size()});
     } else {
-        ds = group().createData("polynom_coefficients", H5T_NATIVE_DOUBLE, {coefficients.size()}, compression);
+        ds = group().createData(POLYNOM_COEFFICIENTS, H5T_NATIVE_DOUBLE, {coefficients.size()}, compression);
     }
     ds.write(coefficients);
     forceUpdatedAt();
@@ -145,8 +160,8 @@ void DataArrayHDF5::polynomCoefficients(const vector<double> &coefficients, cons
 
 
 void DataArrayHDF5::polynomCoefficients(const none_t t) {
-    if (group().hasData("polynom_coefficients")) {
-        group().removeData("polynom_coefficients");
+    if (group().hasData(POLYNOM_COEFFICIENTS)) {
+        group().removeData(POLYNOM_COEFFICIENTS);
     }
     forceUpdatedAt();
 }
@@ -258,6 +273,18 @@ bool DataArrayHDF5::hasData() const {
 
 void DataArrayHDF5::write(DataType dtype, const void *data, const NDSize &count, const NDSize &offset) {
 
+    if (read_ahead) {
+        read_ahead->clear();
+    }
+
+    if (write_buffer_size > 0 && !write_buffer && group().hasData("data")) {
+        write_buffer = std::make_shared<WriteBufferHDF5>(group().openData("data"), write_buffer_size);
+        dynamic_pointer_cast<FileHDF5>(file())->addWriteBuffer(write_buffer);
+    }
+    if (write_buffer && write_buffer->write(dtype, data, count, offset)) {
+        return;
+    }
+
     if (!group().hasData("data")) {
         throw ConsistencyError("DataArray with missing h5df DataSet");
     }
@@ -277,6 +304,21 @@ void DataArrayHDF5::write(DataType dtype, const void *data, const NDSize &count,
 }
 
 void DataArrayHDF5::read(DataType dtype, void *data, const NDSize &count, const NDSize &offset) const {
+    if (write_buffer && read_ahead_size > 0) {
+        // the read-ahead fetches beyond the requested region
+        write_buffer->flush();
+    } else if (write_buffer) {
+        write_buffer->flushOverlapping(count, offset);
+    }
+
+    if (read_ahead_size > 0 && !read_ahead && group().hasData("data")) {
+        read_ahead = std::make_shared<ReadAheadHDF5>(group().openData("data"), read_ahead_size);
+        dynamic_pointer_cast<FileHDF5>(file())->addReadAhead(read_ahead);
+    }
+    if (read_ahead && read_ahead->read(dtype, data, count, offset)) {
+        return;
+    }
+
     if (!group().hasData("data")) {
         throw ConsistencyError("DataArray with missing h5df DataSet");
     }
@@ -288,9 +330,7 @@ void DataArrayHDF5::read(DataType dtype, void *data, const NDSize &count, const
 
     if (dtype == DataType::String) {
         StringWriter writer(count, data);
-        ds.read(*writer, memType, memSpace, fileSpace);
-        writer.finish();
-        ds.vlenReclaim(memType.h5id(), *writer, &memSpace);
+        ds.read(writer, memType, memSpace, fileSpace);
     } else {
         ds.read(data, memType, memSpace, fileSpace);
     }
@@ -310,6 +350,13 @@ void DataArrayHDF5::dataExtent(const NDSize &extent) {
         throw runtime_error("Data field not found in DataArray!");
     }
 
+    if (write_buffer) {
+        write_buffer->extent(extent);
+    }
+    if (read_ahead) {
+        read_ahead->clear();
+    }
+
     DataSet ds = group().openData("data");
     ds.setExtent(extent);
 }
@@ -324,5 +371,92 @@ DataType DataArrayHDF5::dataType(void) const {
     return data_type_from_h5(dtype);
 }
 
+
+void DataArrayHDF5::writeBufferSize(size_t bytes) {
+    write_buffer_size = bytes;
+    if (write_buffer && bytes == 0) {
+        write_buffer->flush();
+        write_buffer.reset();
+    } else if (write_buffer) {
+        write_buffer->maxBytes(bytes);
+    }
+}
+
+
+size_t DataArrayHDF5::writeBufferSize() const {
+    return write_buffer_size;
+}
+
+
+void DataArrayHDF5::readAheadSize(size_t bytes) {
+    read_ahead_size = bytes;
+    if (read_ahead && bytes == 0) {
+        read_ahead.reset();
+    } else if (read_ahead) {
+        read_ahead->maxBytes(bytes);
+    }
+}
+
+
+size_t DataArrayHDF5::readAheadSize() const {
+    return read_ahead_size;
+}
+
+
+std::shared_ptr<const void> DataArrayHDF5::mapData(DataType dtype) const {
+#ifdef _WIN32
+    return std::shared_ptr<const void>();
+#else
+    if (dtype == DataType::String || !group().hasData("data")) {
+        return std::shared_ptr<const void>();
+    }
+
+    // the mapping shows the file, so all writes have to be in it
+    std::shared_ptr<FileHDF5> fh = dynamic_pointer_cast<FileHDF5>(file());
+    if (fh->fileMode() != FileMode::ReadOnly) {
+        fh->flush();
+    }
+
+    DataSet ds = group().openData("data");
+    const size_t nbytes = data_type_to_size(dtype) * ds.size().nelms();
+    h5x::DataType file_type = ds.dataType();
+    h5x::DataType mem_type = data_type_to_h5_memtype(dtype);
+    H5Object dcpl = H5Dget_create_plist(ds.h5id());
+    H5Object fapl = H5Fget_access_plist(fh->h5id());
+    H5Object fcpl = H5Fget_create_plist(fh->h5id());
+    hsize_t userblock = 0;
+
+    // only data in one piece, in the file itself and in the byte order
+    // and representation of the requested type can be mapped
+    const haddr_t addr = H5Dget_offset(ds.h5id());
+    if (nbytes == 0 || addr == HADDR_UNDEF ||
+        !dcpl.isValid() || H5Pget_layout(dcpl.h5id()) != H5D_CONTIGUOUS ||
+        !fapl.isValid() || H5Pget_driver(fapl.h5id()) != H5FD_SEC2 ||
+        !fcpl.isValid() || H5Pget_userblock(fcpl.h5id(), &userblock) < 0 || userblock != 0 ||
+        H5Tequal(file_type.h5id(), mem_type.h5id()) <= 0 ||
+        H5Dget_storage_size(ds.h5id()) < nbytes) {
+        return std::shared_ptr<const void>();
+    }
+
+    int fd = ::open(fh->location().c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::shared_ptr<const void>();
+    }
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t start = static_cast<size_t>(addr) / page * page;
+    const size_t length = nbytes + (static_cast<size_t>(addr) - start);
+    void *map = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(start));
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return std::shared_ptr<const void>();
+    }
+
+    std::shared_ptr<const void> mapping(map, [length](const void *p) {
+        ::munmap(const_cast<void *>(p), length);
+    });
+    return std::shared_ptr<const void>(mapping, static_cast<const char *>(map) + (addr - start));
+#endif
+}
+
 } // ns nix::hdf5
 } // ns nix
@@ -16,6 +16,8 @@
 
 #include <nix/base/IDataArray.hpp>
 #include "EntityWithSourcesHDF5.hpp"
+#include "WriteBufferHDF5.hpp"
+#include "ReadAheadHDF5.hpp"
 
 #include <boost/multi_array.hpp>
 
@@ -31,6 +33,10 @@ private:
     static const NDSize MAX_SIZE_1D;
 
     optGroup dimension_group;
+    size_t write_buffer_size = 0;
+    std::shared_ptr<WriteBufferHDF5> write_buffer;
+    size_t read_ahead_size = 0;
+    mutable std::shared_ptr<ReadAheadHDF5> read_ahead;
 
 public:
 
@@ -148,6 +154,21 @@ public:
 
     DataType dataType(void) const;
 
+
+    void writeBufferSize(size_t bytes);
+
+
+    size_t writeBufferSize() const;
+
+
+    void readAheadSize(size_t bytes);
+
+
+    size_t readAheadSize() const;
+
+
+    std::shared_ptr<const void> mapData(DataType dtype) const;
+
 private:
 
     // small helper for handling dimension groups
@@ -12,8 +12,10 @@
 #include <nix/Compression.hpp>
 
 #include "DataFrameHDF5.hpp"
+#include "FileHDF5.hpp"
 
 #include "h5x/H5DataSet.hpp"
+#include "h5x/H5Exception.hpp"
 
 #include <cstring>
 #include <numeric>
@@ -37,12 +39,33 @@ DataFrameHDF5::DataFrameHDF5(const std::shared_ptr<base::IFile> &file, const std
     : EntityWithSourcesHDF5(file, block, group, id, type, name, time) {
 }
 
-void DataFrameHDF5::createData(const std::vector<Column> &cols, const Compression &compression) {
+void DataFrameHDF5::createData(const std::vector<Column> &cols, const Compression &compression,
+                               DataFrameLayout layout) {
 
-    if (group().hasData("data")) {
+    if (group().hasData("data") || group().hasGroup("columns")) {
         throw ConsistencyError("DataFrame's hdf5 data group already exists!");
     }
 
+    if (layout == DataFrameLayout::Columns) {
+        H5Group g = group().openGroup("columns", true);
+        std::vector<std::string> names(cols.size());
+        std::vector<std::string> units(cols.size());
+
+        for (size_t i = 0; i < cols.size(); i++) {
+            g.createData(std::to_string(i), data_type_to_h5_filetype(cols[i].dtype), {0}, compression);
+            names[i] = cols[i].name;
+            units[i] = cols[i].unit;
+        }
+
+        g.setAttr("names", names);
+        g.setAttr("units", units);
+        frame_layout = layout;
+
+        // older versions of the library do not know the column layout
+        std::dynamic_pointer_cast<FileHDF5>(file())->addFeature(OpenFlags::ColumnFrames);
+        return;
+    }
+
     std::vector<size_t> offset(cols.size());
     std::vector<h5x::DataType> dtypes(cols.size());
 
@@ -69,7 +92,128 @@ void DataFrameHDF5::createData(const std::vector<Column> &cols, const Compressio
     ds.setAttr("units", units);
 }
 
+DataFrameLayout DataFrameHDF5::layout() const {
+    if (!frame_layout) {
+        frame_layout = group().hasGroup("columns") ? DataFrameLayout::Columns : DataFrameLayout::Rows;
+    }
+
+    return *frame_layout;
+}
+
+H5Group DataFrameHDF5::columnGroup() const {
+    if (!group().hasGroup("columns")) {
+        throw ConsistencyError("DataFrame's hdf5 columns group is missing!");
+    }
+
+    return group().openGroup("columns", false);
+}
+
+DataFrameHDF5::ColumnStore &DataFrameHDF5::columnStore() const {
+    if (!column_store) {
+        H5Group g = columnGroup();
+        auto store = std::make_shared<ColumnStore>();
+        g.getAttr("names", store->names);
+
+        for (size_t i = 0; i < store->names.size(); i++) {
+            store->data.push_back(g.openData(std::to_string(i)));
+            store->dtypes.push_back(data_type_from_h5(store->data[i].dataType()));
+        }
+
+        column_store = store;
+    }
+
+    return *column_store;
+}
+
+DataSet &DataFrameHDF5::columnData(unsigned col) const {
+    ColumnStore &store = columnStore();
+    if (col >= store.data.size()) {
+        throw H5Exception("DataFrameHDF5: column index out of range");
+    }
+
+    return store.data[col];
+}
+
+static unsigned column_index(const std::vector<std::string> &names, const std::string &name) {
+    auto it = std::find(names.cbegin(), names.cend(), name);
+    if (it == names.cend()) {
+        throw H5Exception("DataFrameHDF5: no column named " + name);
+    }
+
+    return static_cast<unsigned>(it - names.cbegin());
+}
+
+static const std::string &column_name(const std::vector<std::string> &names, unsigned col) {
+    if (col >= names.size()) {
+        throw H5Exception("DataFrameHDF5: column index out of range");
+    }
+
+    return names[col];
+}
+
+// read or write count values of a 1d dataset, memType selects the
+// values (a plain type or a single-member compound for the row layout)
+static void read_values(const DataSet &ds, const h5x::DataType &memType, DataType dtype,
+                        ndsize_t offset, ndsize_t count, void *data) {
+    NDSize ndcount = {count};
+    NDSize ndoffset = {offset};
+    DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces(ndcount, ndoffset);
+
+    if (dtype == DataType::String) {
+        StringWriter writer(ndcount, data);
+        ds.read(writer, memType, memSpace, fileSpace);
+    } else {
+        ds.read(data, memType, memSpace, fileSpace);
+    }
+}
+
+static void write_values(DataSet &ds, const h5x::DataType &memType, DataType dtype,
+                         ndsize_t offset, ndsize_t count, const void *data) {
+    NDSize ndcount = {count};
+    NDSize ndoffset = {offset};
+    DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces(ndcount, ndoffset);
+
+    if (dtype == DataType::String) {
+        StringReader reader(ndcount, data);
+        ds.write(*reader, memType, memSpace, fileSpace);
+    } else {
+        ds.write(data, memType, memSpace, fileSpace);
+    }
+}
+
+Variant DataFrameHDF5::readCell(unsigned col, ndsize_t row) const {
+    const DataSet &ds = columnData(col);
+    DataType dtype = columnStore().dtypes[col];
+    ColumnBuffer value("", dtype, 1);
+
+    read_values(ds, data_type_to_h5_memtype(dtype), dtype, row, 1, value.data());
+    return value.get(0);
+}
+
+void DataFrameHDF5::writeCell(unsigned col, ndsize_t row, const Variant &v) {
+    // written in the type of the value, HDF5 converts it to the column's type
+    ColumnBuffer value("", v.type(), 1);
+    value.set(0, v);
+
+    write_values(columnData(col), data_type_to_h5_memtype(v.type()), v.type(), row, 1, value.data());
+}
+
 std::vector<Column> DataFrameHDF5::columns() const {
+    if (columnar()) {
+        const ColumnStore &store = columnStore();
+        std::vector<Column> cols;
+        std::vector<std::string> units;
+        columnGroup().getAttr("units", units);
+
+        for (size_t i = 0; i < store.names.size(); i++) {
+            cols.push_back(Column{store.names[i], units[i], store.dtypes[i]});
+        }
+
+        return cols;
+    }
+
     DataSet ds = data();
     h5x::DataType dt = ds.dataType();
 
@@ -89,23 +233,39 @@ std::vector<Column> DataFrameHDF5::columns() const {
 }
 
 unsigned DataFrameHDF5::colIndex(const std::string &name) const {
+    if (columnar()) {
+        return column_index(columnNames(), name);
+    }
+
     DataSet ds = data();
     h5x::DataType dtype = ds.dataType();
     return dtype.member_index(name);
 }
 
 std::string DataFrameHDF5::colName(unsigned col) const {
+    if (columnar()) {
+        return column_name(columnNames(), col);
+    }
+
     DataSet ds = data();
     h5x::DataType dtype = ds.dataType();
     return dtype.member_name(col);
 }
 
 std::vector<unsigned> DataFrameHDF5::colIndex(const std::vector<std::string> &names) const {
+    std::vector<unsigned> cols(names.size());
+
+    if (columnar()) {
+        const std::vector<std::string> &all = columnNames();
+        for (size_t i = 0; i < names.size(); i++) {
+            cols[i] = column_index(all, names[i]);
+        }
+        return cols;
+    }
+
     DataSet ds = data();
     h5x::DataType dtype = ds.dataType();
 
-    std::vector<unsigned> cols(names.size());
-
     for (size_t i = 0; i < names.size(); i++) {
         cols[i] = dtype.member_index(names[i]);
     }
@@ -114,11 +274,19 @@ std::vector<unsigned> DataFrameHDF5::colIndex(const std::vector<std::string> &na
 }
 
 std::vector<std::string> DataFrameHDF5::colName(const std::vector<unsigned> &cols) const {
+    std::vector<std::string> names(cols.size());
+
+    if (columnar()) {
+        const std::vector<std::string> &all = columnNames();
+        for (size_t i = 0; i < cols.size(); i++) {
+            names[i] = column_name(all, cols[i]);
+        }
+        return names;
+    }
+
     DataSet ds = data();
     h5x::DataType dtype = ds.dataType();
 
-    std::vector<std::string> names(cols.size());
-
     for (size_t i = 0; i < cols.size(); i++) {
         names[i] = dtype.member_name(cols[i]);
     }
@@ -127,12 +295,24 @@ std::vector<std::string> DataFrameHDF5::colName(const std::vector<unsigned> &col
 }
 
 ndsize_t DataFrameHDF5::rows() const {
+    if (columnar()) {
+        const ColumnStore &store = columnStore();
+        return store.data.empty() ? 0 : store.data[0].size()[0];
+    }
+
     DataSet ds = data();
     NDSize s = ds.size();
     return s.size() > 0 ? s[0] : 0;
 }
 
 void DataFrameHDF5::rows(ndsize_t n) {
+    if (columnar()) {
+        for (DataSet &ds : columnStore().data) {
+            ds.setExtent({n});
+        }
+        return;
+    }
+
     DataSet ds = data();
     ds.setExtent({n});
 }
@@ -348,6 +528,14 @@ struct Janus {
 
 
 void DataFrameHDF5::writeCells(ndsize_t row, const std::vector<Cell> &cells) {
+    if (columnar()) {
+        const std::vector<std::string> &names = columnNames();
+        for (const Cell &c : cells) {
+            writeCell(c.haveName() ? column_index(names, c.name) : c.col, row, c);
+        }
+        return;
+    }
+
     DataSet ds = data();
     h5x::DataType dt = ds.dataType();
     Janus j{dt, cells};
@@ -356,6 +544,13 @@ void DataFrameHDF5::writeCells(ndsize_t row, const std::vector<Cell> &cells) {
 }
 
 void DataFrameHDF5::writeRow(ndsize_t row, const std::vector<Variant> &vals) {
+    if (columnar()) {
+        for (size_t i = 0; i < vals.size(); i++) {
+            writeCell(static_cast<unsigned>(i), row, vals[i]);
+        }
+        return;
+    }
+
     DataSet ds = data();
     h5x::DataType dt = ds.dataType();
     std::vector<Cell> cells;
@@ -373,6 +568,16 @@ void DataFrameHDF5::writeRow(ndsize_t row, const std::vector<Variant> &vals) {
 }
 
 std::vector<Cell> DataFrameHDF5::readCells(ndsize_t row, const std::vector<std::string> &cols) const {
+    if (columnar()) {
+        const std::vector<std::string> &names = columnNames();
+        std::vector<Cell> res;
+        for (size_t i = 0; i < cols.size(); i++) {
+            res.emplace_back(cols[i], readCell(column_index(names, cols[i]), row));
+            res[i].col = static_cast<int>(i);
+        }
+        return res;
+    }
+
     DataSet ds = data();
     h5x::DataType dtype = ds.dataType();
 
@@ -391,6 +596,14 @@ std::vector<Cell> DataFrameHDF5::readCells(ndsize_t row, const std::vector<std::
 }
 
 std::vector<Variant> DataFrameHDF5::readRow(ndsize_t row) const {
+    if (columnar()) {
+        std::vector<Variant> res(columnNames().size());
+        for (size_t i = 0; i < res.size(); i++) {
+            res[i] = readCell(static_cast<unsigned>(i), row);
+        }
+        return res;
+    }
+
     DataSet ds = data();
     h5x::DataType dts = ds.dataType();
 
@@ -423,25 +636,19 @@ void DataFrameHDF5::writeColumn(const std::string &name,
                                 ndsize_t count,
                                 DataType dtype,
                                 const void *data) {
-    DataSet ds = this->data();
-    h5x::DataType dts = ds.dataType();
     h5x::DataType memType = data_type_to_h5_memtype(dtype);
-    size_t ms = memType.size();
 
-    h5x::DataType ct = h5x::DataType::makeCompound(ms);
-    ct.insert(name, 0, memType);
+    if (columnar()) {
+        DataSet &ds = columnData(column_index(columnNames(), name));
+        write_values(ds, memType, dtype, offset, count, data);
+        return;
+    }
 
-    NDSize ndcount = {count};
-    NDSize ndoffset = {offset};
-    DataSpace fileSpace, memSpace;
-    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces(ndcount, ndoffset);
+    h5x::DataType ct = h5x::DataType::makeCompound(memType.size());
+    ct.insert(name, 0, memType);
 
-    if (dtype == DataType::String) {
-        StringReader reader(ndcount, data);
-        ds.write(*reader, ct, memSpace, fileSpace);
-    } else {
-        ds.write(data, ct, memSpace, fileSpace);
-    }
+    DataSet ds = this->data();
+    write_values(ds, ct, dtype, offset, count, data);
 }
 
 void DataFrameHDF5::readColumn(const std::string &name,
@@ -449,27 +656,209 @@ void DataFrameHDF5::readColumn(const std::string &name,
                                ndsize_t count,
                                DataType dtype,
                                void *data) const {
-    DataSet ds = this->data();
-    h5x::DataType dts = ds.dataType();
     h5x::DataType memType = data_type_to_h5_memtype(dtype);
 
-    size_t ms = memType.size();
-    h5x::DataType ct = h5x::DataType::makeCompound(ms);
+    if (columnar()) {
+        DataSet &ds = columnData(column_index(columnNames(), name));
+        read_values(ds, memType, dtype, offset, count, data);
+        return;
+    }
+
+    h5x::DataType ct = h5x::DataType::makeCompound(memType.size());
     ct.insert(name, 0, memType);
 
-    NDSize ndcount = {count};
-    NDSize ndoffset = {offset};
-    DataSpace fileSpace, memSpace;
-    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces(ndcount, ndoffset);
+    read_values(this->data(), ct, dtype, offset, count, data);
+}
 
-    if (dtype == DataType::String) {
-        StringWriter writer(ndcount, data);
-        ds.read(*writer, ct, memSpace, fileSpace);
-        writer.finish();
-        ds.vlenReclaim(memType.h5id(), *writer, &memSpace);
+static DataFrameHDF5::RowLayout make_row_layout(const std::vector<std::string> &names,
+                                                const std::vector<DataType> &dtypes) {
+    DataFrameHDF5::RowLayout layout;
+    std::vector<h5x::DataType> memtypes(names.size());
+
+    layout.names = names;
+    layout.dtypes = dtypes;
+    layout.offsets.resize(names.size());
+    layout.size = 0;
+
+    for (size_t i = 0; i < names.size(); i++) {
+        memtypes[i] = data_type_to_h5_memtype(dtypes[i]);
+        layout.offsets[i] = layout.size;
+        layout.size += memtypes[i].size();
+    }
+
+    layout.type = h5x::DataType::makeCompound(layout.size);
+    for (size_t i = 0; i < names.size(); i++) {
+        layout.type.insert(names[i], layout.offsets[i], memtypes[i]);
+    }
+
+    return layout;
+}
+
+const DataFrameHDF5::RowLayout &DataFrameHDF5::rowLayout(const DataSet &ds) const {
+    if (!row_layout) {
+        h5x::DataType dt = ds.dataType();
+        const unsigned n = dt.member_count();
+
+        std::vector<std::string> names(n);
+        std::vector<DataType> dtypes(n);
+        for (unsigned i = 0; i < n; i++) {
+            names[i] = dt.member_name(i);
+            dtypes[i] = data_type_from_h5(dt.member_type(i));
+        }
+
+        row_layout = std::make_shared<RowLayout>(make_row_layout(names, dtypes));
+    }
+
+    return *row_layout;
+}
+
+void DataFrameHDF5::readRows(ndsize_t offset, ndsize_t count, RowBatch &rows) const {
+    if (columnar()) {
+        const size_t n = nix::check::fits_in_size_t(count, "Cannot read rows: data too big for memory");
+
+        if (rows.columns.empty()) {
+            for (const Column &c : columns()) {
+                rows.columns.emplace_back(c.name, c.dtype, n);
+            }
+        } else {
+            rows.resize(n);
+        }
+
+        if (n == 0) {
+            return;
+        }
+
+        // one read per column, straight into the column buffers
+        const std::vector<std::string> &names = columnNames();
+        for (ColumnBuffer &col : rows.columns) {
+            DataSet &ds = columnData(column_index(names, col.name()));
+            read_values(ds, data_type_to_h5_memtype(col.dataType()), col.dataType(), offset, count, col.data());
+        }
+        return;
+    }
+
+    DataSet ds = data();
+    const RowLayout &full = rowLayout(ds);
+    const size_t n = nix::check::fits_in_size_t(count, "Cannot read rows: data too big for memory");
+
+    // an empty batch reads all columns, otherwise only the columns
+    // of the batch are read (projection), into their data types
+    RowLayout projected;
+    if (rows.columns.empty()) {
+        for (size_t c = 0; c < full.names.size(); c++) {
+            rows.columns.emplace_back(full.names[c], full.dtypes[c], n);
+        }
     } else {
-        ds.read(data, ct, memSpace, fileSpace);
+        std::vector<std::string> names(rows.columns.size());
+        std::vector<DataType> dtypes(rows.columns.size());
+        for (size_t c = 0; c < rows.columns.size(); c++) {
+            names[c] = rows.columns[c].name();
+            dtypes[c] = rows.columns[c].dataType();
+        }
+
+        if (names != full.names || dtypes != full.dtypes) {
+            projected = make_row_layout(names, dtypes);
+        }
+        rows.resize(n);
+    }
+    const RowLayout &layout = projected.names.empty() ? full : projected;
+
+    if (n == 0) {
+        return;
+    }
+
+    // read all rows with a single H5Dread, then scatter the
+    // members into the column buffers
+    std::vector<char> buffer(n * layout.size);
+    DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces({count}, {offset});
+    ds.read(buffer.data(), layout.type, memSpace, fileSpace);
+
+    bool have_strings = false;
+    for (size_t c = 0; c < layout.names.size(); c++) {
+        ColumnBuffer &col = rows.columns[c];
+        const char *src = buffer.data() + layout.offsets[c];
+
+        if (layout.dtypes[c] == DataType::String) {
+            std::string *dst = col.values<std::string>();
+            for (size_t i = 0; i < n; i++, src += layout.size) {
+                const char *str;
+                std::memcpy(&str, src, sizeof(str));
+                dst[i] = str ? str : "";
+            }
+            have_strings = true;
+        } else {
+            char *dst = static_cast<char *>(col.data());
+            const size_t es = data_type_to_size(layout.dtypes[c]);
+            for (size_t i = 0; i < n; i++, src += layout.size, dst += es) {
+                std::memcpy(dst, src, es);
+            }
+        }
+    }
+
+    if (have_strings) {
+        ds.vlenReclaim(layout.type, buffer.data(), &memSpace);
+    }
+}
+
+void DataFrameHDF5::writeRows(ndsize_t offset, const RowBatch &rows) {
+    const size_t n = rows.rows();
+    if (n == 0) {
+        return;
     }
+
+    if (columnar()) {
+        const std::vector<std::string> &names = columnNames();
+        for (const ColumnBuffer &col : rows.columns) {
+            DataSet &ds = columnData(column_index(names, col.name()));
+            write_values(ds, data_type_to_h5_memtype(col.dataType()), col.dataType(), offset, n, col.data());
+        }
+        return;
+    }
+
+    DataSet ds = data();
+    const RowLayout &full = rowLayout(ds);
+
+    std::vector<std::string> names(rows.columns.size());
+    std::vector<DataType> dtypes(rows.columns.size());
+    for (size_t c = 0; c < rows.columns.size(); c++) {
+        names[c] = rows.columns[c].name();
+        dtypes[c] = rows.columns[c].dataType();
+    }
+
+    // complete rows in file order use the cached layout, everything
+    // else gets a compound of just the given columns
+    RowLayout partial;
+    const bool is_full = names == full.names && dtypes == full.dtypes;
+    if (!is_full) {
+        partial = make_row_layout(names, dtypes);
+    }
+    const RowLayout &layout = is_full ? full : partial;
+
+    // gather the column buffers into rows
+    std::vector<char> buffer(n * layout.size);
+    for (size_t c = 0; c < layout.names.size(); c++) {
+        const ColumnBuffer &col = rows.columns[c];
+        char *dst = buffer.data() + layout.offsets[c];
+
+        if (layout.dtypes[c] == DataType::String) {
+            const std::string *src = col.values<std::string>();
+            for (size_t i = 0; i < n; i++, dst += layout.size) {
+                const char *str = src[i].c_str();
+                std::memcpy(dst, &str, sizeof(str));
+            }
+        } else {
+            const char *src = static_cast<const char *>(col.data());
+            const size_t es = data_type_to_size(layout.dtypes[c]);
+            for (size_t i = 0; i < n; i++, src += es, dst += layout.size) {
+                std::memcpy(dst, src, es);
+            }
+        }
+    }
+
+    DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces({static_cast<ndsize_t>(n)}, {offset});
+    ds.write(buffer.data(), layout.type, memSpace, fileSpace);
 }
 
 }
@@ -16,12 +16,50 @@
 #include <nix/base/IDataFrame.hpp>
 #include "EntityWithSourcesHDF5.hpp"
 
+#include <boost/optional.hpp>
+
 namespace nix {
 namespace hdf5 {
 
+/**
+ * The data of a DataFrame is either stored in a compound dataset
+ * "data", one member per column (DataFrameLayout::Rows), or in the
+ * "columns" group, one dataset per column named by the column's
+ * index and the names and units of the columns stored as attributes
+ * of the group (DataFrameLayout::Columns).
+ */
 class DataFrameHDF5 : virtual public base::IDataFrame, public EntityWithSourcesHDF5 {
+public:
+
+    /**
+     * In-memory layout of a set of columns: a packed compound of
+     * the columns' memory types.
+     */
+    struct RowLayout {
+        h5x::DataType            type;
+        std::vector<std::string> names;
+        std::vector<DataType>    dtypes;
+        std::vector<size_t>      offsets;
+        size_t                   size;
+    };
+
 private:
 
+    // the column datasets, DataFrameLayout::Columns only
+    struct ColumnStore {
+        std::vector<std::string> names;
+        std::vector<DataType>    dtypes;
+        std::vector<DataSet>     data;
+    };
+
+    // layout of complete rows, built on first use
+    mutable std::shared_ptr<RowLayout> row_layout;
+
+    // storage layout, looked up on first use
+    mutable boost::optional<DataFrameLayout> frame_layout;
+
+    // open column datasets, opened on first use
+    mutable std::shared_ptr<ColumnStore> column_store;
 
 public:
 
@@ -41,7 +79,10 @@ public:
     DataFrameHDF5(const std::shared_ptr<base::IFile> &file, const std::shared_ptr<base::IBlock> &block, const H5Group &group, const std::string &id, const std::string &type, const std::string &name, time_t time);
 
 
-    void createData(const std::vector<Column> &cols, const Compression &compression);
+    void createData(const std::vector<Column> &cols, const Compression &compression,
+                    DataFrameLayout layout = DataFrameLayout::Rows);
+
+    DataFrameLayout layout() const override;
 
     std::vector<Column> columns() const override;
 
@@ -60,6 +101,9 @@ public:
     std::vector<Cell> readCells(ndsize_t row, const std::vector<std::string> &names) const override;
     void writeCells(ndsize_t row, const std::vector<Cell> &cells) override;
 
+    void readRows(ndsize_t offset, ndsize_t count, RowBatch &rows) const override;
+    void writeRows(ndsize_t offset, const RowBatch &rows) override;
+
 
     void readColumn(const std::string &name,
                     ndsize_t offset,
@@ -74,6 +118,22 @@ public:
                      const void *data) override;
 
 private:
+    const RowLayout &rowLayout(const DataSet &ds) const;
+
+    bool columnar() const {
+        return layout() == DataFrameLayout::Columns;
+    }
+
+    // column storage helpers, DataFrameLayout::Columns only
+    H5Group columnGroup() const;
+    ColumnStore &columnStore() const;
+    const std::vector<std::string> &columnNames() const {
+        return columnStore().names;
+    }
+    DataSet &columnData(unsigned col) const;
+    Variant readCell(unsigned col, ndsize_t row) const;
+    void writeCell(unsigned col, ndsize_t row, const Variant &value);
+
     DataSet data() const {
         if (! group().hasData("data")) {
             throw ConsistencyError("DataFrame's hdf5 data group is missing!");
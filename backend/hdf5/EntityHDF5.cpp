@@ -7,6 +7,7 @@
 // LICENSE file in the root of the Project.
 
 #include "EntityHDF5.hpp"
+#include "FileHDF5.hpp"
 
 #include <nix/util/util.hpp>
 
@@ -51,43 +52,52 @@ string EntityHDF5::id() const {
 
 
 time_t EntityHDF5::updatedAt() const {
-    string t;
-    group().getAttr("updated_at", t);
-    return util::strToTime(t);
+    time_t t = 0;
+    group().getTimeAttr("updated_at", t);
+    return t;
 }
 
 
 void EntityHDF5::setUpdatedAt() {
     if (!group().hasAttr("updated_at")) {
         time_t t = util::getTime();
-        group().setAttr("updated_at", util::timeToStr(t));
+        group().setTimeAttr("updated_at", t, file_has_feature(entity_file, OpenFlags::IntegerTimestamps));
     }
 }
 
 
 void EntityHDF5::forceUpdatedAt() {
-    time_t t = util::getTime();
-    group().setAttr("updated_at", util::timeToStr(t));
+    forceUpdatedAt(util::getTime());
+}
+
+
+void EntityHDF5::forceUpdatedAt(time_t t) {
+    group().setTimeAttr("updated_at", t, file_has_feature(entity_file, OpenFlags::IntegerTimestamps));
 }
 
 
 time_t EntityHDF5::createdAt() const {
-    string t;
-    group().getAttr("created_at", t);
-    return util::strToTime(t);
+    time_t t = 0;
+    group().getTimeAttr("created_at", t);
+    return t;
 }
 
 
 void EntityHDF5::setCreatedAt() {
     if (!group().hasAttr("created_at")) {
         time_t t = util::getTime();
-        group().setAttr("created_at", util::timeToStr(t));
+        group().setTimeAttr("created_at", t, file_has_feature(entity_file, OpenFlags::IntegerTimestamps));
     }
 }
 
 
 void EntityHDF5::forceCreatedAt(time_t t) {
-    group().setAttr("created_at", util::timeToStr(t));
+    group().setTimeAttr("created_at", t, file_has_feature(entity_file, OpenFlags::IntegerTimestamps));
+}
+
+
+void EntityHDF5::forceId(const string &id) {
+    group().setAttr("entity_id", id);
 }
 
 
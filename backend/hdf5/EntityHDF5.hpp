@@ -54,12 +54,18 @@ public:
     void forceUpdatedAt();
 
 
+    void forceUpdatedAt(time_t t);
+
+
     void setCreatedAt();
 
 
     void forceCreatedAt(time_t t);
 
 
+    void forceId(const std::string &id);
+
+
     bool isValidEntity() const;
 
 
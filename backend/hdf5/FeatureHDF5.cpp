@@ -61,6 +61,17 @@ FeatureHDF5::FeatureHDF5(const shared_ptr<IFile> &file, const shared_ptr<IBlock>
 }
 
 
+void FeatureHDF5::forceId(const string &id) {
+    string path = group().name();
+    string renamed = path.substr(0, path.rfind('/') + 1) + id;
+    if (renamed != path) {
+        HErr res = H5Lmove(group().h5id(), path.c_str(), group().h5id(), renamed.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+        res.check("FeatureHDF5::forceId(): Could not rename group");
+    }
+    EntityHDF5::forceId(id);
+}
+
+
 void FeatureHDF5::linkType(LinkType link_type) {
     // linkTypeToString will generate an error if link_type is invalid
     group().setAttr("link_type", linkTypeToString(link_type));
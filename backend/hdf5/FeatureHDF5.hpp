@@ -65,6 +65,13 @@ public:
                 const std::string &id, DataArray data, LinkType link_type, time_t time);
 
 
+    /**
+     * Features are stored in a group named by their id, so the group is
+     * renamed as well.
+     */
+    void forceId(const std::string &id);
+
+
     void linkType(LinkType type);
 
 
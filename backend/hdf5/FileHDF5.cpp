@@ -15,6 +15,8 @@
 
 
 #include <fstream>
+#include <algorithm>
+#include <exception>
 #include <vector>
 #include <ctime>
 
@@ -24,6 +26,14 @@ namespace nix {
 namespace hdf5 {
 
 static FormatVersion my_version = HDF5_FF_VERSION;
+static FormatVersion table_version = HDF5_FF_TABLE_VERSION;
+
+// names of the format features in the "features" attribute
+static const vector<pair<OpenFlags, string>> feature_names = {
+    {OpenFlags::PropertyTables,    "property_tables"},
+    {OpenFlags::IntegerTimestamps, "int_timestamps"},
+    {OpenFlags::ColumnFrames,      "column_frames"}
+};
 
 static unsigned int map_file_mode(FileMode mode) {
     switch (mode) {
@@ -43,7 +53,7 @@ static unsigned int map_file_mode(FileMode mode) {
 
 
 FileHDF5::FileHDF5(const string &name, FileMode mode, Compression compression, OpenFlags flags):
-    file_format_version(HDF5_FF_VERSION) {
+    file_format_version(HDF5_FF_VERSION), features(OpenFlags::None), entities_sweep(64) {
     if (!fileExists(name)) {
         mode = FileMode::Overwrite;
     }
@@ -71,6 +81,10 @@ FileHDF5::FileHDF5(const string &name, FileMode mode, Compression compression, O
 
     openRoot();
     if (is_create) {
+        features = flags & (OpenFlags::PropertyTables | OpenFlags::IntegerTimestamps);
+        if (features != OpenFlags::None) {
+            file_format_version = table_version;
+        }
         createHeader();
     } else {
         checkHeader(mode, (flags & OpenFlags::Force) != OpenFlags::Force);
@@ -84,7 +98,83 @@ FileHDF5::FileHDF5(const string &name, FileMode mode, Compression compression, O
 }
 
 
+bool FileHDF5::libraryThreadSafe() {
+    hbool_t ts = false;
+    HErr res = H5is_library_threadsafe(&ts);
+    res.check("FileHDF5::libraryThreadSafe(): Could not query the library");
+    return ts > 0;
+}
+
+
+void FileHDF5::addFeature(OpenFlags feature) {
+    if (hasFeature(feature)) {
+        return;
+    }
+
+    features = features | feature;
+    file_format_version = table_version;
+
+    // the list of names grows, so the attribute is written anew
+    if (root.hasAttr("features")) {
+        root.removeAttr("features");
+    }
+    createHeader();
+}
+
+
+void FileHDF5::addWriteBuffer(const std::shared_ptr<WriteBufferHDF5> &buffer) {
+    auto expired = [](const std::weak_ptr<WriteBufferHDF5> &b) { return b.expired(); };
+    write_buffers.erase(std::remove_if(write_buffers.begin(), write_buffers.end(), expired), write_buffers.end());
+    write_buffers.push_back(buffer);
+}
+
+
+void FileHDF5::addReadAhead(const std::shared_ptr<ReadAheadHDF5> &buffer) {
+    auto expired = [](const std::weak_ptr<ReadAheadHDF5> &b) { return b.expired(); };
+    read_aheads.erase(std::remove_if(read_aheads.begin(), read_aheads.end(), expired), read_aheads.end());
+    read_aheads.push_back(buffer);
+}
+
+
+void FileHDF5::addEntity(const H5Group &group, const std::shared_ptr<base::IEntity> &entity) const {
+    addEntity(group.address(), entity);
+}
+
+
+std::shared_ptr<base::IEntity> FileHDF5::findEntity(haddr_t address) const {
+    auto it = entities.find(address);
+    return it != entities.end() ? it->second.lock() : std::shared_ptr<base::IEntity>();
+}
+
+
+void FileHDF5::addEntity(haddr_t address, const std::shared_ptr<base::IEntity> &entity) const {
+    if (!entity) {
+        return;
+    }
+    // entities that are no longer used are dropped whenever the map doubled
+    if (entities.size() >= entities_sweep) {
+        for (auto it = entities.begin(); it != entities.end();) {
+            it = it->second.expired() ? entities.erase(it) : std::next(it);
+        }
+        entities_sweep = std::max<size_t>(64, 2 * entities.size());
+    }
+    // an address is only reused once the entity it belonged to is gone
+    entities[address] = entity;
+}
+
+
+void FileHDF5::flushWriteBuffers() {
+    for (const auto &b : write_buffers) {
+        std::shared_ptr<WriteBufferHDF5> buffer = b.lock();
+        if (buffer) {
+            buffer->flush();
+        }
+    }
+}
+
+
 bool FileHDF5::flush() {
+    flushWriteBuffers();
     HErr err = H5Fflush(hid, H5F_SCOPE_GLOBAL);
     return !err.isError();
 }
@@ -103,8 +193,9 @@ shared_ptr<base::IBlock> FileHDF5::getBlock(const std::string &name_or_id) const
     shared_ptr<BlockHDF5> block;
 
     boost::optional<H5Group> group = data.findGroupByNameOrAttribute("entity_id", name_or_id);
-    if (group)
-        block = make_shared<BlockHDF5>(file(), *group);
+    if (group) {
+        block = entity<BlockHDF5>(*group, [this, &group] { return make_shared<BlockHDF5>(file(), *group); });
+    }
 
     return block;
 }
@@ -119,7 +210,9 @@ shared_ptr<base::IBlock> FileHDF5::getBlock(ndsize_t index) const {
 shared_ptr<base::IBlock> FileHDF5::createBlock(const string &name, const string &type) {
     string id = util::createId();
     H5Group group = data.openGroup(name, true);
-    return make_shared<BlockHDF5>(file(), group, id, type, name, compr);
+    shared_ptr<BlockHDF5> block = make_shared<BlockHDF5>(file(), group, id, type, name, compr);
+    addEntity(group, block);
+    return block;
 }
 
 
@@ -154,8 +247,9 @@ shared_ptr<base::ISection> FileHDF5::getSection(const std::string &name_or_id) c
     shared_ptr<SectionHDF5> sec;
 
     boost::optional<H5Group> group = metadata.findGroupByNameOrAttribute("entity_id", name_or_id);
-    if (group)
-        sec = make_shared<SectionHDF5>(file(), *group);
+    if (group) {
+        sec = entity<SectionHDF5>(*group, [this, &group] { return make_shared<SectionHDF5>(file(), *group); });
+    }
 
     return sec;
 }
@@ -171,7 +265,9 @@ shared_ptr<base::ISection> FileHDF5::createSection(const string &name, const  st
     string id = util::createId();
 
     H5Group group = metadata.openGroup(name, true);
-    return make_shared<SectionHDF5>(file(), group, id, type, name);
+    shared_ptr<SectionHDF5> sec = make_shared<SectionHDF5>(file(), group, id, type, name);
+    addEntity(group, sec);
+    return sec;
 }
 
 
@@ -205,43 +301,47 @@ ndsize_t FileHDF5::sectionCount() const {
 
 
 time_t FileHDF5::updatedAt() const {
-    string t;
-    root.getAttr("updated_at", t);
-    return util::strToTime(t);
+    time_t t = 0;
+    root.getTimeAttr("updated_at", t);
+    return t;
 }
 
 
 void FileHDF5::setUpdatedAt() {
     if (!root.hasAttr("updated_at")) {
         time_t t = time(NULL);
-        root.setAttr("updated_at", util::timeToStr(t));
+        root.setTimeAttr("updated_at", t, hasFeature(OpenFlags::IntegerTimestamps));
     }
 }
 
 
 void FileHDF5::forceUpdatedAt() {
-    time_t t = time(NULL);
-    root.setAttr("updated_at", util::timeToStr(t));
+    forceUpdatedAt(time(NULL));
+}
+
+
+void FileHDF5::forceUpdatedAt(time_t t) {
+    root.setTimeAttr("updated_at", t, hasFeature(OpenFlags::IntegerTimestamps));
 }
 
 
 time_t FileHDF5::createdAt() const {
-    string t;
-    root.getAttr("created_at", t);
-    return util::strToTime(t);
+    time_t t = 0;
+    root.getTimeAttr("created_at", t);
+    return t;
 }
 
 
 void FileHDF5::setCreatedAt() {
     if (!root.hasAttr("created_at")) {
         time_t t = time(NULL);
-        root.setAttr("created_at", util::timeToStr(t));
+        root.setTimeAttr("created_at", t, hasFeature(OpenFlags::IntegerTimestamps));
     }
 }
 
 
 void FileHDF5::forceCreatedAt(time_t t) {
-    root.setAttr("created_at", util::timeToStr(t));
+    root.setTimeAttr("created_at", t, hasFeature(OpenFlags::IntegerTimestamps));
 }
 
 
@@ -279,6 +379,23 @@ void FileHDF5::close() {
     if (!isOpen())
         return;
 
+    // close the file even if writing the buffered data fails
+    std::exception_ptr error;
+    try {
+        flushWriteBuffers();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    write_buffers.clear();
+
+    for (const auto &b : read_aheads) {
+        std::shared_ptr<ReadAheadHDF5> buffer = b.lock();
+        if (buffer) {
+            buffer->clear();
+        }
+    }
+    read_aheads.clear();
+
     data.close();
     metadata.close();
     root.close();
@@ -310,6 +427,10 @@ void FileHDF5::close() {
     }
 
     H5Object::close();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
 }
 
 
@@ -353,17 +474,19 @@ bool FileHDF5::checkHeader(FileMode mode, bool throw_error) {
         } else {
             file_format_version = FormatVersion(vv);
             if (mode == FileMode::ReadWrite) {
-                check = my_version.canWrite(file_format_version);
+                check = my_version.canWrite(file_format_version) ||
+                        table_version.canWrite(file_format_version);
                 if (!check) {
                     message << "Cannot open file for ReadWrite access, format mismatch! ";
-                    message << "API: " << my_version << ", File: " << file_format_version;
+                    message << "API: " << my_version << " or " << table_version;
+                    message << ", File: " << file_format_version;
                     message << (". ReadOnly access might work.");
                 }
             } else {
-                check = my_version.canRead(file_format_version);
+                check = table_version.canRead(file_format_version);
                 if (!check) {
                     message << "Cannot open file for Read access, format mismatch! ";
-                    message << "API: " << my_version << ", File: " << file_format_version;
+                    message << "API: " << table_version << ", File: " << file_format_version;
                 }
             }
         }
@@ -371,6 +494,14 @@ bool FileHDF5::checkHeader(FileMode mode, bool throw_error) {
         check = false;
         message << "File is not a valid NIX file, version attribute missing!";
     }
+    vector<string> names;
+    if (check && root.getAttr("features", names)) {
+        for (const auto &feature : feature_names) {
+            if (find(names.begin(), names.end(), feature.second) != names.end()) {
+                features = features | feature.first;
+            }
+        }
+    }
     if (!check && throw_error) {
         throw nix::InvalidFile(message.str());
     }
@@ -381,7 +512,17 @@ bool FileHDF5::checkHeader(FileMode mode, bool throw_error) {
 void FileHDF5::createHeader() {
     try {
         root.setAttr("format", FILE_FORMAT);
-        root.setAttr("version", std::vector<int>{my_version.x(), my_version.y(), my_version.z()});
+        root.setAttr("version", file_format_version.asVector());
+
+        vector<string> names;
+        for (const auto &feature : feature_names) {
+            if (hasFeature(feature.first)) {
+                names.push_back(feature.second);
+            }
+        }
+        if (!names.empty()) {
+            root.setAttr("features", names);
+        }
     } catch ( ... ) {
         throw H5Exception("Could not open/create file");
     }
@@ -415,7 +556,11 @@ bool FileHDF5::operator!=(const FileHDF5 &other) const {
 
 
 FileHDF5::~FileHDF5() {
-    close();
+    try {
+        close();
+    } catch (...) {
+        // destructors must not throw
+    }
 }
 
 } // ns nix::hdf5
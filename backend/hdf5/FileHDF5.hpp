@@ -10,14 +10,22 @@
 #define NIX_FILE_HDF5_H
 
 #include <nix/base/IFile.hpp>
+#include <nix/base/IEntity.hpp>
 #include <nix/Version.hpp>
 
 #include "h5x/H5Group.hpp"
+#include "WriteBufferHDF5.hpp"
+#include "ReadAheadHDF5.hpp"
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <unordered_map>
 
 #define HDF5_FF_VERSION nix::FormatVersion({1, 1, 1})
+// files using format features, cf. OpenFlags::PropertyTables,
+// OpenFlags::IntegerTimestamps and OpenFlags::ColumnFrames
+#define HDF5_FF_TABLE_VERSION nix::FormatVersion({1, 2, 0})
 
 namespace nix {
 namespace hdf5 {
@@ -34,6 +42,11 @@ private:
     H5Group root, metadata, data;
     FileMode mode;
     FormatVersion file_format_version;
+    OpenFlags features;
+    std::vector<std::weak_ptr<WriteBufferHDF5>> write_buffers;
+    std::vector<std::weak_ptr<ReadAheadHDF5>> read_aheads;
+    mutable std::unordered_map<haddr_t, std::weak_ptr<base::IEntity>> entities;
+    mutable size_t entities_sweep;
 
 public:
 
@@ -46,6 +59,12 @@ public:
      */
     FileHDF5(const std::string &name, const FileMode mode = FileMode::ReadWrite, const Compression compression = Compression::Auto, OpenFlags flags = OpenFlags::None);
 
+    /**
+     * Whether the HDF5 library was built thread-safe, i.e. may be called
+     * from several threads at once.
+     */
+    static bool libraryThreadSafe();
+
     //--------------------------------------------------
     // Methods concerning blocks
     //--------------------------------------------------
@@ -117,6 +136,9 @@ public:
     void forceUpdatedAt();
 
 
+    void forceUpdatedAt(time_t t);
+
+
     void setCreatedAt();
 
 
@@ -134,6 +156,50 @@ public:
 
     Compression compression() const;
 
+    /**
+     * @brief Whether the file uses the given format feature, i.e. was
+     *        created with the corresponding {@link OpenFlags}.
+     */
+    bool hasFeature(OpenFlags feature) const {
+        return (features & feature) == feature;
+    }
+
+    /**
+     * @brief Mark the file as using a format feature, for features that
+     *        come with the first entity that needs them, like
+     *        OpenFlags::ColumnFrames. Updates the version of the file.
+     */
+    void addFeature(OpenFlags feature);
+
+
+    /**
+     * @brief Register the write buffer of a DataArray, so that it is
+     *        flushed by flush() and close().
+     */
+    void addWriteBuffer(const std::shared_ptr<WriteBufferHDF5> &buffer);
+
+
+    /**
+     * @brief Register the read-ahead buffer of a DataArray, so that its
+     *        fetches are done before close().
+     */
+    void addReadAhead(const std::shared_ptr<ReadAheadHDF5> &buffer);
+
+    /**
+     * @brief The backend object of the entity stored in group.
+     *
+     * While an entity is in use, lookups by any link to its group return the
+     * same object, with its open handles and caches; otherwise the object
+     * returned by make() is remembered and returned.
+     */
+    template<typename T, typename F>
+    std::shared_ptr<T> entity(const H5Group &group, F make) const;
+
+    /**
+     * @brief Remember a newly created entity, see entity().
+     */
+    void addEntity(const H5Group &group, const std::shared_ptr<base::IEntity> &entity) const;
+
 
     bool operator==(const FileHDF5 &other) const;
 
@@ -147,6 +213,12 @@ private:
 
     std::shared_ptr<base::IFile> file() const;
 
+    void flushWriteBuffers();
+
+    std::shared_ptr<base::IEntity> findEntity(haddr_t address) const;
+
+    void addEntity(haddr_t address, const std::shared_ptr<base::IEntity> &entity) const;
+
     // check for existence
     bool fileExists(const std::string &name) const;
 
@@ -161,6 +233,24 @@ private:
 };
 
 
+template<typename T, typename F>
+std::shared_ptr<T> FileHDF5::entity(const H5Group &group, F make) const {
+    const haddr_t address = group.address();
+    std::shared_ptr<T> obj = std::dynamic_pointer_cast<T>(findEntity(address));
+    if (!obj) {
+        obj = make();
+        addEntity(address, obj);
+    }
+    return obj;
+}
+
+
+inline bool file_has_feature(const std::shared_ptr<base::IFile> &file, OpenFlags feature) {
+    auto f = std::dynamic_pointer_cast<FileHDF5>(file);
+    return f && f->hasFeature(feature);
+}
+
+
 } // namespace hdf5
 } // namespace nix
 
@@ -7,6 +7,7 @@
 // LICENSE file in the root of the Project.
 
 #include "PropertyHDF5.hpp"
+#include "FileHDF5.hpp"
 
 #include <nix/util/util.hpp>
 #include <nix/Version.hpp>
@@ -84,43 +85,52 @@ string PropertyHDF5::id() const {
 
 
 time_t PropertyHDF5::updatedAt() const {
-    string t;
-    dataset().getAttr("updated_at", t);
-    return util::strToTime(t);
+    time_t t = 0;
+    dataset().getTimeAttr("updated_at", t);
+    return t;
 }
 
 
 void PropertyHDF5::setUpdatedAt() {
     if (!dataset().hasAttr("updated_at")) {
         time_t t = util::getTime();
-        dataset().setAttr("updated_at", util::timeToStr(t));
+        dataset().setTimeAttr("updated_at", t, file_has_feature(entity_file, OpenFlags::IntegerTimestamps));
     }
 }
 
 
 void PropertyHDF5::forceUpdatedAt() {
-    time_t t = util::getTime();
-    dataset().setAttr("updated_at", util::timeToStr(t));
+    forceUpdatedAt(util::getTime());
+}
+
+
+void PropertyHDF5::forceUpdatedAt(time_t t) {
+    dataset().setTimeAttr("updated_at", t, file_has_feature(entity_file, OpenFlags::IntegerTimestamps));
 }
 
 
 time_t PropertyHDF5::createdAt() const {
-    string t;
-    dataset().getAttr("created_at", t);
-    return util::strToTime(t);
+    time_t t = 0;
+    dataset().getTimeAttr("created_at", t);
+    return t;
 }
 
 
 void PropertyHDF5::setCreatedAt() {
     if (!dataset().hasAttr("created_at")) {
         time_t t = util::getTime();
-        dataset().setAttr("created_at", util::timeToStr(t));
+        dataset().setTimeAttr("created_at", t, file_has_feature(entity_file, OpenFlags::IntegerTimestamps));
     }
 }
 
 
 void PropertyHDF5::forceCreatedAt(time_t t) {
-    dataset().setAttr("created_at", util::timeToStr(t));
+    dataset().setTimeAttr("created_at", t, file_has_feature(entity_file, OpenFlags::IntegerTimestamps));
+}
+
+
+void PropertyHDF5::forceId(const string &id) {
+    dataset().setAttr("entity_id", id);
 }
 
 
@@ -507,6 +517,59 @@ void PropertyHDF5::values(const nix::none_t t) {
 }
 
 
+void PropertyHDF5::readValues(DataType dtype, void *data, ndsize_t count) const {
+    if (count < 1) {
+        return;
+    }
+
+    DataSet dset = dataset();
+    h5x::DataType memType = data_type_to_h5_memtype(dtype);
+
+    nix::FormatVersion ver(this->entity_file->version());
+    if (ver < nix::FormatVersion({1, 1, 1})) {
+        // old style values are compounds, only read their value member
+        h5x::DataType ct = h5x::DataType::makeCompound(memType.size());
+        ct.insert("value", 0, memType);
+        memType = ct;
+    }
+
+    DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = dset.offsetCount2DataSpaces({count});
+
+    if (dtype == DataType::String) {
+        StringWriter writer({count}, data);
+        dset.read(writer, memType, memSpace, fileSpace);
+    } else {
+        dset.read(data, memType, memSpace, fileSpace);
+    }
+}
+
+
+void PropertyHDF5::writeValues(DataType dtype, const void *data, ndsize_t count) {
+    if (count < 1) {
+        deleteValues();
+        return;
+    }
+
+    DataSet dset = dataset();
+    if (dtype != data_type_from_h5(dset.dataType())) {
+        throw std::invalid_argument("Inconsistent DataTypes!");
+    }
+    dset.setExtent(NDSize{count});
+
+    h5x::DataType memType = data_type_to_h5_memtype(dtype);
+    DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = dset.offsetCount2DataSpaces({count});
+
+    if (dtype == DataType::String) {
+        StringReader reader({count}, data);
+        dset.write(*reader, memType, memSpace, fileSpace);
+    } else {
+        dset.write(data, memType, memSpace, fileSpace);
+    }
+}
+
+
 
 } // ns nix::hdf5
 } // ns nix
@@ -63,12 +63,18 @@ public:
     void forceUpdatedAt();
 
 
+    void forceUpdatedAt(time_t t);
+
+
     void setCreatedAt();
 
 
     void forceCreatedAt(time_t t);
 
 
+    void forceId(const std::string &id);
+
+
     std::string name() const;
 
 
@@ -117,6 +123,12 @@ public:
     void values(const boost::none_t t);
 
 
+    void readValues(DataType dtype, void *data, ndsize_t count) const;
+
+
+    void writeValues(DataType dtype, const void *data, ndsize_t count);
+
+
     bool isValidEntity() const;
 
 
@@ -0,0 +1,283 @@
+// Copyright (c) 2013, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include "PropertyRowHDF5.hpp"
+
+#include <nix/util/util.hpp>
+
+using namespace std;
+
+using namespace nix::base;
+
+namespace nix {
+namespace hdf5 {
+
+
+PropertyRowHDF5::PropertyRowHDF5(const std::shared_ptr<IFile> &file, const std::shared_ptr<ISection> &section,
+                                 const PropertyTableHDF5 &table, const string &id, ndsize_t index)
+    : entity_file(file), section(section), table(table), entity_id(id), row_index(index)
+{
+}
+
+
+ndsize_t PropertyRowHDF5::row() const {
+    if (row_index >= table.rowCount() || table.rowId(row_index) != entity_id) {
+        boost::optional<ndsize_t> index = table.findRow(entity_id);
+        if (!index) {
+            throw std::runtime_error("Property does not exist anymore!");
+        }
+        row_index = *index;
+    }
+
+    return row_index;
+}
+
+
+void PropertyRowHDF5::writeRow(PropertyTableHDF5::Row &entry, bool touch) {
+    if (touch) {
+        entry.updated_at = util::getTime();
+    }
+    table.writeRow(row(), entry);
+}
+
+
+string PropertyRowHDF5::id() const {
+    return entity_id;
+}
+
+
+time_t PropertyRowHDF5::updatedAt() const {
+    return readRow().updated_at;
+}
+
+
+void PropertyRowHDF5::setUpdatedAt() {
+    // rows always carry a time stamp
+}
+
+
+void PropertyRowHDF5::forceUpdatedAt() {
+    PropertyTableHDF5::Row entry = readRow();
+    writeRow(entry);
+}
+
+
+void PropertyRowHDF5::forceUpdatedAt(time_t t) {
+    PropertyTableHDF5::Row entry = readRow();
+    entry.updated_at = t;
+    writeRow(entry, false);
+}
+
+
+time_t PropertyRowHDF5::createdAt() const {
+    return readRow().created_at;
+}
+
+
+void PropertyRowHDF5::setCreatedAt() {
+    // rows always carry a time stamp
+}
+
+
+void PropertyRowHDF5::forceCreatedAt(time_t t) {
+    PropertyTableHDF5::Row entry = readRow();
+    entry.created_at = t;
+    writeRow(entry, false);
+}
+
+
+void PropertyRowHDF5::forceId(const string &id) {
+    PropertyTableHDF5::Row entry = readRow();
+    entry.id = id;
+    writeRow(entry, false);
+    entity_id = id;
+}
+
+
+string PropertyRowHDF5::name() const {
+    return readRow().name;
+}
+
+
+void PropertyRowHDF5::definition(const string &definition) {
+    PropertyTableHDF5::Row entry = readRow();
+    entry.definition = definition;
+    writeRow(entry);
+}
+
+
+boost::optional<string> PropertyRowHDF5::definition() const {
+    return readRow().definition;
+}
+
+
+void PropertyRowHDF5::definition(const nix::none_t t) {
+    PropertyTableHDF5::Row entry = readRow();
+    entry.definition = boost::none;
+    writeRow(entry);
+}
+
+
+DataType PropertyRowHDF5::dataType() const {
+    return readRow().dtype;
+}
+
+
+void PropertyRowHDF5::unit(const string &unit) {
+    PropertyTableHDF5::Row entry = readRow();
+    entry.unit = unit;
+    writeRow(entry);
+}
+
+
+boost::optional<string> PropertyRowHDF5::unit() const {
+    return readRow().unit;
+}
+
+
+void PropertyRowHDF5::unit(const nix::none_t t) {
+    PropertyTableHDF5::Row entry = readRow();
+    entry.unit = boost::none;
+    writeRow(entry);
+}
+
+
+void PropertyRowHDF5::uncertainty(double uncertainty) {
+    PropertyTableHDF5::Row entry = readRow();
+    entry.uncertainty = uncertainty;
+    writeRow(entry);
+}
+
+
+boost::optional<double> PropertyRowHDF5::uncertainty() const {
+    return readRow().uncertainty;
+}
+
+
+void PropertyRowHDF5::uncertainty(const nix::none_t t) {
+    PropertyTableHDF5::Row entry = readRow();
+    entry.uncertainty = boost::none;
+    writeRow(entry);
+}
+
+
+bool PropertyRowHDF5::isValidEntity() const {
+    if (row_index < table.rowCount() && table.rowId(row_index) == entity_id) {
+        return true;
+    }
+    return static_cast<bool>(table.findRow(entity_id));
+}
+
+
+PropertyRowHDF5::~PropertyRowHDF5() {}
+
+/* Value related functions */
+
+#define DATATYPE_SUPPORT_NOT_IMPLEMENTED false
+
+// bool values are read and written via char buffers, std::vector<bool>
+// has no contiguous storage
+template<typename T, typename S = T>
+void do_read_variants(const PropertyRowHDF5 &prop, ndsize_t count, std::vector<Variant> &values) {
+    size_t n = nix::check::fits_in_size_t(count, "Can't resize: data to big for memory");
+    std::vector<S> buffer(n);
+
+    prop.readValues(prop.dataType(), buffer.data(), count);
+
+    values.reserve(n);
+    for (const S &val : buffer) {
+        values.emplace_back(static_cast<T>(val));
+    }
+}
+
+
+template<typename T, typename S = T>
+void do_write_variants(PropertyRowHDF5 &prop, DataType dtype, const std::vector<Variant> &values) {
+    std::vector<S> buffer;
+    buffer.reserve(values.size());
+
+    for (const Variant &val : values) {
+        buffer.push_back(static_cast<S>(val.get<T>()));
+    }
+
+    prop.writeValues(dtype, buffer.data(), buffer.size());
+}
+
+// value public API
+
+void PropertyRowHDF5::deleteValues() {
+    writeValues(dataType(), nullptr, 0);
+}
+
+
+ndsize_t PropertyRowHDF5::valueCount() const {
+    return readRow().count;
+}
+
+
+void PropertyRowHDF5::values(const std::vector<Variant> &values) {
+    if (values.size() < 1) {
+        deleteValues();
+        return;
+    }
+
+    DataType dt = values[0].type();
+    switch(dt) {
+        case DataType::Bool:   do_write_variants<bool, char>(*this, dt, values);   break;
+        case DataType::Int32:  do_write_variants<int32_t>(*this, dt, values);      break;
+        case DataType::UInt32: do_write_variants<uint32_t>(*this, dt, values);     break;
+        case DataType::Int64:  do_write_variants<int64_t>(*this, dt, values);      break;
+        case DataType::UInt64: do_write_variants<uint64_t>(*this, dt, values);     break;
+        case DataType::String: do_write_variants<std::string>(*this, dt, values);  break;
+        case DataType::Double: do_write_variants<double>(*this, dt, values);       break;
+        default: assert(DATATYPE_SUPPORT_NOT_IMPLEMENTED);
+    }
+}
+
+
+std::vector<Variant> PropertyRowHDF5::values(void) const {
+    std::vector<Variant> values;
+    PropertyTableHDF5::Row entry = readRow();
+
+    if (entry.count < 1) {
+        return values;
+    }
+
+    switch (entry.dtype) {
+        case DataType::Bool:   do_read_variants<bool, char>(*this, entry.count, values);   break;
+        case DataType::Int32:  do_read_variants<int32_t>(*this, entry.count, values);      break;
+        case DataType::UInt32: do_read_variants<uint32_t>(*this, entry.count, values);     break;
+        case DataType::Int64:  do_read_variants<int64_t>(*this, entry.count, values);      break;
+        case DataType::UInt64: do_read_variants<uint64_t>(*this, entry.count, values);     break;
+        case DataType::String: do_read_variants<std::string>(*this, entry.count, values);  break;
+        case DataType::Double: do_read_variants<double>(*this, entry.count, values);       break;
+        default: assert(DATATYPE_SUPPORT_NOT_IMPLEMENTED);
+    }
+
+    return values;
+}
+
+
+void PropertyRowHDF5::values(const nix::none_t t) {
+    deleteValues();
+}
+
+
+void PropertyRowHDF5::readValues(DataType dtype, void *data, ndsize_t count) const {
+    table.readValues(readRow(), dtype, data, count);
+}
+
+
+void PropertyRowHDF5::writeValues(DataType dtype, const void *data, ndsize_t count) {
+    PropertyTableHDF5::Row entry = readRow();
+    table.writeValues(entry, dtype, data, count);
+    writeRow(entry);
+}
+
+} // ns nix::hdf5
+} // ns nix
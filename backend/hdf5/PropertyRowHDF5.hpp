@@ -0,0 +1,151 @@
+// Copyright (c) 2013, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_PROPERTY_ROW_HDF5_H
+#define NIX_PROPERTY_ROW_HDF5_H
+
+#include <nix/base/IFile.hpp>
+#include <nix/base/IProperty.hpp>
+#include <nix/base/ISection.hpp>
+
+#include "PropertyTableHDF5.hpp"
+
+#include <string>
+#include <memory>
+#include <ctime>
+
+namespace nix {
+namespace hdf5 {
+
+/**
+ * @brief A property stored as a row of the property table of its
+ *        section, see {@link PropertyTableHDF5}.
+ */
+class PropertyRowHDF5 : virtual public base::IProperty {
+
+    std::shared_ptr<base::IFile>  entity_file;
+    // keeps the section in use, so that lookups of the section return the
+    // object that owns table and all rows share its cached row keys
+    std::shared_ptr<base::ISection> section;
+    PropertyTableHDF5             table;
+    std::string                   entity_id;
+    mutable ndsize_t              row_index;
+
+public:
+
+    /**
+     * Standard constructor for existing property
+     */
+    PropertyRowHDF5(const std::shared_ptr<base::IFile> &file, const std::shared_ptr<base::ISection> &section,
+                    const PropertyTableHDF5 &table, const std::string &id, ndsize_t index);
+
+
+    std::string id() const;
+
+
+    time_t updatedAt() const;
+
+
+    time_t createdAt() const;
+
+
+    void setUpdatedAt();
+
+
+    void forceUpdatedAt();
+
+
+    void forceUpdatedAt(time_t t);
+
+
+    void setCreatedAt();
+
+
+    void forceCreatedAt(time_t t);
+
+
+    void forceId(const std::string &id);
+
+
+    std::string name() const;
+
+
+    boost::optional<std::string> definition() const;
+
+
+    void definition(const std::string &definition);
+
+
+    void definition(const none_t t);
+
+
+    DataType dataType() const;
+
+
+    void unit(const std::string &unit);
+
+
+    boost::optional<std::string> unit() const;
+
+
+    void unit(const none_t t);
+
+
+    void uncertainty(double uncertainty);
+
+
+    boost::optional<double> uncertainty() const;
+
+
+    void uncertainty(const none_t t);
+
+
+    void deleteValues();
+
+
+    ndsize_t valueCount() const;
+
+
+    void values(const std::vector<Variant> &values);
+
+
+    std::vector<Variant> values(void) const;
+
+
+    void values(const boost::none_t t);
+
+
+    void readValues(DataType dtype, void *data, ndsize_t count) const;
+
+
+    void writeValues(DataType dtype, const void *data, ndsize_t count);
+
+
+    bool isValidEntity() const;
+
+
+    virtual ~PropertyRowHDF5();
+
+private:
+
+    // index of the row, looked up again if the table has changed
+    ndsize_t row() const;
+
+    PropertyTableHDF5::Row readRow() const {
+        return table.readRow(row());
+    }
+
+    void writeRow(PropertyTableHDF5::Row &entry, bool touch = true);
+
+};
+
+
+} // namespace hdf5
+} // namespace nix
+
+#endif // NIX_PROPERTY_ROW_HDF5_H
@@ -0,0 +1,444 @@
+// Copyright (c) 2013, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include "PropertyTableHDF5.hpp"
+
+#include <nix/Exception.hpp>
+
+#include <vector>
+
+using namespace std;
+
+namespace nix {
+namespace hdf5 {
+
+#ifdef _MSC_VER
+#pragma pack(push,1)
+#endif
+struct NIX_PACKED PropertyRecord {
+    char     *name;
+    char     *entity_id;
+    int64_t   created_at;
+    int64_t   updated_at;
+    char     *definition;
+    char     *unit;
+    double    uncertainty;
+    uint8_t   flags;
+    int8_t    data_type;
+    uint64_t  offset;
+    uint64_t  count;
+};
+
+struct NIX_PACKED PropertyKey {
+    char     *name;
+    char     *entity_id;
+};
+#ifdef _MSC_VER
+#pragma pack(pop)
+#endif
+
+enum RecordFlags : uint8_t {
+    HasDefinition  = 1 << 0,
+    HasUnit        = 1 << 1,
+    HasUncertainty = 1 << 2
+};
+
+
+static h5x::DataType data_type_enum(bool for_memory) {
+    h5x::DataType base = data_type_to_h5(DataType::Int8, for_memory);
+    h5x::DataType et = h5x::DataType::makeEnum(base);
+
+    for (DataType dtype : {DataType::Bool, DataType::Int32, DataType::UInt32, DataType::Int64,
+                           DataType::UInt64, DataType::Double, DataType::String}) {
+        int8_t value = static_cast<int8_t>(dtype);
+        et.insert(data_type_to_string(dtype), &value);
+    }
+
+    return et;
+}
+
+
+static h5x::DataType record_type(bool for_memory) {
+    h5x::DataType ct = h5x::DataType::makeCompound(sizeof(PropertyRecord));
+    h5x::DataType str_type = h5x::DataType::makeStrType();
+    h5x::DataType time_type = data_type_to_h5(DataType::Int64, for_memory);
+    h5x::DataType size_type = data_type_to_h5(DataType::UInt64, for_memory);
+
+    ct.insert("name", HOFFSET(PropertyRecord, name), str_type);
+    ct.insert("entity_id", HOFFSET(PropertyRecord, entity_id), str_type);
+    ct.insert("created_at", HOFFSET(PropertyRecord, created_at), time_type);
+    ct.insert("updated_at", HOFFSET(PropertyRecord, updated_at), time_type);
+    ct.insert("definition", HOFFSET(PropertyRecord, definition), str_type);
+    ct.insert("unit", HOFFSET(PropertyRecord, unit), str_type);
+    ct.insert("uncertainty", HOFFSET(PropertyRecord, uncertainty), data_type_to_h5(DataType::Double, for_memory));
+    ct.insert("flags", HOFFSET(PropertyRecord, flags), data_type_to_h5(DataType::UInt8, for_memory));
+    ct.insert("data_type", HOFFSET(PropertyRecord, data_type), data_type_enum(for_memory));
+    ct.insert("offset", HOFFSET(PropertyRecord, offset), size_type);
+    ct.insert("count", HOFFSET(PropertyRecord, count), size_type);
+
+    return ct;
+}
+
+
+static h5x::DataType key_type() {
+    // only the name and entity_id members of the records
+    h5x::DataType ct = h5x::DataType::makeCompound(sizeof(PropertyKey));
+    h5x::DataType str_type = h5x::DataType::makeStrType();
+
+    ct.insert("name", HOFFSET(PropertyKey, name), str_type);
+    ct.insert("entity_id", HOFFSET(PropertyKey, entity_id), str_type);
+
+    return ct;
+}
+
+
+static PropertyRecord to_record(const PropertyTableHDF5::Row &row) {
+    PropertyRecord rec;
+
+    rec.name = const_cast<char *>(row.name.c_str());
+    rec.entity_id = const_cast<char *>(row.id.c_str());
+    rec.created_at = static_cast<int64_t>(row.created_at);
+    rec.updated_at = static_cast<int64_t>(row.updated_at);
+    rec.definition = const_cast<char *>(row.definition ? row.definition->c_str() : "");
+    rec.unit = const_cast<char *>(row.unit ? row.unit->c_str() : "");
+    rec.uncertainty = row.uncertainty ? *row.uncertainty : 0.0;
+    rec.flags = (row.definition ? HasDefinition : 0) |
+                (row.unit ? HasUnit : 0) |
+                (row.uncertainty ? HasUncertainty : 0);
+    rec.data_type = static_cast<int8_t>(row.dtype);
+    rec.offset = row.offset;
+    rec.count = row.count;
+
+    return rec;
+}
+
+
+static PropertyTableHDF5::Row from_record(const PropertyRecord &rec) {
+    PropertyTableHDF5::Row row;
+
+    row.name = rec.name;
+    row.id = rec.entity_id;
+    row.created_at = static_cast<time_t>(rec.created_at);
+    row.updated_at = static_cast<time_t>(rec.updated_at);
+    if (rec.flags & HasDefinition) {
+        row.definition = string(rec.definition);
+    }
+    if (rec.flags & HasUnit) {
+        row.unit = string(rec.unit);
+    }
+    if (rec.flags & HasUncertainty) {
+        row.uncertainty = rec.uncertainty;
+    }
+    row.dtype = static_cast<DataType>(rec.data_type);
+    row.offset = rec.offset;
+    row.count = rec.count;
+
+    return row;
+}
+
+
+PropertyTableHDF5::PropertyTableHDF5(const H5Group &section_group)
+    : group(section_group), key_cache(make_shared<Index>())
+{
+}
+
+
+boost::optional<DataSet> PropertyTableHDF5::table(bool create) const {
+    boost::optional<DataSet> ds;
+
+    if (group.hasData("property_table")) {
+        ds = group.openData("property_table");
+    } else if (create) {
+        ds = group.createData("property_table", record_type(false), {0});
+    }
+
+    return ds;
+}
+
+
+boost::optional<DataSet> PropertyTableHDF5::heap(DataType dtype, bool create) const {
+    boost::optional<DataSet> ds;
+    const string name = data_type_to_string(dtype);
+
+    if (!group.hasGroup("property_values") && !create) {
+        return ds;
+    }
+
+    H5Group values = group.openGroup("property_values", true);
+    if (values.hasData(name)) {
+        ds = values.openData(name);
+    } else if (create) {
+        ds = values.createData(name, data_type_to_h5_filetype(dtype), {0});
+    }
+
+    return ds;
+}
+
+
+PropertyTableHDF5::Index &PropertyTableHDF5::keys() const {
+    if (key_cache->loaded) {
+        return *key_cache;
+    }
+
+    boost::optional<DataSet> ds = table();
+    ndsize_t nrows = ds ? ds->size()[0] : 0;
+    size_t n = nix::check::fits_in_size_t(nrows, "Can't resize: data to big for memory");
+
+    key_cache->keys.clear();
+    key_cache->rows.clear();
+    key_cache->keys.reserve(n);
+
+    if (n > 0) {
+        vector<PropertyKey> raw(n);
+        h5x::DataType memType = key_type();
+        ds->read(raw.data(), memType, H5S_ALL, H5S_ALL);
+
+        for (size_t i = 0; i < n; i++) {
+            Key key{raw[i].name, raw[i].entity_id};
+            key_cache->rows.emplace(key.name, i);
+            key_cache->rows.emplace(key.id, i);
+            key_cache->keys.push_back(std::move(key));
+        }
+
+        ds->vlenReclaim(memType, raw.data());
+    }
+
+    key_cache->loaded = true;
+    return *key_cache;
+}
+
+
+ndsize_t PropertyTableHDF5::rowCount() const {
+    return keys().keys.size();
+}
+
+
+boost::optional<ndsize_t> PropertyTableHDF5::findRow(const string &name_or_id) const {
+    boost::optional<ndsize_t> row;
+    const Index &idx = keys();
+
+    auto it = idx.rows.find(name_or_id);
+    if (it != idx.rows.end()) {
+        row = it->second;
+    }
+
+    return row;
+}
+
+
+string PropertyTableHDF5::rowId(ndsize_t index) const {
+    const Index &idx = keys();
+    if (index >= idx.keys.size()) {
+        throw OutOfBounds("No property row at given index", index);
+    }
+
+    return idx.keys[index].id;
+}
+
+
+PropertyTableHDF5::Row PropertyTableHDF5::readRow(ndsize_t index) const {
+    if (index >= rowCount()) {
+        throw OutOfBounds("No property row at given index", index);
+    }
+
+    DataSet ds = *table();
+    PropertyRecord rec;
+    h5x::DataType memType = record_type(true);
+    DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces({1}, {index});
+
+    ds.read(&rec, memType, memSpace, fileSpace);
+    Row row = from_record(rec);
+    ds.vlenReclaim(memType, &rec, &memSpace);
+
+    return row;
+}
+
+
+void PropertyTableHDF5::writeRow(ndsize_t index, const Row &row) {
+    DataSet ds = *table(true);
+    PropertyRecord rec = to_record(row);
+    DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces({1}, {index});
+
+    ds.write(&rec, record_type(true), memSpace, fileSpace);
+
+    if (key_cache->loaded && index < key_cache->keys.size()) {
+        const Key &key = key_cache->keys[index];
+        if (key.name != row.name || key.id != row.id) {
+            key_cache->loaded = false;
+        }
+    }
+}
+
+
+ndsize_t PropertyTableHDF5::appendRow(const Row &row) {
+    Index &idx = keys();
+    DataSet ds = *table(true);
+    ndsize_t index = ds.size()[0];
+
+    ds.setExtent({index + 1});
+    writeRow(index, row);
+
+    idx.keys.push_back(Key{row.name, row.id});
+    idx.rows.emplace(row.name, index);
+    idx.rows.emplace(row.id, index);
+
+    return index;
+}
+
+
+void PropertyTableHDF5::removeRow(ndsize_t index) {
+    ndsize_t nrows = rowCount();
+    if (index >= nrows) {
+        throw OutOfBounds("No property row at given index", index);
+    }
+
+    Row row = readRow(index);
+    releaseValues(row.dtype, row.offset, row.count);
+
+    DataSet ds = *table();
+    ndsize_t tail = nrows - index - 1;
+
+    if (tail > 0) {
+        // move all following rows up by one
+        size_t n = nix::check::fits_in_size_t(tail, "Can't resize: data to big for memory");
+        vector<PropertyRecord> recs(n);
+        h5x::DataType memType = record_type(true);
+        DataSpace fileSpace, memSpace;
+
+        std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces({tail}, {index + 1});
+        ds.read(recs.data(), memType, memSpace, fileSpace);
+
+        DataSpace dstSpace;
+        std::tie(std::ignore, dstSpace) = ds.offsetCount2DataSpaces({tail}, {index});
+        ds.write(recs.data(), memType, memSpace, dstSpace);
+
+        ds.vlenReclaim(memType, recs.data(), &memSpace);
+    }
+
+    ds.setExtent({nrows - 1});
+    key_cache->loaded = false;
+}
+
+
+void PropertyTableHDF5::readValues(const Row &row, DataType dtype, void *data, ndsize_t count) const {
+    if (count < 1) {
+        return;
+    }
+
+    if (count > row.count) {
+        throw OutOfBounds("Trying to read more values than stored in the property", count);
+    }
+
+    DataSet ds = *heap(row.dtype);
+    h5x::DataType memType = data_type_to_h5_memtype(dtype);
+    DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces({count}, {row.offset});
+
+    if (dtype == DataType::String) {
+        StringWriter writer({count}, data);
+        ds.read(writer, memType, memSpace, fileSpace);
+    } else {
+        ds.read(data, memType, memSpace, fileSpace);
+    }
+}
+
+
+void PropertyTableHDF5::writeValues(Row &row, DataType dtype, const void *data, ndsize_t count) {
+    if (dtype != row.dtype) {
+        throw std::invalid_argument("Inconsistent DataTypes!");
+    }
+
+    DataSet ds = *heap(row.dtype, true);
+    ndsize_t heap_size = ds.size()[0];
+
+    if (count <= row.count) {
+        // fits into the old slot, give back the rest
+        releaseValues(row.dtype, row.offset + count, row.count - count);
+    } else if (row.offset + row.count == heap_size) {
+        // the slot is at the end of the heap, grow it in place
+        ds.setExtent({row.offset + count});
+    } else {
+        releaseValues(row.dtype, row.offset, row.count);
+        heap_size = ds.size()[0];
+        ds.setExtent({heap_size + count});
+        row.offset = heap_size;
+    }
+    row.count = count;
+
+    if (count < 1) {
+        return;
+    }
+
+    h5x::DataType memType = data_type_to_h5_memtype(dtype);
+    DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces({count}, {row.offset});
+
+    if (dtype == DataType::String) {
+        StringReader reader({count}, data);
+        ds.write(*reader, memType, memSpace, fileSpace);
+    } else {
+        ds.write(data, memType, memSpace, fileSpace);
+    }
+}
+
+
+void PropertyTableHDF5::releaseValues(DataType dtype, ndsize_t offset, ndsize_t count) {
+    if (count < 1) {
+        return;
+    }
+
+    DataSet ds = *heap(dtype);
+    ndsize_t heap_size = ds.size()[0];
+    ndsize_t tail = heap_size - offset - count;
+
+    if (tail > 0) {
+        // move the following values down into the gap
+        size_t n = nix::check::fits_in_size_t(tail, "Can't resize: data to big for memory");
+        h5x::DataType memType = data_type_to_h5_memtype(dtype);
+        vector<char> buffer(n * memType.size());
+        DataSpace fileSpace, memSpace;
+
+        std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces({tail}, {offset + count});
+        ds.read(buffer.data(), memType, memSpace, fileSpace);
+
+        DataSpace dstSpace;
+        std::tie(std::ignore, dstSpace) = ds.offsetCount2DataSpaces({tail}, {offset});
+        ds.write(buffer.data(), memType, memSpace, dstSpace);
+
+        if (dtype == DataType::String) {
+            ds.vlenReclaim(memType, buffer.data(), &memSpace);
+        }
+
+        // and the rows that reference them
+        DataSet tds = *table();
+        size_t nrows = nix::check::fits_in_size_t(tds.size()[0], "Can't resize: data to big for memory");
+        vector<PropertyRecord> recs(nrows);
+        h5x::DataType recType = record_type(true);
+        tds.read(recs.data(), recType, H5S_ALL, H5S_ALL);
+
+        bool moved = false;
+        for (PropertyRecord &rec : recs) {
+            if (static_cast<DataType>(rec.data_type) == dtype && rec.offset >= offset + count) {
+                rec.offset -= count;
+                moved = true;
+            }
+        }
+
+        if (moved) {
+            tds.write(recs.data(), recType, H5S_ALL, H5S_ALL);
+        }
+        tds.vlenReclaim(recType, recs.data());
+    }
+
+    ds.setExtent({heap_size - count});
+}
+
+} // ns nix::hdf5
+} // ns nix
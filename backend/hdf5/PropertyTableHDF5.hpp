@@ -0,0 +1,138 @@
+// Copyright (c) 2013, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_PROPERTY_TABLE_HDF5_H
+#define NIX_PROPERTY_TABLE_HDF5_H
+
+#include <nix/DataType.hpp>
+#include <nix/NDSize.hpp>
+
+#include "h5x/H5Group.hpp"
+
+#include <boost/optional.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <ctime>
+
+namespace nix {
+namespace hdf5 {
+
+/**
+ * @brief Compact storage of all the properties of a single section.
+ *
+ * Instead of one dataset with a set of attributes per property, all
+ * properties of a section are stored as rows of one compound dataset
+ * ("property_table") inside the section group. The values of all
+ * properties are kept in one extendible dataset per data type inside
+ * the "property_values" group (the values heap); each row references
+ * its values by offset and count into the heap of its data type.
+ *
+ * The heaps have no gaps: values that shrink keep their slot, values
+ * that grow are moved to the end of the heap, and the space they leave
+ * behind, like that of deleted properties, is closed by moving the
+ * following values down.
+ *
+ * The names and ids of the rows are read once and kept up to date by
+ * the table; copies of a table share them. The table therefore has to
+ * be the only writer of its section, see SectionHDF5.
+ *
+ * This layout is used by files with format version 1.2, i.e. files
+ * created with {@link nix::OpenFlags::PropertyTables}.
+ */
+class PropertyTableHDF5 {
+
+public:
+
+    struct Row {
+        std::string                  name;
+        std::string                  id;
+        time_t                       created_at;
+        time_t                       updated_at;
+        boost::optional<std::string> definition;
+        boost::optional<std::string> unit;
+        boost::optional<double>      uncertainty;
+        DataType                     dtype;
+        ndsize_t                     offset;
+        ndsize_t                     count;
+    };
+
+private:
+
+    struct Key {
+        std::string name;
+        std::string id;
+    };
+
+    // names and ids of the rows, shared by all copies of the table
+    struct Index {
+        bool                                       loaded = false;
+        std::vector<Key>                           keys;
+        // name or id -> first row with it
+        std::unordered_map<std::string, ndsize_t>  rows;
+    };
+
+    H5Group                 group;
+    std::shared_ptr<Index>  key_cache;
+
+public:
+
+    explicit PropertyTableHDF5(const H5Group &section_group);
+
+
+    ndsize_t rowCount() const;
+
+
+    boost::optional<ndsize_t> findRow(const std::string &name_or_id) const;
+
+
+    std::string rowId(ndsize_t index) const;
+
+
+    Row readRow(ndsize_t index) const;
+
+
+    void writeRow(ndsize_t index, const Row &row);
+
+
+    ndsize_t appendRow(const Row &row);
+
+
+    void removeRow(ndsize_t index);
+
+
+    void readValues(const Row &row, DataType dtype, void *data, ndsize_t count) const;
+
+    /**
+     * @brief Write the values of a property to the values heap.
+     *
+     * Updates offset and count of the row, the caller has to write
+     * the row back to the table.
+     */
+    void writeValues(Row &row, DataType dtype, const void *data, ndsize_t count);
+
+private:
+
+    boost::optional<DataSet> table(bool create = false) const;
+
+    boost::optional<DataSet> heap(DataType dtype, bool create = false) const;
+
+    Index &keys() const;
+
+    // remove count values at offset from the heap of dtype
+    void releaseValues(DataType dtype, ndsize_t offset, ndsize_t count);
+
+};
+
+
+} // namespace hdf5
+} // namespace nix
+
+#endif // NIX_PROPERTY_TABLE_HDF5_H
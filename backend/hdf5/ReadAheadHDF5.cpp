@@ -0,0 +1,242 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include "ReadAheadHDF5.hpp"
+#include "FileHDF5.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace nix {
+namespace hdf5 {
+
+struct ReadAheadHDF5::Region {
+    DataType dtype;
+    h5x::DataType mem_type;
+    NDSize count;
+    NDSize offset;
+    size_t axis;
+    std::vector<char> bytes;
+    std::thread thread;
+    bool fetched;
+    bool failed;
+
+    ~Region() {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+};
+
+
+ReadAheadHDF5::ReadAheadHDF5(const DataSet &ds, size_t max_bytes)
+    : ds(ds), max_bytes(max_bytes), background(FileHDF5::libraryThreadSafe()), last_dtype(DataType::Nothing)
+{
+    hid_t plist = H5Dget_create_plist(ds.h5id());
+    if (plist >= 0 && H5Pget_layout(plist) == H5D_CHUNKED) {
+        NDSize dims(ds.size().size());
+        if (H5Pget_chunk(plist, static_cast<int>(dims.size()), dims.data()) == static_cast<int>(dims.size())) {
+            chunks = dims;
+        }
+    }
+    if (plist >= 0) {
+        H5Pclose(plist);
+    }
+}
+
+
+size_t ReadAheadHDF5::maxBytes() const {
+    return max_bytes;
+}
+
+
+void ReadAheadHDF5::maxBytes(size_t max_bytes) {
+    clear();
+    this->max_bytes = max_bytes;
+}
+
+
+bool ReadAheadHDF5::read(DataType dtype, void *data, const NDSize &count, const NDSize &offset) {
+    if (dtype == DataType::String || count.size() == 0 || count.size() != offset.size()) {
+        return false;
+    }
+
+    // the one axis along which this read continues the last one, if any
+    size_t axis = count.size();
+    bool sequential = dtype == last_dtype && count == last_count && offset.size() == last_offset.size();
+    for (size_t i = 0; sequential && i < count.size(); i++) {
+        if (offset[i] == last_offset[i]) {
+            continue;
+        }
+        sequential = axis == count.size() && offset[i] == last_offset[i] + last_count[i];
+        axis = i;
+    }
+    sequential = sequential && axis < count.size();
+    last_dtype = dtype;
+    last_count = count;
+    last_offset = offset;
+
+    if (next && contains(*next, dtype, count, offset)) {
+        wait(*next);
+        current = std::move(next);
+    }
+
+    if (current && contains(*current, dtype, count, offset)) {
+        if (!next) {
+            schedule(dtype, current->count, current->offset, current->axis,
+                     current->offset[current->axis] + current->count[current->axis]);
+        }
+        wait(*current);
+        if (!current->failed) {
+            copy(*current, data, count, offset);
+            return true;
+        }
+    }
+
+    current.reset();
+    next.reset();
+    if (sequential) {
+        schedule(dtype, count, offset, axis, offset[axis] + count[axis]);
+    }
+    return false;
+}
+
+
+bool ReadAheadHDF5::contains(const Region &region, DataType dtype, const NDSize &count, const NDSize &offset) const {
+    if (dtype != region.dtype || count.size() != region.count.size() || offset.size() != region.offset.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < count.size(); i++) {
+        if (i == region.axis) {
+            if (offset[i] < region.offset[i] ||
+                offset[i] + count[i] > region.offset[i] + region.count[i]) {
+                return false;
+            }
+        } else if (count[i] != region.count[i] || offset[i] != region.offset[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void ReadAheadHDF5::copy(const Region &region, void *data, const NDSize &count, const NDSize &offset) const {
+    // the region is [outer, n, inner] around its axis; so is the read
+    const size_t axis = region.axis;
+    size_t outer = 1;
+    for (size_t i = 0; i < axis; i++) {
+        outer *= region.count[i];
+    }
+    size_t inner = data_type_to_size(region.dtype);
+    for (size_t i = axis + 1; i < region.count.size(); i++) {
+        inner *= region.count[i];
+    }
+
+    const size_t n = region.count[axis];
+    const size_t skip = offset[axis] - region.offset[axis];
+    const size_t len = count[axis] * inner;
+    char *dest = static_cast<char *>(data);
+    for (size_t o = 0; o < outer; o++) {
+        memcpy(dest + o * len, region.bytes.data() + (o * n + skip) * inner, len);
+    }
+}
+
+
+void ReadAheadHDF5::schedule(DataType dtype, const NDSize &count, const NDSize &offset, size_t axis, ndsize_t start) {
+    const NDSize extent = ds.size();
+    if (extent.size() != count.size() || start >= extent[axis]) {
+        return;
+    }
+
+    // a region holds at least one read, reads larger than half of the
+    // buffer are not read ahead
+    const size_t slice = data_type_to_size(dtype) * (count.nelms() / count[axis]);
+    if (slice == 0 || slice * count[axis] > max_bytes / 2) {
+        return;
+    }
+    ndsize_t end = start + max_bytes / 2 / slice;
+    if (chunks.size() == count.size() && chunks[axis] > 0) {
+        ndsize_t aligned = end / chunks[axis] * chunks[axis];
+        if (aligned >= start + count[axis]) {
+            end = aligned;
+        }
+    }
+    end = std::min(end, extent[axis]);
+
+    std::unique_ptr<Region> region(new Region());
+    region->dtype = dtype;
+    region->mem_type = data_type_to_h5_memtype(dtype);
+    region->count = count;
+    region->count[axis] = end - start;
+    region->offset = offset;
+    region->offset[axis] = start;
+    region->axis = axis;
+    region->bytes.resize(slice * region->count[axis]);
+    region->fetched = false;
+    region->failed = false;
+
+    if (background) {
+        region->thread = std::thread(fetch, ds.h5id(), region.get());
+        region->fetched = true;
+    }
+    next = std::move(region);
+}
+
+
+void ReadAheadHDF5::wait(Region &region) {
+    if (region.thread.joinable()) {
+        region.thread.join();
+    }
+    if (!region.fetched) {
+        fetch(ds.h5id(), &region);
+        region.fetched = true;
+    }
+}
+
+
+// only plain HDF5 calls here: the handle wrappers would take the backend
+// lock, which the reading thread may hold while it waits for the fetch
+void ReadAheadHDF5::fetch(hid_t ds, Region *region) {
+    const int rank = static_cast<int>(region->count.size());
+    herr_t status = -1;
+
+    H5E_BEGIN_TRY {
+        hid_t file_space = H5Dget_space(ds);
+        hid_t mem_space = H5Screate_simple(rank, region->count.data(), nullptr);
+        if (file_space >= 0 && mem_space >= 0 &&
+            H5Sselect_hyperslab(file_space, H5S_SELECT_SET, region->offset.data(), nullptr,
+                                region->count.data(), nullptr) >= 0) {
+            status = H5Dread(ds, region->mem_type.h5id(), mem_space, file_space, H5P_DEFAULT,
+                             region->bytes.data());
+        }
+        if (mem_space >= 0) {
+            H5Sclose(mem_space);
+        }
+        if (file_space >= 0) {
+            H5Sclose(file_space);
+        }
+    } H5E_END_TRY;
+
+    // a failed fetch is read again directly, which reports the error
+    region->failed = status < 0;
+}
+
+
+void ReadAheadHDF5::clear() {
+    current.reset();
+    next.reset();
+    last_dtype = DataType::Nothing;
+}
+
+
+ReadAheadHDF5::~ReadAheadHDF5() {
+    clear();
+}
+
+} // namespace hdf5
+} // namespace nix
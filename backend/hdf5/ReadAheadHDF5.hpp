@@ -0,0 +1,101 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_READ_AHEAD_HDF5_H
+#define NIX_READ_AHEAD_HDF5_H
+
+#include <nix/DataType.hpp>
+#include <nix/NDSize.hpp>
+
+#include "h5x/H5DataSet.hpp"
+#include "h5x/H5DataType.hpp"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace nix {
+namespace hdf5 {
+
+/**
+ * @brief Read-ahead buffer for sequential reads of the data of a DataArray.
+ *
+ * Two reads of the same shape, where the second one continues the first
+ * along one axis, count as sequential access along that axis. The region
+ * following the second read is then fetched in the background, as large as
+ * half of the buffer and ending at a chunk boundary where possible, and the
+ * next reads are served from it. While one region is being read from, the
+ * one after it is fetched. Reads larger than half of the buffer are not
+ * read ahead, so the two regions never exceed the buffer.
+ *
+ * The regions are fetched on a thread of their own only if the HDF5 library
+ * is thread safe, otherwise when the first read needs them. Strings are
+ * never buffered.
+ *
+ * The owner has to call clear() whenever the data set is written to or its
+ * extent changes.
+ */
+class ReadAheadHDF5 {
+
+public:
+
+    /**
+     * @param ds          The data set the buffer reads from.
+     * @param max_bytes   The size of the buffer.
+     */
+    ReadAheadHDF5(const DataSet &ds, size_t max_bytes);
+
+    size_t maxBytes() const;
+
+    void maxBytes(size_t max_bytes);
+
+    /**
+     * @brief Serve a read from the buffer.
+     *
+     * @return False if the data has to be read directly.
+     */
+    bool read(DataType dtype, void *data, const NDSize &count, const NDSize &offset);
+
+    /**
+     * @brief Drop all buffered data; waits for a running fetch.
+     */
+    void clear();
+
+    ~ReadAheadHDF5();
+
+private:
+
+    struct Region;
+
+    bool contains(const Region &region, DataType dtype, const NDSize &count, const NDSize &offset) const;
+
+    void copy(const Region &region, void *data, const NDSize &count, const NDSize &offset) const;
+
+    void schedule(DataType dtype, const NDSize &count, const NDSize &offset, size_t axis, ndsize_t start);
+
+    void wait(Region &region);
+
+    static void fetch(hid_t ds, Region *region);
+
+    DataSet ds;
+    size_t max_bytes;
+    bool background;
+    NDSize chunks;
+
+    DataType last_dtype;
+    NDSize last_count;
+    NDSize last_offset;
+
+    std::unique_ptr<Region> current;
+    std::unique_ptr<Region> next;
+};
+
+} // namespace hdf5
+} // namespace nix
+
+#endif // NIX_READ_AHEAD_HDF5_H
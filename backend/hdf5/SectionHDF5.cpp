@@ -14,6 +14,8 @@
 #include <nix/Section.hpp>
 
 #include "PropertyHDF5.hpp"
+#include "PropertyRowHDF5.hpp"
+#include "FileHDF5.hpp"
 
 using namespace std;
 using namespace nix::base;
@@ -33,6 +35,9 @@ SectionHDF5::SectionHDF5(const std::shared_ptr<base::IFile> &file, const std::sh
 {
     property_group = this->group().openOptGroup("properties");
     section_group = this->group().openOptGroup("sections");
+    if (file_has_feature(file, OpenFlags::PropertyTables)) {
+        property_table = PropertyTableHDF5(this->group());
+    }
 }
 
 
@@ -63,6 +68,9 @@ SectionHDF5::SectionHDF5(const shared_ptr<IFile> &file, const shared_ptr<ISectio
 {
     property_group = this->group().openOptGroup("properties");
     section_group = this->group().openOptGroup("sections");
+    if (file_has_feature(file, OpenFlags::PropertyTables)) {
+        property_table = PropertyTableHDF5(this->group());
+    }
 }
 
 //--------------------------------------------------
@@ -167,7 +175,9 @@ shared_ptr<ISection> SectionHDF5::getSection(const string &name_or_id) const {
         boost::optional<H5Group> group = g->findGroupByNameOrAttribute("entity_id", name_or_id);
         if (group) {
             auto p = const_pointer_cast<SectionHDF5>(shared_from_this());
-            section = make_shared<SectionHDF5>(file(), p, *group);
+            section = dynamic_pointer_cast<FileHDF5>(file())->entity<SectionHDF5>(*group, [this, &p, &group] {
+                return make_shared<SectionHDF5>(file(), p, *group);
+            });
         }
     }
 
@@ -188,7 +198,9 @@ shared_ptr<ISection> SectionHDF5::createSection(const string &name, const string
 
     auto p = const_pointer_cast<SectionHDF5>(shared_from_this());
     H5Group grp = g->openGroup(name, true);
-    return make_shared<SectionHDF5>(file(), p, grp, new_id, type, name);
+    shared_ptr<SectionHDF5> section = make_shared<SectionHDF5>(file(), p, grp, new_id, type, name);
+    dynamic_pointer_cast<FileHDF5>(file())->addEntity(grp, section);
+    return section;
 }
 
 
@@ -220,6 +232,10 @@ bool SectionHDF5::deleteSection(const string &name_or_id) {
 
 
 ndsize_t SectionHDF5::propertyCount() const {
+    if (property_table) {
+        return property_table->rowCount();
+    }
+
     boost::optional<H5Group> g = property_group();
     return g ? g->objectCount() : size_t(0);
 }
@@ -231,6 +247,17 @@ bool SectionHDF5::hasProperty(const string &name_or_id) const {
 
 
 shared_ptr<IProperty> SectionHDF5::getProperty(const string &name_or_id) const {
+    if (property_table) {
+        shared_ptr<PropertyRowHDF5> prop;
+        boost::optional<ndsize_t> index = property_table->findRow(name_or_id);
+        if (index) {
+            string id = property_table->rowId(*index);
+            auto self = const_pointer_cast<SectionHDF5>(shared_from_this());
+            prop = make_shared<PropertyRowHDF5>(file(), self, *property_table, id, *index);
+        }
+        return prop;
+    }
+
     shared_ptr<PropertyHDF5> prop;
     boost::optional<H5Group> g = property_group();
 
@@ -245,6 +272,12 @@ shared_ptr<IProperty> SectionHDF5::getProperty(const string &name_or_id) const {
 
 
 shared_ptr<IProperty> SectionHDF5::getProperty(ndsize_t index) const {
+    if (property_table) {
+        string id = property_table->rowId(index);
+        auto self = const_pointer_cast<SectionHDF5>(shared_from_this());
+        return make_shared<PropertyRowHDF5>(file(), self, *property_table, id, index);
+    }
+
     boost::optional<H5Group> g = property_group();
     string name = g ? g->objectName(index) : "";
     return getProperty(name);
@@ -253,6 +286,17 @@ shared_ptr<IProperty> SectionHDF5::getProperty(ndsize_t index) const {
 
 shared_ptr<IProperty> SectionHDF5::createProperty(const string &name, const DataType &dtype) {
     string new_id = util::createId();
+
+    if (property_table) {
+        if (name.empty()) {
+            throw EmptyString("name");
+        }
+        time_t now = util::getTime();
+        PropertyTableHDF5::Row row{name, new_id, now, now, boost::none, boost::none, boost::none, dtype, 0, 0};
+        ndsize_t index = property_table->appendRow(row);
+        return make_shared<PropertyRowHDF5>(file(), shared_from_this(), *property_table, new_id, index);
+    }
+
     boost::optional<H5Group> g = property_group(true);
     DataSet ds = g->createData(name, data_type_to_h5_filetype(dtype), {0});
     return make_shared<PropertyHDF5>(file(), ds, new_id, name);
@@ -275,6 +319,14 @@ shared_ptr<IProperty> SectionHDF5::createProperty(const string &name, const vect
 
 
 bool SectionHDF5::deleteProperty(const string &name_or_id) {
+    if (property_table) {
+        boost::optional<ndsize_t> index = property_table->findRow(name_or_id);
+        if (index) {
+            property_table->removeRow(*index);
+        }
+        return static_cast<bool>(index);
+    }
+
     boost::optional<H5Group> g = property_group();
     bool deleted = false;
     if (g && hasProperty(name_or_id)) {
@@ -10,6 +10,7 @@
 #define NIX_SECTION_HDF5_H
 
 #include "NamedEntityHDF5.hpp"
+#include "PropertyTableHDF5.hpp"
 #include <nix/base/ISection.hpp>
 #include <nix/Section.hpp>
 
@@ -27,6 +28,8 @@ private:
     // TODO: consider writing parent_section as soft link into file
     std::shared_ptr<base::ISection> parent_section;
     optGroup property_group, section_group;
+    // set for files that store properties in tables, cf. OpenFlags::PropertyTables
+    boost::optional<PropertyTableHDF5> property_table;
 
 public:
 
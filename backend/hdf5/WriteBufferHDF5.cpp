@@ -0,0 +1,151 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include "WriteBufferHDF5.hpp"
+
+#include <nix/Exception.hpp>
+
+#include <cstring>
+
+namespace nix {
+namespace hdf5 {
+
+
+WriteBufferHDF5::WriteBufferHDF5(const DataSet &ds, size_t max_bytes)
+    : ds(ds), max_bytes(max_bytes), ds_extent(ds.size()), dtype(DataType::Nothing)
+{
+}
+
+
+size_t WriteBufferHDF5::maxBytes() const {
+    return max_bytes;
+}
+
+
+void WriteBufferHDF5::maxBytes(size_t max_bytes) {
+    if (bytes.size() > max_bytes) {
+        flush();
+    }
+    this->max_bytes = max_bytes;
+}
+
+
+bool WriteBufferHDF5::continues(DataType dtype, const NDSize &count, const NDSize &offset) const {
+    if (dtype != this->dtype || count.size() != this->count.size()) {
+        return false;
+    }
+    for (size_t i = 1; i < count.size(); i++) {
+        if (count[i] != this->count[i] || offset[i] != this->offset[i]) {
+            return false;
+        }
+    }
+    return offset[0] == this->offset[0] + this->count[0];
+}
+
+
+// the first dimension in which the region exceeds extent, extent.size() if none
+static size_t exceeds(const NDSize &extent, const NDSize &count, const NDSize &offset) {
+    for (size_t i = 0; i < extent.size(); i++) {
+        if (offset[i] + count[i] > extent[i]) {
+            return i;
+        }
+    }
+    return extent.size();
+}
+
+
+bool WriteBufferHDF5::write(DataType dtype, const void *data, const NDSize &count, const NDSize &offset) {
+    const size_t n = data_type_to_size(dtype) * count.nelms();
+    const bool same_rank = count.size() == ds_extent.size() && offset.size() == count.size();
+
+    // out of bounds writes fail at once, before anything is buffered; the
+    // extent may have grown through another handle, so it is read again
+    if (same_rank && exceeds(ds_extent, count, offset) < count.size()) {
+        ds_extent = ds.size();
+        const size_t dim = exceeds(ds_extent, count, offset);
+        if (dim < count.size()) {
+            throw OutOfBounds("Write exceeds the data", dim);
+        }
+    }
+
+    const bool fits = dtype != DataType::String && count.size() > 0 && same_rank && n <= max_bytes;
+
+    if (!bytes.empty() && (!fits || !continues(dtype, count, offset) || bytes.size() + n > max_bytes)) {
+        flush();
+    }
+    if (!fits) {
+        return false;
+    }
+
+    if (bytes.empty()) {
+        this->dtype = dtype;
+        this->count = count;
+        this->offset = offset;
+    } else {
+        this->count[0] += count[0];
+    }
+    const char *ptr = static_cast<const char *>(data);
+    bytes.insert(bytes.end(), ptr, ptr + n);
+    return true;
+}
+
+
+void WriteBufferHDF5::flushOverlapping(const NDSize &count, const NDSize &offset) {
+    if (bytes.empty()) {
+        return;
+    }
+    if (count.size() != this->count.size() || offset.size() != this->offset.size()) {
+        flush();
+        return;
+    }
+    for (size_t i = 0; i < count.size(); i++) {
+        if (offset[i] >= this->offset[i] + this->count[i] || this->offset[i] >= offset[i] + count[i]) {
+            return;
+        }
+    }
+    flush();
+}
+
+
+void WriteBufferHDF5::extent(const NDSize &extent) {
+    bool inside = extent.size() == ds_extent.size();
+    for (size_t i = 0; inside && !bytes.empty() && i < extent.size(); i++) {
+        inside = offset[i] + count[i] <= extent[i];
+    }
+    if (!inside) {
+        flush();
+    }
+    ds_extent = extent;
+}
+
+
+void WriteBufferHDF5::flush() {
+    if (bytes.empty()) {
+        return;
+    }
+
+    std::vector<char> data;
+    data.swap(bytes);
+    h5x::DataType memType = data_type_to_h5_memtype(dtype);
+    ds.write(data.data(), memType, count, offset);
+    // keep the memory for the next writes
+    data.clear();
+    bytes.swap(data);
+}
+
+
+WriteBufferHDF5::~WriteBufferHDF5() {
+    try {
+        flush();
+    } catch (...) {
+        // nothing sensible to do in a destructor
+    }
+}
+
+} // namespace hdf5
+} // namespace nix
@@ -0,0 +1,90 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_WRITE_BUFFER_HDF5_H
+#define NIX_WRITE_BUFFER_HDF5_H
+
+#include <nix/DataType.hpp>
+#include <nix/NDSize.hpp>
+
+#include "h5x/H5DataSet.hpp"
+
+#include <vector>
+
+namespace nix {
+namespace hdf5 {
+
+/**
+ * @brief Write-back buffer for small writes to the data of a DataArray.
+ *
+ * Writes that continue the buffered region along the first dimension and
+ * match it in all others are collected in memory and written with a single
+ * H5Dwrite once the buffer is full or a write does not fit in. Strings are
+ * never buffered, since the buffer cannot own them.
+ *
+ * The owner has to call flush() before the data is read from the data set
+ * (flushOverlapping()) and before the data set shrinks (extent()).
+ */
+class WriteBufferHDF5 {
+
+public:
+
+    /**
+     * @param ds          The data set the buffer writes to.
+     * @param max_bytes   The size of the buffer.
+     */
+    WriteBufferHDF5(const DataSet &ds, size_t max_bytes);
+
+    size_t maxBytes() const;
+
+    void maxBytes(size_t max_bytes);
+
+    /**
+     * @brief Take a write into the buffer.
+     *
+     * @return False if the data has to be written directly; the buffered
+     *         data is flushed before in that case. Writes outside of the
+     *         data set throw OutOfBounds.
+     */
+    bool write(DataType dtype, const void *data, const NDSize &count, const NDSize &offset);
+
+    /**
+     * @brief Flush if the buffered region overlaps the given one.
+     */
+    void flushOverlapping(const NDSize &count, const NDSize &offset);
+
+    /**
+     * @brief Set the extent the data set will have; flushes if the buffered
+     *        region would not fit.
+     */
+    void extent(const NDSize &extent);
+
+    /**
+     * @brief Write the buffered data to the data set.
+     */
+    void flush();
+
+    ~WriteBufferHDF5();
+
+private:
+
+    bool continues(DataType dtype, const NDSize &count, const NDSize &offset) const;
+
+    DataSet ds;
+    size_t max_bytes;
+    NDSize ds_extent;
+    DataType dtype;
+    NDSize count;
+    NDSize offset;
+    std::vector<char> bytes;
+};
+
+} // namespace hdf5
+} // namespace nix
+
+#endif // NIX_WRITE_BUFFER_HDF5_H
@@ -52,6 +52,13 @@ void Attribute::write(h5x::DataType mem_type, const NDSize &size, const std::str
 }
 
 
+h5x::DataType Attribute::dataType() const {
+    h5x::DataType ftype = H5Aget_type(hid);
+    ftype.check("Attribute::dataType(): H5Aget_type failed");
+    return ftype;
+}
+
+
 DataSpace Attribute::getSpace() const {
 
     DataSpace space = H5Aget_space(hid);
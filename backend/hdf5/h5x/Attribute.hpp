@@ -34,6 +34,8 @@ public:
     DataSpace getSpace() const;
     NDSize extent() const;
 
+    h5x::DataType dataType() const;
+
     Attribute &operator=(const Attribute &other) {
         H5Object::operator=(other);
         return *this;
@@ -31,6 +31,13 @@ void DataSet::read(void *data, const h5x::DataType &memType, const DataSpace &me
     res.check("DataSet::read() IO error");
 }
 
+void DataSet::read(StringWriter &writer, const h5x::DataType &memType, const DataSpace &memSpace, const DataSpace &fileSpace) const
+{
+    HErr res = H5Dread(hid, memType.h5id(), memSpace.h5id(), fileSpace.h5id(), writer.xfer(), *writer);
+    res.check("DataSet::read() IO error");
+    writer.finish();
+}
+
 void DataSet::write(const void *data, const h5x::DataType &memType, const DataSpace &memSpace, const DataSpace &fileSpace)
 {
     HErr res = H5Dwrite(hid, memType.h5id(), memSpace.h5id(), fileSpace.h5id(), H5P_DEFAULT, data);
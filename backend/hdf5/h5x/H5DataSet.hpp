@@ -38,6 +38,12 @@ public:
     void write(const void *data, const h5x::DataType &memType, const DataSpace &memSpace, const DataSpace &fileSpace);
 
     void read(void *data, h5x::DataType memType, const NDSize &count, const NDSize &offset=NDSize{}) const;
+
+    /**
+     * Read variable length strings into the arena of writer, see
+     * StringWriter; finishes the writer.
+     */
+    void read(StringWriter &writer, const h5x::DataType &memType, const DataSpace &memSpace, const DataSpace &fileSpace) const;
     void write(const void *data, h5x::DataType memType, const NDSize &count, const NDSize &offset=NDSize{});
 
     template<typename T> void read(T &value, bool resize = false) const;
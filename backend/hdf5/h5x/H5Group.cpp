@@ -174,6 +174,30 @@ std::string H5Group::objectName(ndsize_t index) const {
 }
 
 
+static herr_t collect_link_names(hid_t group, const char *name, const H5L_info_t *info, void *op_data) {
+    std::vector<std::string> *names = static_cast<std::vector<std::string> *>(op_data);
+    names->emplace_back(name);
+    return 0;
+}
+
+
+std::vector<std::string> H5Group::objectNames() const {
+    std::vector<std::string> names;
+    hsize_t idx = 0;
+
+    // same index fallback as objectName()
+    herr_t res = H5Literate(hid, H5_INDEX_CRT_ORDER, H5_ITER_INC, &idx, collect_link_names, &names);
+    if (res < 0) {
+        names.clear();
+        idx = 0;
+        HErr err = H5Literate(hid, H5_INDEX_NAME, H5_ITER_NATIVE, &idx, collect_link_names, &names);
+        err.check("H5Group::objectNames(): H5Literate failed");
+    }
+
+    return names;
+}
+
+
 bool H5Group::hasData(const std::string &name) const {
     return hasObject(name) && objectOfType(name, H5O_TYPE_DATASET);
 }
@@ -45,6 +45,14 @@ public:
     ndsize_t objectCount() const;
     std::string objectName(ndsize_t index) const;
 
+    /**
+     * @brief Get the names of all objects in the group in a single
+     *        iteration, in the same order as {@link objectName}.
+     *
+     * @return The names of all objects in the group.
+     */
+    std::vector<std::string> objectNames() const;
+
     bool hasData(const std::string &name) const;
 
     DataSet createData(const std::string &name, const h5x::DataType &fileType,
@@ -241,9 +249,7 @@ bool H5Group::getData(const std::string &name, T &value) const
     void *data = hydra.data();
     if (dtype == DataType::String) {
         StringWriter writer(shape, data);
-        ds.read(*writer, memType, memSpace, fileSpace);
-        writer.finish();
-        ds.vlenReclaim(memType.h5id(), *writer, &memSpace);
+        ds.read(writer, memType, memSpace, fileSpace);
     } else {
         ds.read(data, memType, memSpace, fileSpace);
     }
@@ -9,11 +9,72 @@
 #include "H5Object.hpp"
 #include "H5Exception.hpp"
 
+#include <nix/Threading.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
 
 namespace nix {
 namespace hdf5 {
 
 
+hid_t StringWriter::xfer() {
+    if (plist == H5I_INVALID_HID) {
+        hid_t id = H5Pcreate(H5P_DATASET_XFER);
+        if (id < 0) {
+            throw H5Exception("StringWriter::xfer(): Could not create transfer property list");
+        }
+        HErr status = H5Pset_vlen_mem_manager(id, arenaAlloc, this, arenaFree, this);
+        if (status.isError()) {
+            H5Pclose(id);
+            status.check("StringWriter::xfer(): Could not set memory manager");
+        }
+        plist = id;
+    }
+    return plist;
+}
+
+
+void *StringWriter::arenaAlloc(size_t size, void *info) {
+    StringWriter *writer = static_cast<StringWriter *>(info);
+    // keep every allocation aligned, HDF5 may also store sequences here
+    const size_t align = sizeof(std::max_align_t);
+    size = (std::max<size_t>(size, 1) + align - 1) / align * align;
+
+    if (size > writer->left) {
+        size_t n = std::max(size, writer->block_size);
+        writer->blocks.emplace_back(new (std::nothrow) char[n]);
+        if (!writer->blocks.back()) {
+            writer->blocks.pop_back();
+            return nullptr;
+        }
+        writer->next = writer->blocks.back().get();
+        writer->left = n;
+        writer->block_size = std::min<size_t>(writer->block_size * 2, 1024 * 1024);
+    }
+
+    void *ptr = writer->next;
+    writer->next += size;
+    writer->left -= size;
+    return ptr;
+}
+
+
+void StringWriter::arenaFree(void *ptr, void *info) {
+    // released with the arena
+}
+
+
+StringWriter::~StringWriter() {
+    if (plist != H5I_INVALID_HID) {
+        H5Pclose(plist);
+    }
+    delete[] buffer;
+}
+
+
 H5Object::H5Object(const H5Object &other)
     : hid(other.hid)
 {
@@ -114,7 +175,10 @@ H5Object::~H5Object() {
 }
 
 
+// handles are also copied and released outside of calls made through
+// the front-end, e.g. when the last front-end object is destroyed
 void H5Object::inc() const {
+    base::BackendLock lock;
     if (H5Iis_valid(hid)) {
         H5Iinc_ref(hid);
     }
@@ -122,6 +186,7 @@ void H5Object::inc() const {
 
 
 void H5Object::dec() const {
+    base::BackendLock lock;
     if (H5Iis_valid(hid)) {
         H5Idec_ref(hid);
     }
@@ -17,13 +17,23 @@
 #include "H5Exception.hpp"
 
 #include <string>
+#include <memory>
+#include <vector>
 #include <boost/optional.hpp>
 
 namespace nix {
 namespace hdf5 {
 
 
-class StringWriter {
+/**
+ * Reads variable length strings into std::string values.
+ *
+ * Reads with the transfer property list of xfer() let HDF5 allocate the
+ * strings in an arena owned by the writer, which is released as a whole
+ * when the writer goes away, instead of one malloc() per string and an
+ * H5Dvlen_reclaim() afterwards; see DataSet::read(StringWriter &, ...).
+ */
+class NIXAPI StringWriter {
 public:
     typedef std::string  value_type;
     typedef value_type  *pointer;
@@ -34,7 +44,8 @@ public:
         : StringWriter(size, static_cast<pointer>(data)) { }
 
     StringWriter(const NDSize &size, pointer stringdata)
-            : nelms(size.nelms()), data(stringdata) {
+            : nelms(size.nelms()), data(stringdata), plist(H5I_INVALID_HID),
+              next(nullptr), left(0), block_size(4096) {
 		size_t bs = nix::check::fits_in_size_t(nelms,
                          "Cannot allocate storage (exceeds memory)");
         buffer = new data_type[bs];
@@ -44,20 +55,33 @@ public:
         return buffer;
     }
 
+    /**
+     * @brief Transfer property list that makes HDF5 allocate the strings
+     *        in the arena of the writer.
+     */
+    hid_t xfer();
+
     void finish() {
         for (ndsize_t i = 0; i < nelms; i++) {
-            data[i] = buffer[i];
+            data[i].assign(buffer[i] != nullptr ? buffer[i] : "");
         }
     }
 
-    ~StringWriter() {
-        delete[] buffer;
-    }
+    ~StringWriter();
 
 private:
+    static void *arenaAlloc(size_t size, void *info);
+    static void arenaFree(void *ptr, void *info);
+
     ndsize_t nelms;
     pointer  data;
     data_ptr buffer;
+
+    hid_t plist;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char   *next;
+    size_t  left;
+    size_t  block_size;
 };
 
 class StringReader {
@@ -138,6 +162,14 @@ public:
         }
     }
 
+    // literal messages are only turned into strings on failure, since the
+    // checks are on the path of every data access
+    void check(const char *msg_if_fail) {
+        if (type() == H5I_BADID) {
+            throw H5Exception(msg_if_fail);
+        }
+    }
+
     std::string name() const;
 
     H5I_type_t type() const;
@@ -181,6 +213,14 @@ struct NIXAPI HTri {
         return result();
     }
 
+    inline bool check(const char *msg) {
+        if (value < 0) {
+            throw H5Exception(msg);
+        }
+
+        return result();
+    }
+
     value_type value;
 };
 
@@ -206,6 +246,14 @@ struct NIXAPI HErr {
         return true;
     }
 
+    inline bool check(const char *msg) {
+        if (isError()) {
+            throw H5Error(value, msg);
+        }
+
+        return true;
+    }
+
     value_type value;
 };
 
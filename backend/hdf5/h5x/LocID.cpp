@@ -10,6 +10,8 @@
 
 #include "LocID.hpp"
 
+#include <nix/util/util.hpp>
+
 namespace nix {
 
 namespace hdf5 {
@@ -35,6 +37,42 @@ void LocID::removeAttr(const std::string &name) const {
 }
 
 
+bool LocID::getTimeAttr(const std::string &name, time_t &value) const {
+    if (!hasAttr(name)) {
+        return false;
+    }
+
+    Attribute attr = openAttr(name);
+    if (attr.dataType().class_t() == H5T_INTEGER) {
+        int64_t t;
+        attr.read(data_type_to_h5_memtype(DataType::Int64), attr.extent(), &t);
+        value = static_cast<time_t>(t);
+    } else {
+        std::string t;
+        attr.read(data_type_to_h5_memtype(DataType::String), attr.extent(), &t);
+        value = util::strToTime(t);
+    }
+
+    return true;
+}
+
+
+void LocID::setTimeAttr(const std::string &name, time_t value, bool as_int) const {
+    if (hasAttr(name)) {
+        bool is_int = openAttr(name).dataType().class_t() == H5T_INTEGER;
+        if (is_int != as_int) {
+            removeAttr(name);
+        }
+    }
+
+    if (as_int) {
+        setAttr(name, static_cast<int64_t>(value));
+    } else {
+        setAttr(name, util::timeToStr(value));
+    }
+}
+
+
 Attribute LocID::openAttr(const std::string &name) const {
     Attribute attr = H5Aopen(hid, name.c_str(), H5P_DEFAULT);
     attr.check("LocID::openAttr: Could not open attribute " + name);
@@ -61,6 +99,18 @@ unsigned int LocID::referenceCount() const {
     res.check("LocID:referenceCount: Coud not get object info");
     return oInfo.rc;
 }
+
+
+haddr_t LocID::address() const {
+    H5O_info_t oInfo;
+#if H5_VERSION_GE(1, 10, 3)
+    HErr res = H5Oget_info2(hid, &oInfo, H5O_INFO_BASIC);
+#else
+    HErr res = H5Oget_info(hid, &oInfo);
+#endif
+    res.check("LocID::address: Could not get object info");
+    return oInfo.addr;
+}
 } // nix::hdf5
 
 } // nix::
\ No newline at end of file
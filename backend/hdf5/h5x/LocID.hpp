@@ -16,6 +16,8 @@
 #include <nix/Hydra.hpp>
 #include "H5DataType.hpp"
 
+#include <ctime>
+
 namespace nix {
 namespace hdf5 {
 
@@ -38,10 +40,28 @@ public:
     template <typename T>
     bool getAttr(const std::string &name, T &value) const;
 
+    /**
+     * @brief Read a time stamp attribute that is either stored as
+     *        64-bit integer or in the (legacy) string form.
+     */
+    bool getTimeAttr(const std::string &name, time_t &value) const;
+
+    /**
+     * @brief Write a time stamp attribute as 64-bit integer or as string.
+     *        An existing attribute of the other form gets replaced.
+     */
+    void setTimeAttr(const std::string &name, time_t value, bool as_int) const;
+
     void deleteLink(std::string name, hid_t plist = H5L_SAME_LOC);
 
     unsigned int referenceCount() const;
 
+    /**
+     * @brief The address of the object in the file, which identifies it
+     *        whatever link it was opened by.
+     */
+    haddr_t address() const;
+
     LocID &operator=(const LocID &other) {
         H5Object::operator= (other);
         return *this;
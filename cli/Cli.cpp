@@ -27,6 +27,8 @@ namespace po = boost::program_options;
 #include <modules/IModule.hpp>
 #include <modules/Validate.hpp>
 #include <modules/Dump.hpp>
+#include <modules/Csv.hpp>
+#include <modules/Convert.hpp>
 
 namespace cli {
 
@@ -41,7 +43,9 @@ std::ostream& operator<<(std::ostream& os, const std::vector<T>& v)
 // define all module types
 std::unordered_map<std::string, std::shared_ptr<cli::module::IModule>> modules = {
     {std::string(cli::module::Validate::module_name), std::shared_ptr<cli::module::IModule>(new cli::module::Validate())},
-    {std::string(cli::module::Dump::module_name), std::shared_ptr<cli::module::IModule>(new cli::module::Dump())}
+    {std::string(cli::module::Dump::module_name), std::shared_ptr<cli::module::IModule>(new cli::module::Dump())},
+    {std::string(cli::module::Csv::module_name), std::shared_ptr<cli::module::IModule>(new cli::module::Csv())},
+    {std::string(cli::module::Convert::module_name), std::shared_ptr<cli::module::IModule>(new cli::module::Convert())}
 };
 
 } // namespace cli
@@ -102,7 +106,9 @@ int main(int argc, char* argv[]) {
         auto it = cli::modules.find(name);
         if (it != cli::modules.end()) {
             (*it).second->load(desc);    
-            // process the cmd line input
+            // process the cmd line input; start over, the values of
+            // module options were taken as input files above
+            vm.clear();
             po::store(parser3.options(desc).positional(pdesc).run(), vm);
             po::notify(vm);
             out << (*it).second->call(vm, desc);
@@ -113,7 +119,8 @@ int main(int argc, char* argv[]) {
             out << std::endl << "Nix command line tool " << std::endl;
             out << "\tNix version: " << myVersion << std::endl << std::endl;
             out << "\tUse the modules of this tool to dump nix-file contents as yaml to std out\n";
-            out << "\tor validate the nix file to detect structural and/or logical errors.\n\n";
+            out << "\tor validate the nix file to detect structural and/or logical errors.\n";
+            out << "\tData frames can be imported from and exported to delimited text (csv).\n\n";
             out << "\tUsage: ./nix-tool module [--help] [[module args] input-file] \n\n";
             out << desc << std::endl;
         }
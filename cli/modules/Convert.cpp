@@ -0,0 +1,95 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include <Cli.hpp>
+#include <modules/Convert.hpp>
+#include <nix/util/convert.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+namespace cli {
+namespace module {
+
+const char* Convert::module_name = "convert";
+
+void Convert::load(po::options_description &desc) const {
+    desc.add(po::options_description("nix-tool " + std::string(module_name) + ":\n\n\t" +
+                                     "Copies a nix file with all its contents into a new file, e.g. of another backend.\n\t" +
+                                     "Usage: nix-tool convert [options] source-file destination-file\n\nSupported options"));
+    po::options_description opt;
+    opt.add_options()
+        (BACKEND_OPTION, po::value<std::string>()->default_value("hdf5"), "backend of the new file: hdf5 or file")
+        (COMPRESSION_OPTION, po::value<std::string>()->default_value("none"), "compression of the data: none or deflate")
+        (BLOCK_BYTES_OPTION, po::value<size_t>()->default_value(8 * 1024 * 1024), "number of bytes of data copied at a time")
+        (SERIAL_OPTION, "do not read and write data at the same time")
+    ;
+    desc.add(opt);
+}
+
+
+std::string Convert::call(const po::variables_map &vm, const po::options_description &desc) {
+    std::stringstream out;
+
+    // --help
+    if (vm.count(HELP_OPTION)) {
+        po::options_description temp;
+        load(temp);
+        out << temp << std::endl;
+        return out.str();
+    }
+
+    // --input-file
+    if (! vm.count(INPFILE_OPTION)) {
+        throw NoInputFile();
+    }
+
+    const std::vector<std::string> &inputs = vm[INPFILE_OPTION].as< std::vector<std::string> >();
+    if (inputs.size() != 2) {
+        throw std::invalid_argument("Convert needs a source file and a destination file");
+    }
+
+    nix::util::ConvertOptions opts;
+    opts.backend = vm[BACKEND_OPTION].as<std::string>();
+    opts.block_bytes = vm[BLOCK_BYTES_OPTION].as<size_t>();
+    opts.parallel = !vm.count(SERIAL_OPTION);
+
+    const std::string compression = vm[COMPRESSION_OPTION].as<std::string>();
+    if (compression == "deflate") {
+        opts.compression = nix::Compression::DeflateNormal;
+    } else if (compression == "none") {
+        opts.compression = nix::Compression::None;
+    } else {
+        throw std::invalid_argument("Compression must be 'none' or 'deflate'");
+    }
+
+    const std::string &source_path = inputs[0];
+    const std::string &destination_path = inputs[1];
+    if (!boost::filesystem::exists(source_path)) {
+        throw FileNotFound(source_path);
+    }
+
+    // the FS backend stores a file as a directory
+    const std::string source_backend = boost::filesystem::is_directory(source_path) ? "file" : "hdf5";
+    nix::File source = nix::File::open(source_path, nix::FileMode::ReadOnly, source_backend);
+    if (!source.isOpen()) {
+        throw FileNotOpen(source_path);
+    }
+
+    nix::File destination = nix::util::convertFile(source, destination_path, opts);
+    out << "copied " << source.blockCount() << " blocks and " << source.sectionCount()
+        << " sections into " << destination_path << " (" << opts.backend << ")" << std::endl;
+
+    destination.close();
+    source.close();
+    return out.str();
+}
+
+} // namespace module
+} // namespace cli
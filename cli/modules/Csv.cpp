@@ -0,0 +1,167 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include <Cli.hpp>
+#include <modules/Csv.hpp>
+#include <nix/util/csv.hpp>
+
+#include <fstream>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+namespace cli {
+namespace module {
+
+const char* Csv::module_name = "csv";
+
+void Csv::load(po::options_description &desc) const {
+    desc.add(po::options_description("nix-tool " + std::string(module_name) + ":\n\n\t" +
+                                     "Imports delimited text (CSV, TSV) into a data frame or exports a data frame.\n\t" +
+                                     "Import: nix-tool csv [options] text-file nix-file\n\t" +
+                                     "Export: nix-tool csv --export [options] nix-file\n\nSupported options"));
+    po::options_description opt;
+    opt.add_options()
+        (EXPORT_OPTION, "export the data frame instead of importing")
+        (BLOCK_OPTION, po::value<std::string>(), "name or id of the block (created on import if missing)")
+        (FRAME_OPTION, po::value<std::string>(), "name or id of the data frame")
+        (OUTPUT_OPTION, po::value<std::string>(), "file to export to, default: standard output")
+        (DELIMITER_OPTION, po::value<std::string>()->default_value(","), "field delimiter, 'tab' for TSV")
+        (DTYPES_OPTION, po::value<std::string>(), "comma separated column types (e.g. Int64,Double,String), inferred if not given")
+        (NOHEADER_OPTION, "the text has no header line with the column names")
+        (BATCH_OPTION, po::value<size_t>()->default_value(8192), "number of rows read or written at a time")
+    ;
+    desc.add(opt);
+}
+
+
+static std::string required(const po::variables_map &vm, const char *option) {
+    if (!vm.count(option)) {
+        throw std::invalid_argument(std::string("Missing option --") + option);
+    }
+    return vm[option].as<std::string>();
+}
+
+
+static nix::util::CsvOptions csv_options(const po::variables_map &vm) {
+    nix::util::CsvOptions opts;
+
+    std::string delimiter = vm[DELIMITER_OPTION].as<std::string>();
+    if (delimiter == "tab" || delimiter == "\\t") {
+        opts.delimiter = '\t';
+    } else if (delimiter.size() == 1) {
+        opts.delimiter = delimiter[0];
+    } else {
+        throw std::invalid_argument("Delimiter must be a single character or 'tab'");
+    }
+
+    if (vm.count(DTYPES_OPTION)) {
+        std::vector<std::string> names;
+        boost::split(names, vm[DTYPES_OPTION].as<std::string>(), boost::is_any_of(","));
+        for (std::string &name : names) {
+            boost::trim(name);
+            opts.dtypes.push_back(nix::string_to_data_type(name));
+        }
+    }
+
+    opts.header = !vm.count(NOHEADER_OPTION);
+    opts.batch_rows = vm[BATCH_OPTION].as<size_t>();
+    return opts;
+}
+
+
+std::string Csv::call(const po::variables_map &vm, const po::options_description &desc) {
+    std::stringstream out;
+
+    // --help
+    if (vm.count(HELP_OPTION)) {
+        po::options_description temp;
+        load(temp);
+        out << temp << std::endl;
+        return out.str();
+    }
+
+    // --input-file
+    if (! vm.count(INPFILE_OPTION)) {
+        throw NoInputFile();
+    }
+
+    const std::vector<std::string> &inputs = vm[INPFILE_OPTION].as< std::vector<std::string> >();
+    const nix::util::CsvOptions opts = csv_options(vm);
+    const std::string block_name = required(vm, BLOCK_OPTION);
+    const std::string frame_name = required(vm, FRAME_OPTION);
+
+    if (vm.count(EXPORT_OPTION)) {
+        const std::string &file_path = inputs[0];
+        if (!boost::filesystem::exists(file_path)) {
+            throw FileNotFound(file_path);
+        }
+
+        nix::File file = nix::File::open(file_path, nix::FileMode::ReadOnly);
+        if (!file.isOpen()) {
+            throw FileNotOpen(file_path);
+        }
+
+        nix::Block block = file.getBlock(block_name);
+        if (!block) {
+            throw std::invalid_argument("No block " + block_name);
+        }
+        nix::DataFrame df = block.getDataFrame(frame_name);
+        if (!df) {
+            throw std::invalid_argument("No data frame " + frame_name);
+        }
+
+        // written directly, the text may be much larger than the memory
+        if (vm.count(OUTPUT_OPTION)) {
+            std::ofstream fout(vm[OUTPUT_OPTION].as<std::string>(), std::ios::binary);
+            nix::util::exportCsv(df, fout, opts);
+        } else {
+            nix::util::exportCsv(df, std::cout, opts);
+        }
+
+        return out.str();
+    }
+
+    if (inputs.size() != 2) {
+        throw std::invalid_argument("Import needs a text file and a nix file");
+    }
+
+    const std::string &text_path = inputs[0];
+    const std::string &file_path = inputs[1];
+    std::ifstream text(text_path, std::ios::binary);
+    if (!text) {
+        throw FileNotFound(text_path);
+    }
+
+    nix::FileMode mode = boost::filesystem::exists(file_path) ? nix::FileMode::ReadWrite : nix::FileMode::Overwrite;
+    nix::File file = nix::File::open(file_path, mode);
+    if (!file.isOpen()) {
+        throw FileNotOpen(file_path);
+    }
+
+    nix::Block block = file.getBlock(block_name);
+    if (!block) {
+        block = file.createBlock(block_name, "nix.csv");
+    }
+
+    nix::DataFrame df = block.getDataFrame(frame_name);
+    if (df) {
+        nix::ndsize_t n = nix::util::importCsv(df, text, opts);
+        out << "appended " << n << " rows to data frame " << df.name() << std::endl;
+    } else {
+        df = nix::util::importCsv(block, frame_name, "nix.csv", text, opts);
+        out << "imported " << df.rows() << " rows into data frame " << df.name() << std::endl;
+    }
+
+    file.close();
+    return out.str();
+}
+
+} // namespace module
+} // namespace cli
@@ -0,0 +1,50 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef CLI_CSV_H
+#define CLI_CSV_H
+
+#include <Cli.hpp>
+#include <modules/IModule.hpp>
+
+#include <iostream>
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+namespace cli {
+namespace module {
+
+const char *const EXPORT_OPTION = "export";
+const char *const BLOCK_OPTION = "block";
+const char *const FRAME_OPTION = "frame";
+const char *const OUTPUT_OPTION = "output";
+const char *const DELIMITER_OPTION = "delimiter";
+const char *const DTYPES_OPTION = "dtypes";
+const char *const NOHEADER_OPTION = "no-header";
+const char *const BATCH_OPTION = "batch-rows";
+
+class Csv : virtual public IModule {
+
+public:
+
+    static const char* module_name;
+
+    std::string name() const {
+        return std::string(module_name);
+    }
+
+    void load(po::options_description &desc) const;
+
+    std::string call(const po::variables_map &vm, const po::options_description &desc);
+
+};
+
+} // namespace module
+} // namespace cli
+
+#endif
@@ -13,7 +13,9 @@
 #include <nix/NDSize.hpp>
 #include <nix/Block.hpp>
 #include <nix/DataArray.hpp>
+#include <nix/MappedView.hpp>
 #include <nix/DataFrame.hpp>
+#include <nix/RowPredicate.hpp>
 #include <nix/MultiTag.hpp>
 #include <nix/Dimensions.hpp>
 #include <nix/File.hpp>
@@ -24,3 +26,5 @@
 #include <nix/Source.hpp>
 #include <nix/Value.hpp>
 #include <nix/Compression.hpp>
+#include <nix/Threading.hpp>
+#include <nix/FilePool.hpp>
@@ -439,20 +439,23 @@ public:
      * @param type         The type of the data frame.
      * @param cols         A vector of nix::Column representing the columns to create.
      * @param compression  En-/disable dataset compression, default nix::Compression::Auto.
+     * @param layout       Store the data row by row (default) or each column
+     *                     in a dataset of its own, see nix::DataFrameLayout.
      *
      * @return The newly created data frame.
      */
     DataFrame createDataFrame(const std::string &name,
                               const std::string &type,
                               const std::vector<Column> &cols,
-                              const Compression &compression=Compression::Auto) {
+                              const Compression &compression=Compression::Auto,
+                              DataFrameLayout layout=DataFrameLayout::Rows) {
         for (const Column &c : cols) {
             if (!Variant::supports_type(c.dtype)) {
                 std::string msg = "Incompatible DataType for column ";
                 throw std::invalid_argument(msg + c.name);
             }
         }
-        return backend()->createDataFrame(name, type, cols, compression);
+        return backend()->createDataFrame(name, type, cols, compression, layout);
     }
 
     /**
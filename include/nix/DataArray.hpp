@@ -15,9 +15,17 @@
 #include <nix/base/IDataArray.hpp>
 #include <nix/Dimensions.hpp>
 #include <nix/Hydra.hpp>
+#include <nix/MappedView.hpp>
 
 #include <nix/Platform.hpp>
 #include <nix/util/util.hpp>
+#include <nix/util/ioqueue.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <memory>
+#include <vector>
 
 
 namespace nix {
@@ -496,6 +504,127 @@ public:
 
     void appendData(DataType dtype, const void *data, const NDSize &count, size_t axis);
 
+    /**
+     * @brief Collect small writes in memory and write them at once.
+     *
+     * Writes that continue each other along the first dimension are merged
+     * in a buffer of the given size. The buffered data is written when the
+     * buffer is full, a write does not continue it, an overlapping region
+     * is read through this data array, the extent is reduced below it, or
+     * the file is flushed or closed. The buffer belongs to this data array
+     * object and its copies; other objects for the same data array, e.g.
+     * obtained with Block::getDataArray(), only see the data once it is
+     * written. Backends that write to memory anyway may ignore the buffer.
+     *
+     * @param bytes     The size of the buffer, e.g. the size of a chunk;
+     *                  0 writes the buffered data and disables buffering.
+     */
+    void writeBufferSize(size_t bytes) {
+        backend()->writeBufferSize(bytes);
+    }
+
+    /**
+     * @brief The size of the write buffer, 0 if writes are not buffered.
+     */
+    size_t writeBufferSize() const {
+        return backend()->writeBufferSize();
+    }
+
+    /**
+     * @brief Read ahead when the data is read piece by piece.
+     *
+     * Once two reads of the same shape follow each other along one axis,
+     * the data after them is read in the background into a buffer of the
+     * given size, in pieces of up to half the buffer that end at chunk
+     * boundaries, and the next reads along that axis are served from it.
+     * Reads larger than half of the buffer bypass it.
+     * Writes and extent changes through this data array object drop the
+     * buffer; writes through other objects for the same data array are not
+     * seen by data that was already read ahead. Backends that map the data
+     * into memory may ignore the buffer.
+     *
+     * @param bytes     The size of the buffer; 0 disables reading ahead.
+     */
+    void readAheadSize(size_t bytes) {
+        backend()->readAheadSize(bytes);
+    }
+
+    /**
+     * @brief The size of the read-ahead buffer, 0 if reads are not buffered.
+     */
+    size_t readAheadSize() const {
+        return backend()->readAheadSize();
+    }
+
+    /**
+     * @brief Read data in the background.
+     *
+     * The read is queued behind all asynchronous reads and writes submitted
+     * before, see {@link nix::util::IOQueue}.
+     *
+     * @param count     The shape of the data to read.
+     * @param offset    The position of the data in the array.
+     *
+     * @return A future for the data, in row-major order.
+     */
+    template<typename T>
+    std::future<std::vector<T>> getDataAsync(const NDSize &count, const NDSize &offset) const;
+
+    /**
+     * @brief Write data in the background.
+     *
+     * Writes to the same array handle are done in the order in which they
+     * were submitted; small writes that continue each other are merged.
+     *
+     * @param data      The data in row-major order, count.nelms() elements.
+     * @param count     The shape of the data.
+     * @param offset    The position of the data in the array.
+     *
+     * @return A future that is ready when the data is written; errors of
+     *         the write are raised by its get(). The data is only durable
+     *         once the file is flushed or closed, which waits for the write.
+     */
+    template<typename T>
+    std::future<void> setDataAsync(std::vector<T> data, const NDSize &count, const NDSize &offset);
+
+    /**
+     * @brief Append data in the background, see appendData().
+     *
+     * @return A future that is ready when the data is written.
+     */
+    template<typename T>
+    std::future<void> appendDataAsync(std::vector<T> data, const NDSize &count, size_t axis);
+
+    /**
+     * @brief Read-only view of the data, without copying it if possible.
+     *
+     * If the data is stored uncompressed and in one piece in the file, in
+     * the requested type and the byte order of the machine, and neither
+     * polynomial coefficients nor an expansion origin are set, the view is
+     * backed by the file mapped into memory; the elements are then only read
+     * from disk when accessed. Otherwise the data is read into a buffer
+     * owned by the view. Pending buffered writes are written first.
+     *
+     * The view stays valid when the data array or the file are closed, but
+     * must not be used after the extent of the data is changed.
+     *
+     * @param count     The shape of the view.
+     * @param offset    The position of the view in the data.
+     *
+     * @return The view; its strides are those of the whole data if mapped.
+     */
+    template<typename T>
+    MappedView<T> mappedView(const NDSize &count, const NDSize &offset) const;
+
+    /**
+     * @brief Read-only view of all of the data, see mappedView(count, offset).
+     */
+    template<typename T>
+    MappedView<T> mappedView() const {
+        NDSize extent = dataExtent();
+        return mappedView<T>(extent, NDSize(extent.size(), 0));
+    }
+
     //--------------------------------------------------
     // Other methods and functions
     //--------------------------------------------------
@@ -536,6 +665,114 @@ protected:
 };
 
 
+namespace util {
+
+// std::vector<bool> has no data(), its elements go through a plain array
+
+template<typename T>
+void read_elements(const DataArray &array, std::vector<T> &data, const NDSize &count, const NDSize &offset) {
+    array.getData(to_data_type<T>::value, data.data(), count, offset);
+}
+
+
+inline void read_elements(const DataArray &array, std::vector<bool> &data, const NDSize &count, const NDSize &offset) {
+    std::unique_ptr<bool[]> buffer(new bool[data.size()]);
+    array.getData(DataType::Bool, buffer.get(), count, offset);
+    std::copy(buffer.get(), buffer.get() + data.size(), data.begin());
+}
+
+
+template<typename T>
+std::shared_ptr<const T> share_elements(std::vector<T> &&data) {
+    std::shared_ptr<std::vector<T>> owner = std::make_shared<std::vector<T>>(std::move(data));
+    return std::shared_ptr<const T>(owner, owner->data());
+}
+
+
+inline std::shared_ptr<const bool> share_elements(std::vector<bool> &&data) {
+    std::shared_ptr<bool> buffer(new bool[data.size()], std::default_delete<bool[]>());
+    std::copy(data.begin(), data.end(), buffer.get());
+    return buffer;
+}
+
+} // namespace util
+
+
+template<typename T>
+std::future<std::vector<T>> DataArray::getDataAsync(const NDSize &count, const NDSize &offset) const {
+    std::shared_ptr<std::promise<std::vector<T>>> promise = std::make_shared<std::promise<std::vector<T>>>();
+    std::future<std::vector<T>> result = promise->get_future();
+    DataArray array(*this);
+
+    util::IOQueue::instance().submit([array, promise, count, offset] {
+        try {
+            std::vector<T> data(count.nelms());
+            util::read_elements(array, data, count, offset);
+            promise->set_value(std::move(data));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return result;
+}
+
+
+template<typename T>
+std::future<void> DataArray::setDataAsync(std::vector<T> data, const NDSize &count, const NDSize &offset) {
+    if (data.size() != count.nelms()) {
+        throw IncompatibleDimensions("Size of data and count do not match", "DataArray::setDataAsync");
+    }
+    std::shared_ptr<const T> buffer = util::share_elements(std::move(data));
+    return util::IOQueue::instance().write(*this, to_data_type<T>::value, buffer, buffer.get(), count, offset);
+}
+
+
+template<typename T>
+std::future<void> DataArray::appendDataAsync(std::vector<T> data, const NDSize &count, size_t axis) {
+    if (data.size() != count.nelms()) {
+        throw IncompatibleDimensions("Size of data and count do not match", "DataArray::appendDataAsync");
+    }
+    std::shared_ptr<const T> buffer = util::share_elements(std::move(data));
+    return util::IOQueue::instance().append(*this, to_data_type<T>::value, buffer, buffer.get(), count, axis);
+}
+
+
+template<typename T>
+MappedView<T> DataArray::mappedView(const NDSize &count, const NDSize &offset) const {
+    const NDSize extent = dataExtent();
+    if (count.size() != extent.size() || offset.size() != extent.size()) {
+        throw IncompatibleDimensions("Count, offset and data have different ranks", "DataArray::mappedView");
+    }
+    for (size_t i = 0; i < extent.size(); i++) {
+        if (offset[i] + count[i] > extent[i]) {
+            throw OutOfBounds("View exceeds the data", i);
+        }
+    }
+
+    const DataType dtype = to_data_type<T>::value;
+    NDSize strides(extent.size(), 1);
+
+    if (polynomCoefficients().empty() && !expansionOrigin()) {
+        std::shared_ptr<const void> mapping = backend()->mapData(dtype);
+        if (mapping) {
+            for (size_t i = extent.size(); i > 1; i--) {
+                strides[i - 2] = strides[i - 1] * extent[i - 1];
+            }
+            const T *first = static_cast<const T *>(mapping.get()) + offset.dot(strides);
+            return MappedView<T>(mapping, first, count, strides, true);
+        }
+    }
+
+    const size_t n = check::fits_in_size_t(count.nelms(), "View does not fit into memory");
+    std::shared_ptr<T> buffer(new T[n](), std::default_delete<T[]>());
+    getData(dtype, buffer.get(), count, offset);
+    for (size_t i = count.size(); i > 1; i--) {
+        strides[i - 2] = strides[i - 1] * count[i - 1];
+    }
+    return MappedView<T>(buffer, buffer.get(), count, strides, false);
+}
+
+
 template<>
 struct objectToType<nix::DataArray> {
     static const bool isValid = true;
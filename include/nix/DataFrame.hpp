@@ -16,9 +16,11 @@
 
 #include <nix/base/EntityWithSources.hpp>
 #include <nix/base/IDataFrame.hpp>
+#include <nix/RowPredicate.hpp>
 
 #include <nix/Hydra.hpp>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -39,6 +41,15 @@ public:
         : EntityWithSources(std::move(ptr))
         {}
 
+    /**
+     * @brief The storage layout of the DataFrame, chosen at creation.
+     *
+     * @return The layout, see nix::DataFrameLayout.
+     */
+    DataFrameLayout layout() const {
+        return backend()->layout();
+    }
+
     /**
      * @brief Returns the number of rows in the DataFrame.
      *
@@ -197,6 +208,140 @@ public:
         return backend()->readRow(row);
     }
 
+    /**
+     * @brief Read a range of rows in one go.
+     *
+     * @param offset  Index of the first row to read.
+     * @param count   The number of rows to read.
+     *
+     * @return A {@link nix::RowBatch} with one typed buffer per column.
+     */
+    RowBatch readRows(ndsize_t offset, ndsize_t count) const {
+        if (offset + count > rows()) {
+            throw OutOfBounds("Trying to read more rows than available");
+        }
+        RowBatch batch;
+        backend()->readRows(offset, count, batch);
+        return batch;
+    }
+
+    /**
+     * @brief Read some of the columns of a range of rows in one go.
+     *
+     * All requested columns are read with a single pass over the
+     * rows instead of one pass per column.
+     *
+     * @param names   The names of the columns to read.
+     * @param offset  Index of the first row to read.
+     * @param count   The number of rows to read; 0 reads all rows
+     *                starting at offset.
+     *
+     * @return A {@link nix::RowBatch} with one typed buffer per
+     *         requested column, in the order of names.
+     */
+    RowBatch readColumns(const std::vector<std::string> &names,
+                         ndsize_t offset = 0,
+                         ndsize_t count = 0) const {
+        std::vector<Column> cols = columns();
+        std::vector<unsigned> idx = colIndex(names);
+        std::vector<Column> selected(idx.size());
+        std::transform(idx.cbegin(), idx.cend(), selected.begin(),
+                       [&cols](unsigned i) { return cols[i]; });
+
+        ndsize_t n_rows = rows();
+        if (offset > n_rows) {
+            throw OutOfBounds("offset > number of rows");
+        }
+        if (count == 0) {
+            count = n_rows - offset;
+        }
+
+        RowBatch batch(selected);
+        readColumns(batch, offset, count);
+        return batch;
+    }
+
+    /**
+     * @brief Read some of the columns of a range of rows into the
+     *        given buffers in one go.
+     *
+     * The columns of the batch select which columns are read (by name)
+     * and the data types to read them as.
+     *
+     * @param batch   The destination buffers, resized to count rows.
+     * @param offset  Index of the first row to read.
+     * @param count   The number of rows to read.
+     */
+    void readColumns(RowBatch &batch, ndsize_t offset, ndsize_t count) const {
+        if (batch.columns.empty()) {
+            return;
+        }
+        if (offset + count > rows()) {
+            throw OutOfBounds("Trying to read more rows than available");
+        }
+        backend()->readRows(offset, count, batch);
+    }
+
+    /**
+     * @brief Find the rows that match a predicate.
+     *
+     * The columns the predicate refers to are read and tested chunk
+     * by chunk, so memory use is bounded by the chunk size and not by
+     * the size of the DataFrame.
+     *
+     * @param pred    The condition, e.g. `nix::col("rt") > 0.3 && nix::col("correct") == true`.
+     * @param chunk   The number of rows to read and test at a time.
+     *
+     * @return The indices of the matching rows in ascending order.
+     */
+    std::vector<ndsize_t> select(const RowPredicate &pred, ndsize_t chunk = 65536) const;
+
+    /**
+     * @brief Read the rows that match a predicate.
+     *
+     * Like {@link select}, but returns the values of the matching rows
+     * instead of their indices.
+     *
+     * @param pred    The condition the rows have to match.
+     * @param names   The columns to read; all columns if empty.
+     * @param chunk   The number of rows to read and test at a time.
+     *
+     * @return The matching rows, one buffer per column in the order of names.
+     */
+    RowBatch selectRows(const RowPredicate &pred,
+                        const std::vector<std::string> &names = {},
+                        ndsize_t chunk = 65536) const;
+
+    /**
+     * @brief Write a range of rows in one go.
+     *
+     * Only the columns contained in the batch are written; they are
+     * matched by name.
+     *
+     * @param offset  Index of the first row to write to.
+     * @param batch   The rows to write.
+     */
+    void writeRows(ndsize_t offset, const RowBatch &batch) {
+        if (offset + batch.rows() > rows()) {
+            throw OutOfBounds("Trying to write more rows than available");
+        }
+        backend()->writeRows(offset, batch);
+    }
+
+    /**
+     * @brief Append rows to the end of the DataFrame.
+     *
+     * @param batch   The rows to append.
+     *
+     * @return The index of the first appended row.
+     */
+    ndsize_t appendRows(const RowBatch &batch) {
+        ndsize_t offset = rows();
+        rows(offset + batch.rows());
+        backend()->writeRows(offset, batch);
+        return offset;
+    }
+
     /**
      * @brief Write column data.
      *
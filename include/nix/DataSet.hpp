@@ -17,6 +17,8 @@
 
 #include <nix/Platform.hpp>
 
+#include <memory>
+
 namespace nix {
 
 class NIXAPI DataSet {
@@ -55,6 +57,13 @@ public:
     virtual ~DataSet() {}
 
 protected:
+    // values that are not contiguous in memory go through a buffer
+    template<typename T>
+    void readHydra(Hydra<T> &hydra, DataType dtype, const NDSize &count, const NDSize &offset) const;
+
+    template<typename T>
+    void writeHydra(const Hydra<const T> &hydra, DataType dtype, const NDSize &count, const NDSize &offset);
+
     virtual void ioRead(DataType dtype,
                         void *data,
                         const NDSize &count,
@@ -78,7 +87,7 @@ void DataSet::getData(T &value) const
     DataType dtype = hydra.element_data_type();
     NDSize shape = hydra.shape();
 
-    getData(dtype, hydra.data(), shape, {});
+    readHydra(hydra, dtype, shape, {});
 }
 
 template<typename T>
@@ -90,7 +99,7 @@ void DataSet::setData(const T &value)
     NDSize shape = hydra.shape();
 
     dataExtent(shape);
-    setData(dtype, hydra.data(), shape, {});
+    writeHydra(hydra, dtype, shape, {});
 }
 
 template<typename T>
@@ -100,7 +109,7 @@ void DataSet::getData(T &value, const NDSize &count, const NDSize &offset) const
     DataType dtype = hydra.element_data_type();
 
     hydra.resize(count);
-    getData(dtype, hydra.data(), count, offset);
+    readHydra(hydra, dtype, count, offset);
 }
 
 template<typename T>
@@ -113,7 +122,7 @@ void DataSet::getData(T &value, const NDSize &offset) const
     if (! count) {
         count = NDSize(offset.size(), 1);
     }
-    getData(dtype, hydra.data(), count, offset);
+    readHydra(hydra, dtype, count, offset);
 }
 
 
@@ -125,7 +134,37 @@ void DataSet::setData(const T &value, const NDSize &offset)
     DataType dtype = hydra.element_data_type();
     NDSize shape = hydra.shape();
 
-    setData(dtype, hydra.data(), shape, offset);
+    writeHydra(hydra, dtype, shape, offset);
+}
+
+template<typename T>
+void DataSet::readHydra(Hydra<T> &hydra, DataType dtype, const NDSize &count, const NDSize &offset) const
+{
+    if (hydra.contiguous()) {
+        getData(dtype, hydra.data(), count, offset);
+        return;
+    }
+
+    size_t bytes = check::fits_in_size_t(count.nelms() * data_type_to_size(dtype),
+                                         "Cannot read data: buffer needed exceeds memory");
+    std::unique_ptr<char[]> buffer(new char[bytes]);
+    getData(dtype, buffer.get(), count, offset);
+    hydra.scatter(buffer.get());
+}
+
+template<typename T>
+void DataSet::writeHydra(const Hydra<const T> &hydra, DataType dtype, const NDSize &count, const NDSize &offset)
+{
+    if (hydra.contiguous()) {
+        setData(dtype, hydra.data(), count, offset);
+        return;
+    }
+
+    size_t bytes = check::fits_in_size_t(count.nelms() * data_type_to_size(dtype),
+                                         "Cannot write data: buffer needed exceeds memory");
+    std::unique_ptr<char[]> buffer(new char[bytes]);
+    hydra.gather(buffer.get());
+    setData(dtype, buffer.get(), count, offset);
 }
 
 }
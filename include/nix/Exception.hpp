@@ -150,6 +150,22 @@ fits_in_size_t(T size, const std::string &msg_if_fail) {
     return size;
 }
 
+// for literal messages, which are then only turned into strings on failure
+template<typename T>
+inline typename std::enable_if<! std::is_same<T, size_t>::value, size_t>::type
+fits_in_size_t(T size, const char *msg_if_fail) {
+    if (size > std::numeric_limits<size_t>::max()) {
+        throw OutOfBounds(msg_if_fail);
+    }
+    return static_cast<size_t>(size);
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_same<T, size_t>::value, size_t>::type
+fits_in_size_t(T size, const char *msg_if_fail) {
+    return size;
+}
+
 } // nix::check::
 
 
@@ -98,6 +98,9 @@ public:
     /**
      * @brief Persists all cached changes to the backend.
      *
+     * Waits for all requests of the asynchronous data access methods
+     * (e.g. DataArray::setDataAsync) first, of this and any other file;
+     * asynchronous writes are only durable after flush() or close().
      */
     bool flush();
 
@@ -429,6 +432,15 @@ public:
         backend()->forceUpdatedAt();
     }
 
+    /**
+     * @brief Sets the time of the last update to the provided value.
+     *
+     * @param t The time of the last update.
+     */
+    void forceUpdatedAt(time_t t) {
+        backend()->forceUpdatedAt(t);
+    }
+
     /**
      * @brief Sets the creation time to the current time if the field is not set.
      */
@@ -452,6 +464,8 @@ public:
 
     /**
      * @brief Close the file.
+     *
+     * Waits for all queued asynchronous requests first, see flush().
      */
     void close();
 
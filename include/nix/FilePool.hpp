@@ -0,0 +1,164 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_FILE_POOL_H
+#define NIX_FILE_POOL_H
+
+#include <nix/Platform.hpp>
+#include <nix/File.hpp>
+#include <nix/Block.hpp>
+#include <nix/DataArray.hpp>
+
+#include <memory>
+#include <string>
+
+namespace nix {
+
+/**
+ * @brief A pool of read-only handles on the same file, for parallel readers.
+ *
+ * The pool opens a file several times in FileMode::ReadOnly. A worker thread
+ * acquires one of the handles for exclusive use, finds the entities it needs
+ * in it by their ids and releases it again when done:
+ *
+ * ~~~
+ * FilePool pool("recording.h5", 4);
+ * ...
+ * // in each worker
+ * FilePool::Handle handle = pool.acquire();
+ * DataArray da = handle.dataArray(da_id);
+ * da.getData(...);
+ * ~~~
+ *
+ * The handles do not share any NIX objects, so if the backend can be called
+ * from several threads at once (the HDF5 backend with a thread-safe build of
+ * the HDF5 library) workers using different handles do not need the backend
+ * lock, see nix::threadSafe(). Otherwise the pool enables the lock when it
+ * is created and workers are serialized as with a single shared file; the
+ * lock is enabled until the pool and all of its handles are destroyed, and
+ * then returns to the setting of threadSafe(bool).
+ *
+ * Entities obtained from a handle should only be used while the handle is
+ * held.
+ */
+class NIXAPI FilePool {
+
+    struct Slot;
+    struct State;
+
+public:
+
+    /**
+     * @brief Exclusive use of one of the files of a FilePool.
+     *
+     * The file is given back to the pool when the handle is destroyed.
+     */
+    class NIXAPI Handle {
+
+    public:
+
+        Handle(Handle &&other);
+
+        Handle(const Handle &other) = delete;
+
+        Handle &operator=(const Handle &other) = delete;
+
+        /**
+         * @brief The file of this handle.
+         */
+        File file() const;
+
+        /**
+         * @brief Get the block with the given id in the file of this handle.
+         *
+         * @param id    The id of the block.
+         *
+         * @return The block or an uninitialized block if it does not exist.
+         */
+        Block block(const std::string &id) const;
+
+        /**
+         * @brief Get the data array with the given id in the file of this
+         *        handle.
+         *
+         * The blocks of the file are searched; the result is kept, later
+         * calls with the same id do not search again.
+         *
+         * @param id    The id of the data array.
+         *
+         * @return The data array or an uninitialized data array if it does
+         *         not exist.
+         */
+        DataArray dataArray(const std::string &id) const;
+
+        /**
+         * @brief Get the data array that corresponds to the given one, e.g.
+         *        from another handle, in the file of this handle.
+         */
+        DataArray dataArray(const DataArray &other) const;
+
+        ~Handle();
+
+    private:
+
+        friend class FilePool;
+
+        Handle(const std::shared_ptr<State> &state, size_t index);
+
+        std::shared_ptr<State> state;
+        size_t index;
+    };
+
+    /**
+     * @brief Open the file at path size times.
+     *
+     * @param path  The path of the file.
+     * @param size  The number of handles, at least one.
+     * @param impl  The backend of the file, "hdf5" or "file".
+     */
+    FilePool(const std::string &path, size_t size, const std::string &impl = "hdf5");
+
+    /**
+     * @brief Open the file of an open file size times, with the same backend.
+     */
+    FilePool(const File &file, size_t size);
+
+    /**
+     * @brief The number of handles in the pool.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Whether workers using different handles may run concurrently.
+     *
+     * This is false if the backend lock had to be enabled or was already
+     * enabled.
+     */
+    bool concurrent() const;
+
+    /**
+     * @brief Get a free handle, waiting until one is released if all are
+     *        in use.
+     */
+    Handle acquire();
+
+    /**
+     * @brief Get a free handle if there is one.
+     *
+     * @return A pointer to the handle or a null pointer if all are in use.
+     */
+    std::unique_ptr<Handle> tryAcquire();
+
+private:
+
+    std::shared_ptr<State> state;
+};
+
+} // namespace nix
+
+#endif // NIX_FILE_POOL_H
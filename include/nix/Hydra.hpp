@@ -13,8 +13,10 @@
 #include <nix/DataType.hpp>
 
 #include <type_traits>
+#include <cstring>
 #include <limits>
 #include <valarray>
+#include <utility>
 
 #ifndef NIX_HYDRA_H
 #define NIX_HYDRA_H
@@ -238,6 +240,24 @@ public:
 
 /* *** */
 
+/*
+ * Values whose elements are not in one row-major block, like strided views,
+ * add contiguous(), gather() and scatter() to their data_traits; the data
+ * is then passed through a buffer when it is not contiguous.
+ */
+template<typename T>
+struct has_strided_traits {
+private:
+    template<typename U>
+    static auto test(int) -> decltype(data_traits<U>::contiguous(std::declval<const U &>()), std::true_type());
+
+    template<typename U>
+    static std::false_type test(...);
+
+public:
+    static const bool value = decltype(test<T>(0))::value;
+};
+
 template<typename T>
 class Hydra {
 public:
@@ -272,7 +292,59 @@ public:
         return data_traits<vanilla_type>::get_data(value);
     }
 
+    /**
+     * @brief Whether data() points to all elements in row-major order.
+     */
+    bool contiguous() const {
+        return contiguous(strided());
+    }
+
+    /**
+     * @brief Copy the elements to dest in row-major order.
+     */
+    void gather(void *dest) const {
+        gather(dest, strided());
+    }
+
+    /**
+     * @brief Set the elements from src in row-major order.
+     */
+    void scatter(const void *src) {
+        scatter(src, strided());
+    }
+
 private:
+    typedef std::integral_constant<bool, has_strided_traits<vanilla_type>::value> strided;
+
+    bool contiguous(std::true_type) const {
+        return data_traits<vanilla_type>::contiguous(value);
+    }
+
+    bool contiguous(std::false_type) const {
+        return true;
+    }
+
+    void gather(void *dest, std::true_type) const {
+        data_traits<vanilla_type>::gather(value, dest);
+    }
+
+    void gather(void *dest, std::false_type) const {
+        memcpy(dest, data(), buffer_size());
+    }
+
+    void scatter(const void *src, std::true_type) {
+        data_traits<vanilla_type>::scatter(value, src);
+    }
+
+    void scatter(const void *src, std::false_type) {
+        memcpy(data(), src, buffer_size());
+    }
+
+    size_t buffer_size() const {
+        return check::fits_in_size_t(shape().nelms() * data_type_to_size(element_data_type()),
+                                     "data does not fit into memory");
+    }
+
     reference value;
 };
 
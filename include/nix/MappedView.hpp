@@ -0,0 +1,113 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_MAPPED_VIEW_H
+#define NIX_MAPPED_VIEW_H
+
+#include <nix/NDSize.hpp>
+#include <nix/Exception.hpp>
+
+#include <memory>
+
+namespace nix {
+
+/**
+ * @brief Read-only view of the data of a DataArray, see
+ *        DataArray::mappedView().
+ *
+ * The elements are either mapped directly from the file or were read into
+ * a buffer owned by the view; see mapped(). Either way they stay valid as
+ * long as the view or a copy of it exists, even after the file is closed.
+ * Element i of the view is at data()[i.dot(strides())].
+ */
+template<typename T>
+class MappedView {
+
+public:
+
+    MappedView()
+        : ptr(nullptr), is_mapped(false)
+    {
+    }
+
+    /**
+     * @param guard     Keeps the memory behind data valid.
+     * @param data      The first element of the view.
+     * @param shape     The shape of the view.
+     * @param strides   The distance of neighbouring elements in each
+     *                  dimension, in elements.
+     * @param mapped    Whether the memory is mapped from the file.
+     */
+    MappedView(const std::shared_ptr<const void> &guard, const T *data,
+               const NDSize &shape, const NDSize &strides, bool mapped)
+        : guard(guard), ptr(data), view_shape(shape), view_strides(strides), is_mapped(mapped)
+    {
+    }
+
+    const T *data() const {
+        return ptr;
+    }
+
+    NDSize shape() const {
+        return view_shape;
+    }
+
+    NDSize strides() const {
+        return view_strides;
+    }
+
+    /**
+     * @brief The number of elements in the view.
+     */
+    ndsize_t size() const {
+        return view_shape.nelms();
+    }
+
+    /**
+     * @brief Whether the elements are mapped from the file rather than
+     *        copied into memory.
+     */
+    bool mapped() const {
+        return is_mapped;
+    }
+
+    const T &operator()(const NDSize &index) const {
+        return ptr[index.dot(view_strides)];
+    }
+
+    /**
+     * @brief Like operator(), but checks the index.
+     */
+    const T &at(const NDSize &index) const {
+        if (index.size() != view_shape.size()) {
+            throw IncompatibleDimensions("Index and view have different ranks", "MappedView::at");
+        }
+        for (size_t i = 0; i < index.size(); i++) {
+            if (index[i] >= view_shape[i]) {
+                throw OutOfBounds("Index is outside of the view", index[i]);
+            }
+        }
+        return (*this)(index);
+    }
+
+    explicit operator bool() const {
+        return ptr != nullptr;
+    }
+
+private:
+
+    std::shared_ptr<const void> guard;
+    const T *ptr;
+    NDSize view_shape;
+    NDSize view_strides;
+    bool is_mapped;
+};
+
+} // namespace nix
+
+#endif // NIX_MAPPED_VIEW_H
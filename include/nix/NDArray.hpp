@@ -21,14 +21,34 @@
 
 namespace nix {
 
+class NDArrayView;
+
+/**
+ * @brief N-dimensional array of elements of a DataType, in row-major order.
+ *
+ * The storage is aligned to NDArray::alignment bytes.
+ */
 class NIXAPI NDArray {
 
 public:
 
     typedef uint8_t byte_type;
 
+    static const size_t alignment = 64;
+
+    /**
+     * @brief Creates an array with all elements set to zero.
+     */
     NDArray(DataType dtype, NDSize dims);
 
+    NDArray(const NDArray &other);
+
+    NDArray(NDArray &&other);
+
+    NDArray &operator=(const NDArray &other);
+
+    NDArray &operator=(NDArray &&other);
+
     size_t rank() const { return extends.size(); }
     ndsize_t num_elements() const { return extends.nelms(); }
     NDSize  shape() const { return extends; }
@@ -40,23 +60,117 @@ public:
     template<typename T> void set(size_t index, T value);
     template<typename T> void set(const NDSize &index, T value);
 
-    byte_type *data() { return dstore.data(); }
-    const byte_type *data() const { return dstore.data(); }
+    byte_type *data() { return dstore; }
+    const byte_type *data() const { return dstore; }
 
+    /**
+     * @brief Change the shape of the array.
+     *
+     * Elements that are added are not initialized, since the array is
+     * usually resized to be read into. The storage is only reallocated if
+     * it grows.
+     */
     void resize(const NDSize &new_size);
 
     size_t sub2index(const NDSize &sub) const;
 
+    /**
+     * @brief View of the whole array, see NDArrayView.
+     */
+    NDArrayView view();
+
+    ~NDArray();
+
 private:
 
     DataType  dataType;
-    void allocate_space();
+    void allocate_space(bool zero);
     void calc_strides();
+    void release();
 
     NDSize                  extends;
     NDSize                  strides;
-    std::vector<byte_type> dstore;
+    byte_type              *dstore;
+    size_t                  nbytes;
+    size_t                  capacity;
+    void                   *block;
+
+};
+
+
+/**
+ * @brief Strided view of the elements of an NDArray, without a copy.
+ *
+ * A view does not own the elements; the array it was taken from has to
+ * live as long as the view. Views of a view are taken with slice() and
+ * transpose(). Strides are counted in elements.
+ *
+ * Views can be passed to DataSet::getData and DataSet::setData like an
+ * NDArray; if the view is not contiguous, the data goes through a buffer.
+ * The shape of a view cannot be changed, so reading into it only works
+ * with a count equal to its shape.
+ */
+class NIXAPI NDArrayView {
+
+public:
+
+    typedef NDArray::byte_type byte_type;
+
+    NDArrayView(DataType dtype, byte_type *data, const NDSize &shape, const NDSize &strides);
+
+    size_t rank() const { return extends.size(); }
+    ndsize_t num_elements() const { return extends.nelms(); }
+    NDSize shape() const { return extends; }
+    NDSize size() const { return extends; }
+    NDSize stride() const { return strides; }
+    DataType dtype() const { return dataType; }
 
+    /**
+     * @brief The first element of the view.
+     */
+    byte_type *data() const { return ptr; }
+
+    template<typename T> const T get(const NDSize &index) const;
+    template<typename T> void set(const NDSize &index, T value) const;
+
+    /**
+     * @brief View of the elements [start, start + count) along an axis.
+     */
+    NDArrayView slice(size_t axis, ndsize_t start, ndsize_t count) const;
+
+    /**
+     * @brief View with the order of the axes reversed.
+     */
+    NDArrayView transpose() const;
+
+    /**
+     * @brief View with two axes swapped.
+     */
+    NDArrayView transpose(size_t a, size_t b) const;
+
+    /**
+     * @brief Whether the elements are in row-major order without gaps.
+     */
+    bool contiguous() const;
+
+    /**
+     * @brief Copy the elements to dest, in row-major order.
+     */
+    void copyTo(void *dest) const;
+
+    /**
+     * @brief Set the elements from src, in row-major order.
+     */
+    void copyFrom(const void *src) const;
+
+private:
+
+    size_t offset(const NDSize &index) const;
+
+    DataType   dataType;
+    byte_type *ptr;
+    NDSize     extends;
+    NDSize     strides;
 };
 
 /* ******************************************* */
@@ -65,7 +179,7 @@ template<typename T>
 const T NDArray::get(size_t index) const
 {
     T value;
-    const byte_type *offset = dstore.data() + sizeof(T) * index;
+    const byte_type *offset = dstore + sizeof(T) * index;
     memcpy(&value, offset, sizeof(T));
     return value;
 }
@@ -82,7 +196,7 @@ const T NDArray::get(const NDSize &index) const
 template<typename T>
 void NDArray::set(size_t index, T value)
 {
-    byte_type *offset = dstore.data() + sizeof(T) * index;
+    byte_type *offset = dstore + sizeof(T) * index;
     memcpy(offset, &value, sizeof(T));
 }
 
@@ -94,6 +208,22 @@ void NDArray::set(const NDSize &index, T value)
     set(pos, value);
 }
 
+
+template<typename T>
+const T NDArrayView::get(const NDSize &index) const
+{
+    T value;
+    memcpy(&value, ptr + offset(index), sizeof(T));
+    return value;
+}
+
+
+template<typename T>
+void NDArrayView::set(const NDSize &index, T value) const
+{
+    memcpy(ptr + offset(index), &value, sizeof(T));
+}
+
 /* ****************************************** */
 
 template<>
@@ -134,6 +264,58 @@ struct data_traits<NDArray> {
 };
 
 
+template<>
+struct data_traits<NDArrayView> {
+
+    typedef NDArrayView        value_type;
+    typedef NDArrayView&       reference;
+    typedef const NDArrayView& const_reference;
+
+    typedef uint8_t        element_type;
+    typedef uint8_t*       element_pointer;
+    typedef const uint8_t* const_element_pointer;
+
+    static DataType data_type(const_reference value) {
+        return value.dtype();
+    }
+
+    static NDSize shape(const_reference value) {
+        return value.shape();
+    }
+
+    static ndsize_t num_elements(const_reference value) {
+        return value.num_elements();
+    }
+
+    static const_element_pointer get_data(const_reference value) {
+        return value.data();
+    }
+
+    static element_pointer get_data(reference value) {
+        return value.data();
+    }
+
+    static void resize(reference value, const NDSize &dims) {
+        if (dims != value.shape()) {
+            throw InvalidRank("Cannot resize a view");
+        }
+    }
+
+    static bool contiguous(const_reference value) {
+        return value.contiguous();
+    }
+
+    static void gather(const_reference value, void *dest) {
+        value.copyTo(dest);
+    }
+
+    static void scatter(reference value, const void *src) {
+        value.copyFrom(src);
+    }
+
+};
+
+
 } // namespace nix
 
 #endif // NIX_NDARRAY_H
@@ -61,7 +61,7 @@ public:
     typedef size_t   size_type;
 
     NDSizeBase()
-        : rank(0), dims(nullptr)
+        : rank(0), dims(inline_dims)
     {
     }
 
@@ -82,7 +82,7 @@ public:
 
     template<typename U>
     NDSizeBase(std::initializer_list<U> args)
-        : rank(args.size())
+        : rank(args.size()), dims(nullptr)
     {
         allocate();
 
@@ -102,7 +102,7 @@ public:
 
     template<typename U>
     NDSizeBase(const std::vector<U> &args)
-        : rank(args.size())
+        : rank(args.size()), dims(nullptr)
     {
         allocate();
 
@@ -129,15 +129,27 @@ public:
 
     //move (not tested due to: http://llvm.org/bugs/show_bug.cgi?id=12208)
     NDSizeBase(NDSizeBase &&other)
-        : rank(other.rank), dims(other.dims)
+        : rank(0), dims(inline_dims)
     {
-        other.dims = nullptr;
-        other.rank = 0;
+        take(other);
+    }
+
+    //copy and move assignment operators (not tested, see above)
+    NDSizeBase& operator=(const NDSizeBase &other) {
+        if (this != &other) {
+            release();
+            rank = other.rank;
+            allocate();
+            nd_copy(other.dims, rank, dims);
+        }
+        return *this;
     }
 
-    //copy and move assignment operator (not tested, see above)
-    NDSizeBase& operator=(NDSizeBase other) {
-        swap(other);
+    NDSizeBase& operator=(NDSizeBase &&other) {
+        if (this != &other) {
+            release();
+            take(other);
+        }
         return *this;
     }
 
@@ -244,9 +256,9 @@ public:
 
 
     void swap(NDSizeBase &other) {
-        using std::swap;
-        swap(dims, other.dims);
-        rank = other.rank;
+        NDSizeBase tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
     }
 
 
@@ -316,7 +328,7 @@ public:
 
 
     ~NDSizeBase() {
-        delete[] dims;
+        release();
     }
 
 
@@ -337,14 +349,38 @@ public:
 
 private:
 
+    // sizes of up to this rank are stored in the object itself, so that
+    // the many temporary sizes of a data access do not allocate
+    static const size_t INLINE_RANK = 8;
+
     void allocate() {
-        if (rank > 0) {
-            dims = new T[rank];
+        dims = rank > INLINE_RANK ? new T[rank] : inline_dims;
+    }
+
+    void release() {
+        if (dims != inline_dims) {
+            delete[] dims;
         }
+        dims = inline_dims;
+        rank = 0;
+    }
+
+    // other must be empty afterwards; only heap storage can be taken over
+    void take(NDSizeBase &other) {
+        rank = other.rank;
+        if (other.dims == other.inline_dims) {
+            dims = inline_dims;
+            nd_copy(other.inline_dims, rank, inline_dims);
+        } else {
+            dims = other.dims;
+        }
+        other.dims = other.inline_dims;
+        other.rank = 0;
     }
 
     size_t   rank;
     T *dims;
+    T inline_dims[INLINE_RANK];
 };
 
 
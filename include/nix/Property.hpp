@@ -12,6 +12,7 @@
 #include <nix/base/Entity.hpp>
 #include <nix/base/IProperty.hpp>
 #include <nix/Variant.hpp>
+#include <nix/Hydra.hpp>
 #include <nix/ObjectType.hpp>
 
 #include <nix/Platform.hpp>
@@ -244,6 +245,39 @@ public:
         backend()->values(t);
     }
 
+    /**
+     * @brief Get all values of the property as a vector of the given type.
+     *
+     * The values are read directly into the vector without being converted
+     * to {@link Variant} first, which makes this the method of choice for
+     * properties with many values. Numeric values are converted to T if
+     * the data type of the property differs.
+     *
+     * @param values    The vector to read the values into; it is resized
+     *                  to {@link valueCount}.
+     */
+    template<typename T>
+    void getValues(std::vector<T> &values) const {
+        Hydra<std::vector<T>> hydra(values);
+        ndsize_t count = valueCount();
+        hydra.resize({count});
+        backend()->readValues(hydra.element_data_type(), hydra.data(), count);
+    }
+
+    /**
+     * @brief Set the values of the property from a vector of the given type.
+     *
+     * Counterpart of {@link getValues}; the element type must match the
+     * data type of the property.
+     *
+     * @param values    The values to set.
+     */
+    template<typename T>
+    void setValues(const std::vector<T> &values) {
+        const Hydra<const std::vector<T>> hydra(values);
+        backend()->writeValues(hydra.element_data_type(), hydra.data(), values.size());
+    }
+
     //------------------------------------------------------
     // Operators and other functions
     //------------------------------------------------------
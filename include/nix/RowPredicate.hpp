@@ -0,0 +1,189 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_ROW_PREDICATE_H
+#define NIX_ROW_PREDICATE_H
+
+#include <nix/Platform.hpp>
+#include <nix/Variant.hpp>
+#include <nix/base/IDataFrame.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nix {
+
+/**
+ * @brief Reference to a column of a DataFrame inside a {@link RowPredicate},
+ *        see {@link nix::col}.
+ */
+struct ColumnRef {
+    std::string name;
+};
+
+
+/**
+ * @brief Reference a column by name, to build a {@link RowPredicate}.
+ *
+ * Example: `nix::col("response_time") > 0.3 && nix::col("correct") == true`
+ */
+inline ColumnRef col(const std::string &name) {
+    return ColumnRef{name};
+}
+
+
+/**
+ * @brief A condition on the values of the rows of a DataFrame.
+ *
+ * A predicate is a small expression tree: its leafs compare a column with
+ * a constant or with another column, the inner nodes combine predicates
+ * with And, Or and Not. Predicates are usually built with {@link nix::col}
+ * and the comparison and logical operators below and evaluated with
+ * {@link nix::DataFrame::select}.
+ *
+ * Numeric values are compared in a common type: as signed or unsigned
+ * 64 bit integers if both sides are integers of the same signedness,
+ * as double if one side is a floating point value. Signed and unsigned
+ * integers are compared exactly, by sign first. Strings can only be
+ * compared with strings.
+ */
+class NIXAPI RowPredicate {
+public:
+
+    enum class Op {
+        Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, And, Or, Not
+    };
+
+    /**
+     * @brief One side of a comparison: a column or a constant value.
+     */
+    struct Operand {
+        Operand(const ColumnRef &c) : column(c.name) {}
+        Operand(const Variant &v) : value(v) {}
+
+        bool isColumn() const { return !column.empty(); }
+
+        std::string column;
+        Variant     value;
+    };
+
+    /**
+     * @brief Comparison of two operands.
+     */
+    RowPredicate(Op op, const Operand &lhs, const Operand &rhs);
+
+    /**
+     * @brief Logical combination (And, Or) of two predicates.
+     */
+    RowPredicate(Op op, const RowPredicate &lhs, const RowPredicate &rhs);
+
+    /**
+     * @brief Negation (Not) of a predicate.
+     */
+    RowPredicate(Op op, const RowPredicate &p);
+
+    Op op() const { return oper; }
+
+    /**
+     * @brief The names of all columns referenced by the predicate.
+     */
+    std::vector<std::string> columns() const;
+
+    /**
+     * @brief Evaluate the predicate for all rows of a batch.
+     *
+     * The batch must contain all the columns the predicate references.
+     *
+     * @param batch  The rows to test.
+     * @param mask   Receives one byte per row, 1 if the row matches
+     *               and 0 otherwise.
+     */
+    void evaluate(const RowBatch &batch, std::vector<uint8_t> &mask) const;
+
+private:
+
+    void compare(const RowBatch &batch, std::vector<uint8_t> &mask) const;
+
+    Op                                  oper;
+    std::vector<Operand>                operands;
+    std::shared_ptr<const RowPredicate> left;
+    std::shared_ptr<const RowPredicate> right;
+};
+
+
+inline RowPredicate operator==(const ColumnRef &a, const ColumnRef &b) {
+    return RowPredicate(RowPredicate::Op::Equal, a, b);
+}
+
+inline RowPredicate operator!=(const ColumnRef &a, const ColumnRef &b) {
+    return RowPredicate(RowPredicate::Op::NotEqual, a, b);
+}
+
+inline RowPredicate operator<(const ColumnRef &a, const ColumnRef &b) {
+    return RowPredicate(RowPredicate::Op::Less, a, b);
+}
+
+inline RowPredicate operator<=(const ColumnRef &a, const ColumnRef &b) {
+    return RowPredicate(RowPredicate::Op::LessEqual, a, b);
+}
+
+inline RowPredicate operator>(const ColumnRef &a, const ColumnRef &b) {
+    return RowPredicate(RowPredicate::Op::Greater, a, b);
+}
+
+inline RowPredicate operator>=(const ColumnRef &a, const ColumnRef &b) {
+    return RowPredicate(RowPredicate::Op::GreaterEqual, a, b);
+}
+
+template<typename T>
+RowPredicate operator==(const ColumnRef &a, const T &value) {
+    return RowPredicate(RowPredicate::Op::Equal, a, Variant(value));
+}
+
+template<typename T>
+RowPredicate operator!=(const ColumnRef &a, const T &value) {
+    return RowPredicate(RowPredicate::Op::NotEqual, a, Variant(value));
+}
+
+template<typename T>
+RowPredicate operator<(const ColumnRef &a, const T &value) {
+    return RowPredicate(RowPredicate::Op::Less, a, Variant(value));
+}
+
+template<typename T>
+RowPredicate operator<=(const ColumnRef &a, const T &value) {
+    return RowPredicate(RowPredicate::Op::LessEqual, a, Variant(value));
+}
+
+template<typename T>
+RowPredicate operator>(const ColumnRef &a, const T &value) {
+    return RowPredicate(RowPredicate::Op::Greater, a, Variant(value));
+}
+
+template<typename T>
+RowPredicate operator>=(const ColumnRef &a, const T &value) {
+    return RowPredicate(RowPredicate::Op::GreaterEqual, a, Variant(value));
+}
+
+inline RowPredicate operator&&(const RowPredicate &a, const RowPredicate &b) {
+    return RowPredicate(RowPredicate::Op::And, a, b);
+}
+
+inline RowPredicate operator||(const RowPredicate &a, const RowPredicate &b) {
+    return RowPredicate(RowPredicate::Op::Or, a, b);
+}
+
+inline RowPredicate operator!(const RowPredicate &p) {
+    return RowPredicate(RowPredicate::Op::Not, p);
+}
+
+} // namespace nix
+
+#endif // NIX_ROW_PREDICATE_H
@@ -524,8 +524,6 @@ private:
     std::vector<Section> findAmongParents(const std::function<bool(Section)> &filter) const;
 
     std::vector<Section> findSideways(const std::function<bool(Section)> &filter, const std::string &caller_id) const;
-
-    size_t tree_depth() const;
 };
 
 template<>
@@ -0,0 +1,135 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_THREADING_H
+#define NIX_THREADING_H
+
+#include <nix/Platform.hpp>
+
+namespace nix {
+
+/**
+ * @brief Enable or disable locking of the backends.
+ *
+ * The backends are not synchronized: HDF5 is usually built without
+ * thread-safety and the caches of both backends assume one thread. If
+ * locking is enabled, all calls into a backend made through the NIX API,
+ * as well as the release of the last handle on an entity, are serialized
+ * by one library wide lock. The API can then be called from several
+ * threads at once, with the same or different files. Calls do not run
+ * concurrently, so this allows sharing open files between threads but
+ * does not make the calls faster.
+ *
+ * Locking has to be enabled before other threads call into the library;
+ * switching it on or off while another thread is inside a backend call
+ * leaves that call unprotected. Using the same entity object (e.g. the same nix::DataArray instance)
+ * from several threads is not safe either way; every thread should hold
+ * its own copy of the handle.
+ *
+ * Locking is disabled by default, unless the library was built with the
+ * CMake option THREAD_SAFE.
+ *
+ * @param enable    True to enable locking.
+ */
+NIXAPI void threadSafe(bool enable);
+
+/**
+ * @brief Whether calls into the backends are locked.
+ *
+ * @return True if locking is enabled.
+ */
+NIXAPI bool threadSafe();
+
+namespace base {
+
+/**
+ * @brief Holds the backend lock for its lifetime, if locking is enabled.
+ *
+ * The lock is recursive, a thread may take it more than once.
+ */
+class NIXAPI BackendLock {
+
+public:
+
+    BackendLock();
+
+    BackendLock(BackendLock &&other);
+
+    BackendLock(const BackendLock &other) = delete;
+
+    BackendLock &operator=(const BackendLock &other) = delete;
+
+    ~BackendLock();
+
+private:
+
+    bool locked;
+};
+
+
+/**
+ * @brief Keeps locking enabled for its lifetime, independently of
+ *        threadSafe(bool).
+ *
+ * For parts of the library that call into the backends from threads of
+ * their own, like util::IOQueue; threadSafe() is true while a hold exists.
+ */
+class NIXAPI LockingHold {
+
+public:
+
+    LockingHold();
+
+    LockingHold(const LockingHold &other) = delete;
+
+    LockingHold &operator=(const LockingHold &other) = delete;
+
+    ~LockingHold();
+};
+
+
+/**
+ * @brief Pointer to a backend object that holds the backend lock.
+ *
+ * Returned by value, the lock is held until the end of the full expression
+ * in which the pointer is used, e.g. during the call in backend()->name().
+ */
+template<typename T>
+class LockedPtr {
+
+public:
+
+    explicit LockedPtr(T *ptr)
+        : ptr(ptr)
+    {
+    }
+
+    LockedPtr(LockedPtr &&other) = default;
+
+    T *operator->() const {
+        return ptr;
+    }
+
+    T &operator*() const {
+        return *ptr;
+    }
+
+    operator T*() const {
+        return ptr;
+    }
+
+private:
+
+    BackendLock lock;
+    T *ptr;
+};
+
+} // namespace base
+} // namespace nix
+
+#endif // NIX_THREADING_H
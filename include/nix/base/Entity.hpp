@@ -103,6 +103,15 @@ public:
         ImplContainer<T>::backend()->forceUpdatedAt();
     }
 
+    /**
+     * @brief Sets the time of the last update to the provided value.
+     *
+     * @param t The time of the last update.
+     */
+    void forceUpdatedAt(time_t t) {
+        ImplContainer<T>::backend()->forceUpdatedAt(t);
+    }
+
     /**
      * @brief Sets the creation time to the current time if the creation
      * time is not set.
@@ -121,6 +130,19 @@ public:
         ImplContainer<T>::backend()->forceCreatedAt(t);
     }
 
+    /**
+     * @brief Replaces the id of the entity.
+     *
+     * Meant for copying entities between files, see {@link nix::util::copyFile}.
+     * The id must be unique within the file and has to be set before the
+     * entity is linked to other entities.
+     *
+     * @param id The new id.
+     */
+    void forceId(const std::string &id) {
+        ImplContainer<T>::backend()->forceId(id);
+    }
+
     /**
      *
      */
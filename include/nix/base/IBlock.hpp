@@ -19,6 +19,7 @@
 #include <nix/Compression.hpp>
 #include <nix/NDSize.hpp>
 #include <nix/Identity.hpp>
+#include <nix/util/filter.hpp>
 
 #include <string>
 #include <vector>
@@ -48,6 +49,22 @@ public:
 
     virtual bool removeEntity(const nix::Identity &ident) = 0;
 
+    /**
+     * @brief Get all entities of the given type that match the criterion.
+     *
+     * Backends that can evaluate the criterion without constructing every
+     * entity do so and return true. If they can not, false is returned and
+     * the caller has to fall back to filtering the entities itself.
+     *
+     * @param type      The type of the entities.
+     * @param criterion The criterion to match.
+     * @param entities  The vector the matching entities are appended to.
+     *
+     * @return True if the backend evaluated the criterion.
+     */
+    virtual bool findEntities(ObjectType type, const util::Criterion &criterion,
+                              std::vector<std::shared_ptr<base::IEntity>> &entities) const = 0;
+
     template<typename T>
     std::shared_ptr<T> getEntity(const nix::Identity &ident) const {
         return std::dynamic_pointer_cast<T>(this->getEntity(ident));
@@ -87,7 +104,8 @@ public:
     virtual std::shared_ptr<base::IDataFrame> createDataFrame(const std::string &name,
                                                               const std::string &type,
                                                               const std::vector<Column> &cols,
-                                                              const Compression &compression) = 0;
+                                                              const Compression &compression,
+                                                              DataFrameLayout layout) = 0;
 
     //--------------------------------------------------
     // Methods concerning tags.
@@ -16,6 +16,7 @@
 #include <nix/NDSize.hpp>
 #include <nix/ObjectType.hpp>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -156,6 +157,42 @@ public:
 
     virtual DataType dataType(void) const = 0;
 
+
+    /**
+     * @brief Set the size of the write buffer of this data array, 0 to
+     *        disable buffering.
+     *
+     * @param bytes     The maximum number of bytes held back.
+     */
+    virtual void writeBufferSize(size_t bytes) = 0;
+
+
+    virtual size_t writeBufferSize() const = 0;
+
+
+    /**
+     * @brief Set the size of the read-ahead buffer of this data array, 0 to
+     *        disable reading ahead.
+     *
+     * @param bytes     The maximum number of bytes read ahead.
+     */
+    virtual void readAheadSize(size_t bytes) = 0;
+
+
+    virtual size_t readAheadSize() const = 0;
+
+
+    /**
+     * @brief Map all of the data read-only into memory.
+     *
+     * @param dtype     The type the elements must have in memory.
+     *
+     * @return A pointer to the first element that keeps the mapping alive,
+     *         or an empty pointer if the data is not stored in one piece
+     *         in that type.
+     */
+    virtual std::shared_ptr<const void> mapData(DataType dtype) const = 0;
+
     /**
      * @brief Destructor
      */
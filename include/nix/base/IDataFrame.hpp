@@ -29,6 +29,21 @@ class NIXAPI Column {
 };
 
 
+/**
+ * @brief Storage layout of the data of a DataFrame.
+ *
+ * With `Rows` all columns are stored together as the members of a
+ * single compound dataset, i.e. row by row. With `Columns` every
+ * column is stored in a dataset of its own, which makes reading and
+ * writing single columns cheap and allows each column to be chunked
+ * and compressed independently.
+ */
+enum class DataFrameLayout {
+    Rows = 0,
+    Columns
+};
+
+
 struct Cell : public nix::Variant {
 
     Cell() : Variant(), col(0), name("")
@@ -88,11 +103,102 @@ struct Cell : public nix::Variant {
 };
 
 
+/**
+ * @brief Typed storage for the values of one column of a range of rows.
+ *
+ * The values are stored contiguously as elements of the C++ type that
+ * corresponds to the data type of the column, e.g. `double` for
+ * DataType::Double and `std::string` for DataType::String.
+ */
+class NIXAPI ColumnBuffer {
+public:
+
+    ColumnBuffer() : col_name(""), dtype(DataType::Nothing), n(0)
+    {}
+
+    ColumnBuffer(const std::string &name, DataType dtype, size_t count = 0);
+
+    const std::string &name() const { return col_name; }
+
+    DataType dataType() const { return dtype; }
+
+    size_t size() const { return n; }
+
+    void resize(size_t count);
+
+    void *data();
+
+    const void *data() const;
+
+    /**
+     * @brief Typed access to the values.
+     *
+     * @throws std::invalid_argument if T does not match the data type.
+     */
+    template<typename T>
+    T *values() {
+        checkType(to_data_type<T>::value);
+        return static_cast<T *>(data());
+    }
+
+    template<typename T>
+    const T *values() const {
+        checkType(to_data_type<T>::value);
+        return static_cast<const T *>(data());
+    }
+
+    Variant get(size_t index) const;
+
+    void set(size_t index, const Variant &value);
+
+private:
+
+    void checkType(DataType requested) const;
+
+    std::string              col_name;
+    DataType                 dtype;
+    size_t                   n;
+    std::vector<char>        bytes;
+    std::vector<std::string> strings;
+};
+
+
+/**
+ * @brief A range of rows of a DataFrame, stored column by column.
+ *
+ * Used for batched row I/O, see {@link nix::DataFrame::readRows}.
+ */
+class NIXAPI RowBatch {
+public:
+
+    RowBatch() {}
+
+    explicit RowBatch(const std::vector<Column> &cols, size_t rows = 0);
+
+    /**
+     * @brief The number of rows in the batch.
+     *
+     * @throws std::invalid_argument if the columns differ in size.
+     */
+    size_t rows() const;
+
+    void resize(size_t rows);
+
+    ColumnBuffer &column(const std::string &name);
+
+    const ColumnBuffer &column(const std::string &name) const;
+
+    std::vector<ColumnBuffer> columns;
+};
+
+
 namespace base {
 
 class NIXAPI IDataFrame : virtual public base::IEntityWithSources {
 public:
 
+    virtual DataFrameLayout layout() const = 0;
+
     virtual nix::ndsize_t rows() const = 0;
     virtual void rows(nix::ndsize_t n) = 0;
 
@@ -110,6 +216,8 @@ public:
     virtual std::vector<Cell> readCells(ndsize_t row, const std::vector<std::string> &names) const = 0;
     virtual void writeCells(ndsize_t row, const std::vector<Cell> &cells) = 0;
 
+    virtual void readRows(ndsize_t offset, ndsize_t count, RowBatch &rows) const = 0;
+    virtual void writeRows(ndsize_t offset, const RowBatch &rows) = 0;
 
     virtual void readColumn(const std::string &name,
                             ndsize_t offset,
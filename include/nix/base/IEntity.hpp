@@ -41,11 +41,17 @@ public:
     virtual void forceUpdatedAt() = 0;
 
 
+    virtual void forceUpdatedAt(time_t t) = 0;
+
+
     virtual void setCreatedAt() = 0;
 
 
     virtual void forceCreatedAt(time_t t) = 0;
 
+
+    virtual void forceId(const std::string &id) = 0;
+
     virtual  bool isValidEntity() const = 0;
 
     virtual ~IEntity() {}
@@ -34,8 +34,11 @@ enum class FileMode {
  * @brief Control the open process
  */
 enum class OpenFlags {
-    None  = 0,
-    Force = 1 << 0,
+    None              = 0,
+    Force             = 1 << 0,
+    PropertyTables    = 1 << 1, // new files: store properties in per-section tables
+    IntegerTimestamps = 1 << 2, // new files: store time stamps as 64-bit integers
+    ColumnFrames      = 1 << 3, // file feature only: set when a column-wise DataFrame is created
 };
 
 
@@ -130,6 +133,9 @@ public:
     virtual void forceUpdatedAt() = 0;
 
 
+    virtual void forceUpdatedAt(time_t time) = 0;
+
+
     virtual void setCreatedAt() = 0;
 
 
@@ -13,6 +13,7 @@
 #include <nix/None.hpp>
 #include <nix/Exception.hpp>
 #include <nix/NDSize.hpp>
+#include <nix/Threading.hpp>
 
 #include <memory>
 #include <vector>
@@ -126,7 +127,7 @@ public:
 
 
     virtual ImplContainer<T> &operator=(none_t t) {
-        impl_ptr = nullptr;
+        nullify();
         return *this;
     }
 
@@ -166,7 +167,9 @@ public:
     }
 
 
-    virtual ~ImplContainer() {}
+    virtual ~ImplContainer() {
+        nullify();
+    }
 
 
     const std::shared_ptr<T> & impl() const {
@@ -179,20 +182,31 @@ public:
 
 protected:
 
-    T* backend() {
+    LockedPtr<T> backend() {
         if (isNone()) {
             throw UninitializedEntity();
         }
 
-        return impl_ptr.get();
+        return LockedPtr<T>(impl_ptr.get());
     }
 
-    const T* backend() const {
-        return const_cast<ImplContainer *>(this)->backend();
+    LockedPtr<const T> backend() const {
+        if (isNone()) {
+            throw UninitializedEntity();
+        }
+
+        return LockedPtr<const T>(impl_ptr.get());
     }
 
+    /**
+     * Drops the reference on the backend object, which is destroyed
+     * under the backend lock if this was the last one.
+     */
     void nullify() {
-        impl_ptr = nullptr;
+        if (impl_ptr) {
+            BackendLock lock;
+            impl_ptr = nullptr;
+        }
     }
 
 private:
@@ -0,0 +1,85 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_CONVERT_H
+#define NIX_CONVERT_H
+
+#include <nix/Platform.hpp>
+#include <nix/Compression.hpp>
+#include <nix/File.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace nix {
+namespace util {
+
+/**
+ * @brief Options for copying the contents of a file into another file.
+ */
+struct ConvertOptions {
+
+    /**
+     * The backend of the new file, "hdf5" or "file".
+     */
+    std::string backend = "hdf5";
+
+    /**
+     * The compression of the copied DataArrays and DataFrames; Auto uses
+     * the default of the destination file.
+     */
+    Compression compression = Compression::Auto;
+
+    /**
+     * The number of bytes of data read and written at a time. At most
+     * two blocks of this size are held in memory while copying.
+     */
+    size_t block_bytes = 8 * 1024 * 1024;
+
+    /**
+     * Read the next block of a DataArray while the current one is
+     * written. Only used if not both files use the HDF5 backend, since
+     * the HDF5 library must not be entered from two threads at once.
+     */
+    bool parallel = true;
+};
+
+
+/**
+ * @brief Copy all entities of a file into another file.
+ *
+ * Sections, properties, blocks and everything they contain are copied
+ * with their ids, time stamps and links to each other, so that the
+ * destination can be used in place of the source. The data of DataArrays
+ * and DataFrames is streamed in blocks of opts.block_bytes bytes, so the
+ * memory used does not depend on the size of the data.
+ *
+ * @param source        The file to copy from.
+ * @param destination   The file to copy into, should be empty; opts.backend
+ *                      is ignored.
+ * @param opts          Compression, block size and threading.
+ *
+ * @throws DuplicateName if an entity of the source already exists in the
+ *         destination; errors of the destination backend, e.g. for data
+ *         it cannot store, are passed on.
+ */
+NIXAPI void copyFile(const File &source, File &destination, const ConvertOptions &opts = ConvertOptions());
+
+/**
+ * @brief Copy a file into a new file of the backend given in opts.
+ *
+ * An existing file at path is overwritten.
+ *
+ * @return The new file, open for reading and writing.
+ */
+NIXAPI File convertFile(const File &source, const std::string &path, const ConvertOptions &opts = ConvertOptions());
+
+} // namespace util
+} // namespace nix
+
+#endif // NIX_CONVERT_H
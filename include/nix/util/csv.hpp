@@ -0,0 +1,109 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_CSV_H
+#define NIX_CSV_H
+
+#include <nix/Platform.hpp>
+#include <nix/Block.hpp>
+#include <nix/DataFrame.hpp>
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace nix {
+namespace util {
+
+/**
+ * @brief Options for reading and writing delimited text (CSV, TSV).
+ */
+struct CsvOptions {
+
+    /**
+     * The field separator, e.g. ',' for CSV or '\t' for TSV.
+     */
+    char delimiter = ',';
+
+    /**
+     * Whether the first line holds the column names.
+     */
+    bool header = true;
+
+    /**
+     * The data types of the columns. If empty the types are inferred
+     * from the first infer_rows rows: Int64, Double, Bool (true/false)
+     * or String, in this order of preference. Bool, Int32, UInt32,
+     * Int64, UInt64, Double and String are supported.
+     */
+    std::vector<DataType> dtypes;
+
+    /**
+     * The number of rows used to infer the column types.
+     */
+    size_t infer_rows = 1000;
+
+    /**
+     * The number of rows read or written at a time; bounds the memory used.
+     */
+    size_t batch_rows = 8192;
+};
+
+
+/**
+ * @brief Create a new DataFrame from delimited text.
+ *
+ * The text is parsed independently of the current locale and written
+ * to the DataFrame batch_rows rows at a time. Fields may be quoted with
+ * '"' as in RFC 4180; empty fields are read as NaN in Double columns.
+ * Empty lines are skipped, unless there is a single column: then an
+ * empty line is a record with an empty field.
+ *
+ * @param block    The block to create the DataFrame in.
+ * @param name     The name of the new DataFrame.
+ * @param type     The type of the new DataFrame.
+ * @param in       The text to read.
+ * @param opts     Delimiter, header and column types.
+ *
+ * @return The new DataFrame.
+ *
+ * @throws std::invalid_argument if a line cannot be parsed; the message
+ *         contains the number of the offending line.
+ */
+NIXAPI DataFrame importCsv(Block &block,
+                           const std::string &name,
+                           const std::string &type,
+                           std::istream &in,
+                           const CsvOptions &opts = CsvOptions());
+
+/**
+ * @brief Append delimited text to an existing DataFrame.
+ *
+ * With opts.header, the fields are matched to the columns of the
+ * DataFrame by the names in the header, in any order; without, by
+ * position. The data types of the DataFrame are used for parsing and
+ * opts.dtypes is ignored.
+ *
+ * @return The number of appended rows.
+ */
+NIXAPI ndsize_t importCsv(DataFrame &df, std::istream &in, const CsvOptions &opts = CsvOptions());
+
+/**
+ * @brief Write a DataFrame as delimited text.
+ *
+ * Doubles are written with the shortest of 15 or 17 significant digits
+ * that reads back to the same value, fields that contain the delimiter,
+ * a quote or a line break are quoted.
+ */
+NIXAPI void exportCsv(const DataFrame &df, std::ostream &out, const CsvOptions &opts = CsvOptions());
+
+} // namespace util
+} // namespace nix
+
+#endif // NIX_CSV_H
@@ -15,10 +15,40 @@
 #include <unordered_set>
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <cctype>
 #include <boost/regex.hpp>
+#include <boost/optional.hpp>
 namespace nix {
 namespace util {
 
+/**
+ * Description of one of the standard filters below in terms of the
+ * entity field it checks. Backends can use it to evaluate a filter
+ * while iterating over their storage, i.e. without constructing the
+ * entities first. Use {@link filterCriterion} to obtain it from a filter.
+ */
+struct Criterion {
+
+    enum class Field {
+        Name, Id, Type, Metadata, Source
+    };
+
+    Field field;
+
+    /**
+     * The exact value the field is compared against, if there is a single one
+     * (unset for {@link IdsFilter} and {@link TypeFilter}).
+     */
+    boost::optional<std::string> value;
+
+    /**
+     * Predicate that tests a (name, id, type, ...) value of the field.
+     */
+    std::function<bool(const std::string &)> match;
+};
+
+
 /**
  * Base struct to be inherited by all filter implementations.
  * Child classes will have to implement ()-operator and will
@@ -93,11 +123,16 @@ struct TypeFilter : public Filter<T> {
 
     boost::regex expression;
     bool exact;
+    // set if the pattern has no regex meta characters; then we can
+    // skip compiling the expression and compare strings directly
+    boost::optional<std::string> literal;
 
 
     TypeFilter(const std::string &str, bool exact=true)
         :exact(exact) {
-        if (exact) {
+        if (str.find_first_of(".[]{}()\\*+?|^$") == std::string::npos) {
+            literal = exact ? str : lower(str);
+        } else if (exact) {
             expression = boost::regex(str);
         } else {
             expression = boost::regex(str, boost::regex::icase);
@@ -109,15 +144,30 @@ struct TypeFilter : public Filter<T> {
     {}
 
 
-    virtual bool operator()(const T &e) {
-        if (exact) {
-            return boost::regex_match(e.type(), expression);
+    bool match(const std::string &type) const {
+        if (literal) {
+            return exact ? type == *literal : lower(type).find(*literal) != std::string::npos;
+        } else if (exact) {
+            return boost::regex_match(type, expression);
         } else {
             boost::smatch matches;
-            return boost::regex_search(e.type(), matches, expression);
+            return boost::regex_search(type, matches, expression);
         }
     }
 
+
+    virtual bool operator()(const T &e) {
+        return match(e.type());
+    }
+
+private:
+
+    static std::string lower(std::string str) {
+        std::transform(str.begin(), str.end(), str.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return str;
+    }
+
 };
 
 
@@ -178,6 +228,43 @@ struct SourceFilter : public Filter<T> {
 
 };
 
+
+/**
+ * Get the {@link Criterion} of a filter if it is one of the standard
+ * filters (name, id, ids, type, metadata or source filter).
+ *
+ * @param filter    The filter to inspect.
+ *
+ * @return The criterion of the filter or an unset optional for any other filter.
+ */
+template<typename T>
+boost::optional<Criterion> filterCriterion(const typename Filter<T>::type &filter) {
+    typedef Criterion::Field Field;
+    boost::optional<Criterion> c;
+
+    if (auto f = filter.template target<NameFilter<T>>()) {
+        const std::string name = f->name;
+        c = Criterion{Field::Name, name, [name](const std::string &v) { return v == name; }};
+    } else if (auto f = filter.template target<IdFilter<T>>()) {
+        const std::string id = f->id;
+        c = Criterion{Field::Id, id, [id](const std::string &v) { return v == id; }};
+    } else if (auto f = filter.template target<IdsFilter<T>>()) {
+        const std::unordered_set<std::string> ids = f->ids;
+        c = Criterion{Field::Id, boost::none, [ids](const std::string &v) { return ids.count(v) > 0; }};
+    } else if (auto f = filter.template target<TypeFilter<T>>()) {
+        const TypeFilter<T> tf = *f;
+        c = Criterion{Field::Type, boost::none, [tf](const std::string &v) { return tf.match(v); }};
+    } else if (auto f = filter.template target<MetadataFilter<T>>()) {
+        const std::string id = f->sec_id;
+        c = Criterion{Field::Metadata, id, [id](const std::string &v) { return v == id; }};
+    } else if (auto f = filter.template target<SourceFilter<T>>()) {
+        const std::string id = f->src_id;
+        c = Criterion{Field::Source, id, [id](const std::string &v) { return v == id; }};
+    }
+
+    return c;
+}
+
 } // namespace util
 } // namespace nix
 
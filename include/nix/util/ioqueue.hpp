@@ -0,0 +1,126 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_IOQUEUE_H
+#define NIX_IOQUEUE_H
+
+#include <nix/Platform.hpp>
+#include <nix/DataType.hpp>
+#include <nix/NDSize.hpp>
+#include <nix/Threading.hpp>
+
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace nix {
+
+class DataArray;
+
+namespace util {
+
+struct IOQueueState;
+
+/**
+ * @brief The queue of the asynchronous data access methods of DataArray.
+ *
+ * Requests are run one after another by a single I/O thread, in the order
+ * in which they were submitted; a read therefore sees all writes submitted
+ * before it. Writes and appends to the same DataArray handle that directly
+ * follow each other and continue each other along the first dimension are
+ * merged into a single write, as long as the merged data is not larger than
+ * coalesceBytes(). Each write is checked against the data before it is
+ * merged, so a write that is out of bounds or has the wrong rank only
+ * fails its own future.
+ *
+ * Since the I/O thread calls into the backends while other threads may do
+ * so too, the backend lock (see nix::threadSafe()) is enabled when the
+ * queue is created, i.e. by the first asynchronous call, and stays enabled.
+ * Enabling the lock is only safe while no other thread is inside a call
+ * into the library; a program that uses the library from several threads
+ * has to make its first asynchronous call, or call nix::threadSafe(true),
+ * before it starts the other threads.
+ *
+ * Queued writes are only done, and errors of them only reported through
+ * their futures, once the queue gets to them; File::flush() and
+ * File::close() wait for all requests, see drain().
+ */
+class NIXAPI IOQueue {
+
+public:
+
+    /**
+     * @brief The queue of the process, created on first use.
+     */
+    static IOQueue &instance();
+
+    /**
+     * @brief Queue a write of data to array at offset.
+     *
+     * @param array     The array to write to.
+     * @param dtype     The type of the elements of data.
+     * @param owner     Keeps data valid until the write is done.
+     * @param data      The elements, count.nelms() of them.
+     * @param count     The shape of data.
+     * @param offset    The position of data in the array.
+     *
+     * @return A future that is ready when the data is written.
+     */
+    std::future<void> write(const DataArray &array, DataType dtype, const std::shared_ptr<const void> &owner,
+                            const void *data, const NDSize &count, const NDSize &offset);
+
+    /**
+     * @brief Queue an append of data to array along axis, see
+     *        DataArray::appendData.
+     *
+     * @return A future that is ready when the data is written.
+     */
+    std::future<void> append(const DataArray &array, DataType dtype, const std::shared_ptr<const void> &owner,
+                             const void *data, const NDSize &count, size_t axis);
+
+    /**
+     * @brief Queue any other task, e.g. a read.
+     *
+     * The task has to report its result and errors itself.
+     */
+    void submit(const std::function<void()> &task);
+
+    /**
+     * @brief Block until all requests submitted so far are done.
+     */
+    void wait();
+
+    /**
+     * @brief Like instance().wait(), but without creating the queue if it
+     *        was never used.
+     */
+    static void drain();
+
+    /**
+     * @brief The maximum number of bytes of merged writes.
+     */
+    size_t coalesceBytes() const;
+
+    /**
+     * @brief Set the maximum number of bytes of merged writes; 0 disables
+     *        merging.
+     */
+    void coalesceBytes(size_t bytes);
+
+private:
+
+    IOQueue();
+
+    base::LockingHold hold;
+    std::shared_ptr<IOQueueState> state;
+};
+
+} // namespace util
+} // namespace nix
+
+#endif // NIX_IOQUEUE_H
@@ -11,6 +11,30 @@
 
 namespace nix {
 
+/*
+ * Let the backend evaluate the standard filters (name, id, type, ...)
+ * while iterating over its storage, so that only matching entities
+ * get constructed. Returns false if the filter can not be pushed down.
+ */
+template<typename T>
+static bool findInBackend(const base::IBlock *block, const typename util::Filter<T>::type &filter,
+                          std::vector<T> &result) {
+    typedef typename objectToType<T>::backendType backend_t;
+
+    boost::optional<util::Criterion> criterion = util::filterCriterion<T>(filter);
+    std::vector<std::shared_ptr<base::IEntity>> entities;
+
+    if (!criterion || !block->findEntities(objectToType<T>::value, *criterion, entities)) {
+        return false;
+    }
+
+    for (const auto &e : entities) {
+        result.emplace_back(std::dynamic_pointer_cast<backend_t>(e));
+    }
+
+    return true;
+}
+
 Source Block::createSource(const std::string &name, const std::string &type){
     util::checkEntityNameAndType(name, type);
     if (hasSource(name)) {
@@ -34,6 +58,11 @@ std::vector<Source> Block::findSources(const util::Filter<Source>::type &filter,
 }
 
 std::vector<Source> Block::sources(const util::Filter<Source>::type &filter) const {
+    std::vector<Source> result;
+    if (findInBackend(backend(), filter, result)) {
+        return result;
+    }
+
     auto f = [this](ndsize_t i) { return getSource(i); };
     return getEntities<Source>(f, sourceCount(), filter);
 }
@@ -55,11 +84,21 @@ DataArray Block::createDataArray(const std::string &name, const std::string &typ
 }
 
 std::vector<DataArray> Block::dataArrays(const util::AcceptAll<DataArray>::type &filter) const {
+    std::vector<DataArray> result;
+    if (findInBackend(backend(), filter, result)) {
+        return result;
+    }
+
     auto f = [this] (size_t i) { return getDataArray(i); };
     return getEntities<DataArray>(f, dataArrayCount(), filter);
 }
 
 std::vector<DataFrame> Block::dataFrames(const util::AcceptAll<DataFrame>::type &filter) const {
+    std::vector<DataFrame> result;
+    if (findInBackend(backend(), filter, result)) {
+        return result;
+    }
+
     auto f = [this] (size_t i) { return getDataFrame(i); };
     return getEntities<DataFrame>(f, dataFrameCount(), filter);
 }
@@ -73,6 +112,11 @@ Tag Block::createTag(const std::string &name, const std::string &type, const std
 }
 
 std::vector<Tag> Block::tags(const util::Filter<Tag>::type &filter) const {
+    std::vector<Tag> result;
+    if (findInBackend(backend(), filter, result)) {
+        return result;
+    }
+
     auto f = [this] (ndsize_t i) { return getTag(i); };
     return getEntities<Tag>(f, tagCount(), filter);
 }
@@ -90,6 +134,11 @@ MultiTag Block::createMultiTag(const std::string &name, const std::string &type,
 }
 
 std::vector<MultiTag> Block::multiTags(const util::AcceptAll<MultiTag>::type &filter) const {
+    std::vector<MultiTag> result;
+    if (findInBackend(backend(), filter, result)) {
+        return result;
+    }
+
     auto f = [this] (ndsize_t i) { return getMultiTag(i); };
     return getEntities<MultiTag>(f, multiTagCount(), filter);
 }
@@ -103,6 +152,11 @@ Group Block::createGroup(const std::string &name, const std::string &type) {
 }
 
 std::vector<Group> Block::groups(const util::AcceptAll<Group>::type &filter) const {
+    std::vector<Group> result;
+    if (findInBackend(backend(), filter, result)) {
+        return result;
+    }
+
     auto f = [this] (ndsize_t i) { return getGroup(i); };
     return getEntities<Group>(f, groupCount(), filter);
 }
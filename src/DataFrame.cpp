@@ -8,4 +8,284 @@
 
 #include <nix/DataFrame.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace nix;
+
+
+ColumnBuffer::ColumnBuffer(const std::string &name, DataType dtype, size_t count)
+    : col_name(name), dtype(dtype), n(0)
+{
+    if (!Variant::supports_type(dtype)) {
+        throw std::invalid_argument("Unsupported DataType for column " + name);
+    }
+
+    resize(count);
+}
+
+
+void ColumnBuffer::resize(size_t count) {
+    if (dtype == DataType::String) {
+        strings.resize(count);
+    } else {
+        bytes.resize(count * data_type_to_size(dtype));
+    }
+    n = count;
+}
+
+
+void *ColumnBuffer::data() {
+    if (dtype == DataType::String) {
+        return strings.data();
+    }
+    return bytes.data();
+}
+
+
+const void *ColumnBuffer::data() const {
+    if (dtype == DataType::String) {
+        return strings.data();
+    }
+    return bytes.data();
+}
+
+
+void ColumnBuffer::checkType(DataType requested) const {
+    if (requested != dtype) {
+        throw std::invalid_argument("Requested type does not match the DataType of column " + col_name);
+    }
+}
+
+
+template<typename T>
+static Variant get_value(const char *mem, size_t index) {
+    T val;
+    std::memcpy(&val, mem + index * sizeof(T), sizeof(T));
+    return Variant(val);
+}
+
+
+template<typename T>
+static void set_value(char *mem, size_t index, const Variant &value) {
+    T val;
+    value.get(val);
+    std::memcpy(mem + index * sizeof(T), &val, sizeof(T));
+}
+
+
+Variant ColumnBuffer::get(size_t index) const {
+    if (index >= n) {
+        throw OutOfBounds("Index out of bounds of the column", index);
+    }
+
+    const char *mem = bytes.data();
+    switch (dtype) {
+        case DataType::Bool:   return get_value<bool>(mem, index);
+        case DataType::Int32:  return get_value<int32_t>(mem, index);
+        case DataType::UInt32: return get_value<uint32_t>(mem, index);
+        case DataType::Int64:  return get_value<int64_t>(mem, index);
+        case DataType::UInt64: return get_value<uint64_t>(mem, index);
+        case DataType::Double: return get_value<double>(mem, index);
+        case DataType::String: return Variant(strings[index]);
+        default: break;
+    }
+
+    throw std::invalid_argument("Unhandled DataType");
+}
+
+
+void ColumnBuffer::set(size_t index, const Variant &value) {
+    if (index >= n) {
+        throw OutOfBounds("Index out of bounds of the column", index);
+    }
+
+    char *mem = bytes.data();
+    switch (dtype) {
+        case DataType::Bool:   set_value<bool>(mem, index, value);     break;
+        case DataType::Int32:  set_value<int32_t>(mem, index, value);  break;
+        case DataType::UInt32: set_value<uint32_t>(mem, index, value); break;
+        case DataType::Int64:  set_value<int64_t>(mem, index, value);  break;
+        case DataType::UInt64: set_value<uint64_t>(mem, index, value); break;
+        case DataType::Double: set_value<double>(mem, index, value);   break;
+        case DataType::String: value.get(strings[index]);              break;
+        default: throw std::invalid_argument("Unhandled DataType");
+    }
+}
+
+
+RowBatch::RowBatch(const std::vector<Column> &cols, size_t rows) {
+    columns.reserve(cols.size());
+    for (const Column &c : cols) {
+        columns.emplace_back(c.name, c.dtype, rows);
+    }
+}
+
+
+size_t RowBatch::rows() const {
+    if (columns.empty()) {
+        return 0;
+    }
+
+    size_t n = columns[0].size();
+    for (const ColumnBuffer &c : columns) {
+        if (c.size() != n) {
+            throw std::invalid_argument("RowBatch: columns differ in size");
+        }
+    }
+
+    return n;
+}
+
+
+void RowBatch::resize(size_t rows) {
+    for (ColumnBuffer &c : columns) {
+        c.resize(rows);
+    }
+}
+
+
+ColumnBuffer &RowBatch::column(const std::string &name) {
+    const RowBatch *self = this;
+    return const_cast<ColumnBuffer &>(self->column(name));
+}
+
+
+const ColumnBuffer &RowBatch::column(const std::string &name) const {
+    auto it = std::find_if(columns.cbegin(), columns.cend(), [&name](const ColumnBuffer &c) {
+        return c.name() == name;
+    });
+
+    if (it == columns.cend()) {
+        throw std::invalid_argument("RowBatch: no column named " + name);
+    }
+
+    return *it;
+}
+
+
+// a batch with the given columns of the data frame
+static RowBatch make_batch(const std::vector<Column> &cols, const std::vector<std::string> &names) {
+    std::vector<Column> selected;
+
+    for (const std::string &name : names) {
+        auto it = std::find_if(cols.cbegin(), cols.cend(), [&name](const Column &c) {
+            return c.name == name;
+        });
+
+        if (it == cols.cend()) {
+            throw std::invalid_argument("DataFrame: no column named " + name);
+        }
+        selected.push_back(*it);
+    }
+
+    return RowBatch(selected);
+}
+
+
+std::vector<ndsize_t> DataFrame::select(const RowPredicate &pred, ndsize_t chunk) const {
+    std::vector<std::string> names = pred.columns();
+    if (names.empty()) {
+        throw std::invalid_argument("DataFrame::select: predicate does not refer to any column");
+    }
+    if (chunk == 0) {
+        throw std::invalid_argument("DataFrame::select: chunk size must not be 0");
+    }
+
+    RowBatch batch = make_batch(columns(), names);
+    std::vector<uint8_t> mask;
+    std::vector<ndsize_t> index;
+    const ndsize_t n = rows();
+
+    for (ndsize_t offset = 0; offset < n; offset += chunk) {
+        readColumns(batch, offset, std::min(chunk, n - offset));
+        pred.evaluate(batch, mask);
+
+        for (size_t i = 0; i < mask.size(); i++) {
+            if (mask[i]) {
+                index.push_back(offset + i);
+            }
+        }
+    }
+
+    return index;
+}
+
+
+// append the values of the rows selected by mask to dst, starting at index at
+static void append_selected(const ColumnBuffer &src, const std::vector<uint8_t> &mask,
+                            ColumnBuffer &dst, size_t at) {
+    const size_t n = mask.size();
+
+    if (src.dataType() == DataType::String) {
+        const std::string *from = src.values<std::string>();
+        std::string *to = dst.values<std::string>() + at;
+        for (size_t i = 0; i < n; i++) {
+            if (mask[i]) {
+                *to++ = from[i];
+            }
+        }
+        return;
+    }
+
+    const size_t es = data_type_to_size(src.dataType());
+    const char *from = static_cast<const char *>(src.data());
+    char *to = static_cast<char *>(dst.data()) + at * es;
+    for (size_t i = 0; i < n; i++) {
+        if (mask[i]) {
+            std::memcpy(to, from + i * es, es);
+            to += es;
+        }
+    }
+}
+
+
+RowBatch DataFrame::selectRows(const RowPredicate &pred, const std::vector<std::string> &names, ndsize_t chunk) const {
+    std::vector<std::string> pred_names = pred.columns();
+    if (pred_names.empty()) {
+        throw std::invalid_argument("DataFrame::selectRows: predicate does not refer to any column");
+    }
+    if (chunk == 0) {
+        throw std::invalid_argument("DataFrame::selectRows: chunk size must not be 0");
+    }
+
+    std::vector<Column> cols = columns();
+    std::vector<std::string> out_names = names;
+    if (out_names.empty()) {
+        for (const Column &c : cols) {
+            out_names.push_back(c.name);
+        }
+    }
+
+    // read the columns of the predicate and of the result in one go
+    std::vector<std::string> scan_names = out_names;
+    for (const std::string &name : pred_names) {
+        if (std::find(scan_names.cbegin(), scan_names.cend(), name) == scan_names.cend()) {
+            scan_names.push_back(name);
+        }
+    }
+
+    RowBatch batch = make_batch(cols, scan_names);
+    RowBatch result = make_batch(cols, out_names);
+    std::vector<uint8_t> mask;
+    size_t matched = 0;
+    const ndsize_t n = rows();
+
+    for (ndsize_t offset = 0; offset < n; offset += chunk) {
+        readColumns(batch, offset, std::min(chunk, n - offset));
+        pred.evaluate(batch, mask);
+
+        const size_t k = static_cast<size_t>(std::count(mask.cbegin(), mask.cend(), 1));
+        if (k == 0) {
+            continue;
+        }
+
+        result.resize(matched + k);
+        for (size_t c = 0; c < result.columns.size(); c++) {
+            append_selected(batch.columns[c], mask, result.columns[c], matched);
+        }
+        matched += k;
+    }
+
+    return result;
+}
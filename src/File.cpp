@@ -8,6 +8,7 @@
 
 #include <nix/File.hpp>
 #include <nix/util/util.hpp>
+#include <nix/util/ioqueue.hpp>
 #include "hdf5/FileHDF5.hpp"
 
 #ifdef ENABLE_FS_BACKEND
@@ -26,12 +27,13 @@ File File::open(const std::string &name,
                 const std::string &impl,
                 Compression compression,
                 OpenFlags flags) {
-    if (mode == nix::FileMode::ReadOnly && !bfs::exists({name})) {
+    if (mode == nix::FileMode::ReadOnly && !bfs::exists(name)) {
         throw std::runtime_error("Cannot open non-existent file in ReadOnly mode!");
     }
     if (compression == Compression::Auto) {
          compression = Compression::None;
     }
+    base::BackendLock lock;
     if (impl == "hdf5") {
         return File(std::make_shared<hdf5::FileHDF5>(name, mode, compression, flags));
     }
@@ -47,6 +49,8 @@ File File::open(const std::string &name,
 
 
 bool File::flush() {
+    // queued writes are done first, they may be to this file
+    util::IOQueue::drain();
     return backend()->flush();
 }
 
@@ -206,6 +210,7 @@ valid::Result File::validate() const {
 
 void File::close() {
     if (!isNone()) {
+        util::IOQueue::drain();
         backend()->close();
         nullify();
     }
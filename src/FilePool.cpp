@@ -0,0 +1,158 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include <nix/FilePool.hpp>
+#include <nix/Threading.hpp>
+#include "hdf5/FileHDF5.hpp"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace nix {
+
+struct FilePool::Slot {
+    File file;
+    bool used;
+    std::map<std::string, DataArray> arrays;
+};
+
+
+struct FilePool::State {
+    // before the slots, so that the files are closed under the lock
+    std::unique_ptr<base::LockingHold> hold;
+    std::vector<Slot> slots;
+    bool concurrent;
+    std::mutex mutex;
+    std::condition_variable released;
+};
+
+
+FilePool::FilePool(const std::string &path, size_t size, const std::string &impl)
+    : state(std::make_shared<State>())
+{
+    if (size < 1) {
+        throw std::invalid_argument("FilePool: at least one file handle is needed");
+    }
+
+    // the file backend keeps process wide caches that are only safe under the lock
+    state->concurrent = impl == "hdf5" && hdf5::FileHDF5::libraryThreadSafe() && !threadSafe();
+    if (!state->concurrent) {
+        state->hold.reset(new base::LockingHold());
+    }
+
+    state->slots.resize(size);
+    for (Slot &slot : state->slots) {
+        slot.file = File::open(path, FileMode::ReadOnly, impl);
+        slot.used = false;
+    }
+}
+
+
+FilePool::FilePool(const File &file, size_t size)
+    : FilePool(file.location(), size,
+               std::dynamic_pointer_cast<hdf5::FileHDF5>(file.impl()) ? "hdf5" : "file")
+{
+}
+
+
+size_t FilePool::size() const {
+    return state->slots.size();
+}
+
+
+bool FilePool::concurrent() const {
+    return state->concurrent;
+}
+
+
+FilePool::Handle FilePool::acquire() {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    for (;;) {
+        for (size_t i = 0; i < state->slots.size(); i++) {
+            if (!state->slots[i].used) {
+                state->slots[i].used = true;
+                return Handle(state, i);
+            }
+        }
+        state->released.wait(lock);
+    }
+}
+
+
+std::unique_ptr<FilePool::Handle> FilePool::tryAcquire() {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    for (size_t i = 0; i < state->slots.size(); i++) {
+        if (!state->slots[i].used) {
+            state->slots[i].used = true;
+            return std::unique_ptr<Handle>(new Handle(state, i));
+        }
+    }
+    return std::unique_ptr<Handle>();
+}
+
+
+FilePool::Handle::Handle(const std::shared_ptr<State> &state, size_t index)
+    : state(state), index(index)
+{
+}
+
+
+FilePool::Handle::Handle(Handle &&other)
+    : state(std::move(other.state)), index(other.index)
+{
+}
+
+
+File FilePool::Handle::file() const {
+    return state->slots[index].file;
+}
+
+
+Block FilePool::Handle::block(const std::string &id) const {
+    return state->slots[index].file.getBlock(id);
+}
+
+
+DataArray FilePool::Handle::dataArray(const std::string &id) const {
+    Slot &slot = state->slots[index];
+    auto it = slot.arrays.find(id);
+    if (it != slot.arrays.end()) {
+        return it->second;
+    }
+
+    DataArray da;
+    for (const Block &b : slot.file.blocks()) {
+        da = b.getDataArray(id);
+        if (da) {
+            slot.arrays[id] = da;
+            break;
+        }
+    }
+    return da;
+}
+
+
+DataArray FilePool::Handle::dataArray(const DataArray &other) const {
+    return dataArray(other.id());
+}
+
+
+FilePool::Handle::~Handle() {
+    if (state) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->slots[index].used = false;
+        }
+        state->released.notify_one();
+    }
+}
+
+} // namespace nix
@@ -14,7 +14,7 @@ using namespace nix;
 template<typename T>
 void Group::replaceEntities(const std::vector<T> &entities)
 {
-    base::IGroup *ig = backend();
+    auto ig = backend();
     ObjectType ot = objectToType<T>::value;
 
     while (ig->entityCount(ot) > 0) {
@@ -9,27 +9,109 @@
 
 #include <nix/NDArray.hpp>
 
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <algorithm>
+
 namespace nix {
 
 
-NDArray::NDArray(DataType dtype, NDSize dims) : dataType(dtype), extends(dims) {
-    allocate_space();
+NDArray::NDArray(DataType dtype, NDSize dims)
+    : dataType(dtype), extends(dims), dstore(nullptr), nbytes(0), capacity(0), block(nullptr) {
+    allocate_space(true);
 }
 
 
-void NDArray::allocate_space() {
+NDArray::NDArray(const NDArray &other)
+    : dataType(other.dataType), extends(other.extends), dstore(nullptr), nbytes(0), capacity(0), block(nullptr) {
+    allocate_space(false);
+    memcpy(dstore, other.dstore, nbytes);
+}
+
+
+NDArray::NDArray(NDArray &&other)
+    : dataType(other.dataType), extends(std::move(other.extends)), strides(std::move(other.strides)),
+      dstore(other.dstore), nbytes(other.nbytes), capacity(other.capacity), block(other.block) {
+    other.dstore = nullptr;
+    other.nbytes = 0;
+    other.capacity = 0;
+    other.block = nullptr;
+}
+
+
+NDArray &NDArray::operator=(const NDArray &other) {
+    if (this != &other) {
+        dataType = other.dataType;
+        extends = other.extends;
+        allocate_space(false);
+        memcpy(dstore, other.dstore, nbytes);
+    }
+    return *this;
+}
+
+
+NDArray &NDArray::operator=(NDArray &&other) {
+    if (this != &other) {
+        release();
+        dataType = other.dataType;
+        extends = std::move(other.extends);
+        strides = std::move(other.strides);
+        dstore = other.dstore;
+        nbytes = other.nbytes;
+        capacity = other.capacity;
+        block = other.block;
+        other.dstore = nullptr;
+        other.nbytes = 0;
+        other.capacity = 0;
+        other.block = nullptr;
+    }
+    return *this;
+}
+
+
+void NDArray::allocate_space(bool zero) {
     size_t type_size = data_type_to_size(dataType);
-	ndsize_t bytes = extends.nelms() * type_size;
-	size_t alloc_size = check::fits_in_size_t(bytes, "Cannot allocate storage (exceeds memory)");
-    dstore.resize(alloc_size);
+    ndsize_t bytes = extends.nelms() * type_size;
+    size_t alloc_size = check::fits_in_size_t(bytes, "Cannot allocate storage (exceeds memory)");
+
+    if (alloc_size > capacity || !block) {
+        // over-allocate and align by hand, aligned_alloc is not in C++11
+        void *raw = std::malloc(alloc_size + alignment - 1);
+        if (!raw) {
+            throw std::bad_alloc();
+        }
+        uintptr_t addr = (reinterpret_cast<uintptr_t>(raw) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        byte_type *aligned = reinterpret_cast<byte_type *>(addr);
+        if (dstore) {
+            memcpy(aligned, dstore, std::min(nbytes, alloc_size));
+        }
+        release();
+        block = raw;
+        dstore = aligned;
+        capacity = alloc_size;
+    }
+    nbytes = alloc_size;
+
+    if (zero) {
+        memset(dstore, 0, nbytes);
+    }
 
     calc_strides();
 }
 
 
+void NDArray::release() {
+    std::free(block);
+    block = nullptr;
+    dstore = nullptr;
+    capacity = 0;
+}
+
+
 void NDArray::resize(const NDSize &new_size) {
     extends = new_size;
-    allocate_space();
+    allocate_space(false);
 }
 
 
@@ -52,4 +134,137 @@ size_t NDArray::sub2index(const NDSize &sub) const {
     return idx;
 }
 
+
+NDArrayView NDArray::view() {
+    return NDArrayView(dataType, dstore, extends, strides);
+}
+
+
+NDArray::~NDArray() {
+    release();
+}
+
+/* ******************************************* */
+
+NDArrayView::NDArrayView(DataType dtype, byte_type *data, const NDSize &shape, const NDSize &strides)
+    : dataType(dtype), ptr(data), extends(shape), strides(strides) {
+    if (shape.size() != strides.size()) {
+        throw IncompatibleDimensions("Shape and strides have different ranks", "NDArrayView");
+    }
+}
+
+
+size_t NDArrayView::offset(const NDSize &index) const {
+    ndsize_t pos = strides.dot(index) * data_type_to_size(dataType);
+    return check::fits_in_size_t(pos, "index does not fit into memory");
+}
+
+
+NDArrayView NDArrayView::slice(size_t axis, ndsize_t start, ndsize_t count) const {
+    if (axis >= rank()) {
+        throw OutOfBounds("Axis is outside of the view", axis);
+    }
+    if (start + count > extends[axis]) {
+        throw OutOfBounds("Slice exceeds the view", start + count);
+    }
+
+    NDSize shape = extends;
+    shape[axis] = count;
+    size_t skip = check::fits_in_size_t(start * strides[axis] * data_type_to_size(dataType),
+                                        "index does not fit into memory");
+    return NDArrayView(dataType, ptr + skip, shape, strides);
+}
+
+
+NDArrayView NDArrayView::transpose() const {
+    NDSize shape(extends.size());
+    NDSize stride(strides.size());
+    std::reverse_copy(extends.begin(), extends.end(), shape.begin());
+    std::reverse_copy(strides.begin(), strides.end(), stride.begin());
+    return NDArrayView(dataType, ptr, shape, stride);
+}
+
+
+NDArrayView NDArrayView::transpose(size_t a, size_t b) const {
+    if (a >= rank() || b >= rank()) {
+        throw OutOfBounds("Axis is outside of the view", std::max(a, b));
+    }
+
+    NDSize shape = extends;
+    NDSize stride = strides;
+    std::swap(shape[a], shape[b]);
+    std::swap(stride[a], stride[b]);
+    return NDArrayView(dataType, ptr, shape, stride);
+}
+
+
+bool NDArrayView::contiguous() const {
+    ndsize_t expected = 1;
+    for (size_t i = rank(); i > 0; i--) {
+        // the stride of an axis with a single element does not matter
+        if (extends[i - 1] != 1 && strides[i - 1] != expected) {
+            return false;
+        }
+        expected *= extends[i - 1];
+    }
+    return true;
+}
+
+
+// copies between the view and a row-major buffer, one innermost run at a time
+static void copy_strided(const NDArrayView &view, NDArrayView::byte_type *buffer, bool into_view) {
+    const size_t esize = data_type_to_size(view.dtype());
+    const size_t nelms = check::fits_in_size_t(view.num_elements(), "view does not fit into memory");
+    if (nelms == 0) {
+        return;
+    }
+
+    const size_t rank = view.rank();
+    const NDSize shape = view.shape();
+    const NDSize strides = view.stride();
+    const size_t inner = rank > 0 ? static_cast<size_t>(shape[rank - 1]) : 1;
+    const size_t inner_stride = rank > 0 ? static_cast<size_t>(strides[rank - 1]) * esize : 0;
+    const size_t run = inner * esize;
+
+    NDSize index(rank, 0);
+    for (size_t done = 0; done < nelms; done += inner) {
+        NDArrayView::byte_type *elm = view.data() + static_cast<size_t>(strides.dot(index)) * esize;
+
+        if (inner_stride == esize) {
+            if (into_view) {
+                memcpy(elm, buffer, run);
+            } else {
+                memcpy(buffer, elm, run);
+            }
+            buffer += run;
+        } else {
+            for (size_t i = 0; i < inner; i++, elm += inner_stride, buffer += esize) {
+                if (into_view) {
+                    memcpy(elm, buffer, esize);
+                } else {
+                    memcpy(buffer, elm, esize);
+                }
+            }
+        }
+
+        // next run: count up the index over all but the innermost axis
+        for (size_t i = rank > 0 ? rank - 1 : 0; i > 0; i--) {
+            if (++index[i - 1] < shape[i - 1]) {
+                break;
+            }
+            index[i - 1] = 0;
+        }
+    }
+}
+
+
+void NDArrayView::copyTo(void *dest) const {
+    copy_strided(*this, static_cast<byte_type *>(dest), false);
+}
+
+
+void NDArrayView::copyFrom(const void *src) const {
+    copy_strided(*this, static_cast<byte_type *>(const_cast<void *>(src)), true);
+}
+
 } // namespace nix
@@ -0,0 +1,414 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include <nix/RowPredicate.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace nix;
+
+
+RowPredicate::RowPredicate(Op op, const Operand &lhs, const Operand &rhs)
+    : oper(op), operands({lhs, rhs})
+{
+    if (op == Op::And || op == Op::Or || op == Op::Not) {
+        throw std::invalid_argument("RowPredicate: not a comparison operator");
+    }
+}
+
+
+RowPredicate::RowPredicate(Op op, const RowPredicate &lhs, const RowPredicate &rhs)
+    : oper(op), left(std::make_shared<RowPredicate>(lhs)), right(std::make_shared<RowPredicate>(rhs))
+{
+    if (op != Op::And && op != Op::Or) {
+        throw std::invalid_argument("RowPredicate: expected And or Or");
+    }
+}
+
+
+RowPredicate::RowPredicate(Op op, const RowPredicate &p)
+    : oper(op), left(std::make_shared<RowPredicate>(p))
+{
+    if (op != Op::Not) {
+        throw std::invalid_argument("RowPredicate: expected Not");
+    }
+}
+
+
+std::vector<std::string> RowPredicate::columns() const {
+    std::vector<std::string> names;
+
+    for (const Operand &o : operands) {
+        if (o.isColumn()) {
+            names.push_back(o.column);
+        }
+    }
+
+    for (const auto &p : {left, right}) {
+        if (p) {
+            std::vector<std::string> sub = p->columns();
+            names.insert(names.end(), sub.begin(), sub.end());
+        }
+    }
+
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return names;
+}
+
+
+void RowPredicate::evaluate(const RowBatch &batch, std::vector<uint8_t> &mask) const {
+    switch (oper) {
+    case Op::And:
+    case Op::Or: {
+        std::vector<uint8_t> other;
+        left->evaluate(batch, mask);
+        right->evaluate(batch, other);
+
+        const size_t n = mask.size();
+        uint8_t *m = mask.data();
+        const uint8_t *o = other.data();
+        if (oper == Op::And) {
+            for (size_t i = 0; i < n; i++) m[i] &= o[i];
+        } else {
+            for (size_t i = 0; i < n; i++) m[i] |= o[i];
+        }
+        break;
+    }
+
+    case Op::Not: {
+        left->evaluate(batch, mask);
+
+        const size_t n = mask.size();
+        uint8_t *m = mask.data();
+        for (size_t i = 0; i < n; i++) m[i] ^= 1;
+        break;
+    }
+
+    default:
+        compare(batch, mask);
+    }
+}
+
+// The comparison kernels below are plain loops over contiguous values
+// that write one byte per row, so that the compiler can vectorize them.
+
+namespace {
+
+typedef RowPredicate::Op Op;
+
+enum class Kind {
+    Signed, Unsigned, Float, Bool, String
+};
+
+
+Kind kind_of(DataType dtype) {
+    switch (dtype) {
+    case DataType::Bool:   return Kind::Bool;
+    case DataType::Int32:
+    case DataType::Int64:  return Kind::Signed;
+    case DataType::UInt32:
+    case DataType::UInt64: return Kind::Unsigned;
+    case DataType::Double: return Kind::Float;
+    case DataType::String: return Kind::String;
+    default: throw std::invalid_argument("RowPredicate: unsupported data type " + data_type_to_string(dtype));
+    }
+}
+
+
+// the type both sides of a comparison are converted to
+DataType common_type(DataType a, DataType b) {
+    Kind ka = kind_of(a);
+    Kind kb = kind_of(b);
+
+    if (ka == Kind::String || kb == Kind::String) {
+        if (ka != kb) {
+            throw std::invalid_argument("RowPredicate: cannot compare strings with numbers");
+        }
+        return DataType::String;
+    }
+
+    if (ka == Kind::Float || kb == Kind::Float) {
+        return DataType::Double;
+    }
+
+    if ((ka == Kind::Signed || ka == Kind::Bool) && (kb == Kind::Signed || kb == Kind::Bool)) {
+        return DataType::Int64;
+    }
+
+    if ((ka == Kind::Unsigned || ka == Kind::Bool) && (kb == Kind::Unsigned || kb == Kind::Bool)) {
+        return DataType::UInt64;
+    }
+
+    // signed vs unsigned, there is no common type; see compare_mixed
+    throw std::logic_error("RowPredicate: no common type for signed and unsigned integers");
+}
+
+
+bool mixed_signs(DataType a, DataType b) {
+    Kind ka = kind_of(a);
+    Kind kb = kind_of(b);
+    return (ka == Kind::Signed && kb == Kind::Unsigned) || (ka == Kind::Unsigned && kb == Kind::Signed);
+}
+
+
+Op mirror(Op op) {
+    switch (op) {
+    case Op::Less:         return Op::Greater;
+    case Op::LessEqual:    return Op::GreaterEqual;
+    case Op::Greater:      return Op::Less;
+    case Op::GreaterEqual: return Op::LessEqual;
+    default:               return op;
+    }
+}
+
+
+// the order of a signed and an unsigned value, exact for all values:
+// negative values are smaller, all others are compared as uint64
+inline int order(int64_t x, uint64_t y) {
+    if (x < 0) {
+        return -1;
+    }
+    const uint64_t ux = static_cast<uint64_t>(x);
+    return ux < y ? -1 : (ux > y ? 1 : 0);
+}
+
+
+template<typename W, typename T>
+void convert(const void *data, size_t n, std::vector<W> &out) {
+    const T *src = static_cast<const T *>(data);
+    out.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = static_cast<W>(src[i]);
+    }
+}
+
+
+// the values of a column as W, converted into tmp if the column type differs
+template<typename W>
+const W *column_values(const ColumnBuffer &col, std::vector<W> &tmp) {
+    const DataType dtype = col.dataType();
+    const size_t n = col.size();
+
+    if (dtype == to_data_type<W>::value) {
+        return static_cast<const W *>(col.data());
+    }
+
+    switch (dtype) {
+    case DataType::Bool:   convert<W, bool>(col.data(), n, tmp);     break;
+    case DataType::Int32:  convert<W, int32_t>(col.data(), n, tmp);  break;
+    case DataType::UInt32: convert<W, uint32_t>(col.data(), n, tmp); break;
+    case DataType::Int64:  convert<W, int64_t>(col.data(), n, tmp);  break;
+    case DataType::UInt64: convert<W, uint64_t>(col.data(), n, tmp); break;
+    case DataType::Double: convert<W, double>(col.data(), n, tmp);   break;
+    default: throw std::invalid_argument("RowPredicate: unsupported column type");
+    }
+
+    return tmp.data();
+}
+
+
+template<>
+const std::string *column_values<std::string>(const ColumnBuffer &col, std::vector<std::string> &tmp) {
+    return col.values<std::string>();
+}
+
+
+template<typename W>
+W constant_value(const Variant &v) {
+    switch (v.type()) {
+    case DataType::Bool:   return static_cast<W>(v.get<bool>());
+    case DataType::Int32:  return static_cast<W>(v.get<int32_t>());
+    case DataType::UInt32: return static_cast<W>(v.get<uint32_t>());
+    case DataType::Int64:  return static_cast<W>(v.get<int64_t>());
+    case DataType::UInt64: return static_cast<W>(v.get<uint64_t>());
+    case DataType::Double: return static_cast<W>(v.get<double>());
+    default: throw std::invalid_argument("RowPredicate: unsupported constant type");
+    }
+}
+
+
+template<>
+std::string constant_value<std::string>(const Variant &v) {
+    return v.get<std::string>();
+}
+
+
+// B is either const W * (column vs column) or W (column vs constant)
+template<typename W>
+const W &rhs_at(const W *b, size_t i) { return b[i]; }
+
+template<typename W>
+const W &rhs_at(const W &b, size_t) { return b; }
+
+
+template<typename W, typename B>
+void compare_values(Op op, const W *a, const B &b, uint8_t *out, size_t n) {
+    switch (op) {
+    case Op::Equal:
+        for (size_t i = 0; i < n; i++) out[i] = a[i] == rhs_at(b, i);
+        break;
+    case Op::NotEqual:
+        for (size_t i = 0; i < n; i++) out[i] = a[i] != rhs_at(b, i);
+        break;
+    case Op::Less:
+        for (size_t i = 0; i < n; i++) out[i] = a[i] < rhs_at(b, i);
+        break;
+    case Op::LessEqual:
+        for (size_t i = 0; i < n; i++) out[i] = a[i] <= rhs_at(b, i);
+        break;
+    case Op::Greater:
+        for (size_t i = 0; i < n; i++) out[i] = a[i] > rhs_at(b, i);
+        break;
+    case Op::GreaterEqual:
+        for (size_t i = 0; i < n; i++) out[i] = a[i] >= rhs_at(b, i);
+        break;
+    default:
+        throw std::invalid_argument("RowPredicate: not a comparison operator");
+    }
+}
+
+
+// A is int64_t and B uint64_t, each as a pointer (column) or a value (constant)
+template<typename A, typename B>
+void compare_mixed(Op op, const A &a, const B &b, uint8_t *out, size_t n) {
+    switch (op) {
+    case Op::Equal:
+        for (size_t i = 0; i < n; i++) out[i] = order(rhs_at(a, i), rhs_at(b, i)) == 0;
+        break;
+    case Op::NotEqual:
+        for (size_t i = 0; i < n; i++) out[i] = order(rhs_at(a, i), rhs_at(b, i)) != 0;
+        break;
+    case Op::Less:
+        for (size_t i = 0; i < n; i++) out[i] = order(rhs_at(a, i), rhs_at(b, i)) < 0;
+        break;
+    case Op::LessEqual:
+        for (size_t i = 0; i < n; i++) out[i] = order(rhs_at(a, i), rhs_at(b, i)) <= 0;
+        break;
+    case Op::Greater:
+        for (size_t i = 0; i < n; i++) out[i] = order(rhs_at(a, i), rhs_at(b, i)) > 0;
+        break;
+    case Op::GreaterEqual:
+        for (size_t i = 0; i < n; i++) out[i] = order(rhs_at(a, i), rhs_at(b, i)) >= 0;
+        break;
+    default:
+        throw std::invalid_argument("RowPredicate: not a comparison operator");
+    }
+}
+
+
+// compare_mixed for a signed (lhs) and an unsigned (rhs) operand
+template<typename B>
+void compare_mixed_with(Op op, const RowPredicate::Operand &lhs, const B &b,
+                        const RowBatch &batch, std::vector<uint8_t> &mask) {
+    if (lhs.isColumn()) {
+        std::vector<int64_t> tmp;
+        compare_mixed(op, column_values<int64_t>(batch.column(lhs.column), tmp), b, mask.data(), mask.size());
+    } else {
+        compare_mixed(op, constant_value<int64_t>(lhs.value), b, mask.data(), mask.size());
+    }
+}
+
+
+void compare_mixed_operands(Op op, const RowPredicate::Operand &lhs, const RowPredicate::Operand &rhs,
+                            const RowBatch &batch, std::vector<uint8_t> &mask) {
+    if (rhs.isColumn()) {
+        std::vector<uint64_t> tmp;
+        compare_mixed_with(op, lhs, column_values<uint64_t>(batch.column(rhs.column), tmp), batch, mask);
+    } else {
+        compare_mixed_with(op, lhs, constant_value<uint64_t>(rhs.value), batch, mask);
+    }
+}
+
+
+template<typename W>
+void compare_typed(Op op, const RowPredicate::Operand &lhs, const RowPredicate::Operand &rhs,
+                   const RowBatch &batch, std::vector<uint8_t> &mask) {
+    std::vector<W> tmp_a;
+    const W *a = column_values<W>(batch.column(lhs.column), tmp_a);
+
+    if (rhs.isColumn()) {
+        std::vector<W> tmp_b;
+        const W *b = column_values<W>(batch.column(rhs.column), tmp_b);
+        compare_values(op, a, b, mask.data(), mask.size());
+    } else {
+        const W b = constant_value<W>(rhs.value);
+        compare_values(op, a, b, mask.data(), mask.size());
+    }
+}
+
+
+template<typename W>
+bool compare_constants(Op op, const Variant &a, const Variant &b) {
+    W x = constant_value<W>(a);
+    W y = constant_value<W>(b);
+    uint8_t res;
+    compare_values(op, &x, y, &res, 1);
+    return res != 0;
+}
+
+} // anonymous namespace
+
+
+void RowPredicate::compare(const RowBatch &batch, std::vector<uint8_t> &mask) const {
+    Op op = oper;
+    const Operand *lhs = &operands[0];
+    const Operand *rhs = &operands[1];
+
+    // columns go to the left
+    if (!lhs->isColumn() && rhs->isColumn()) {
+        std::swap(lhs, rhs);
+        op = mirror(op);
+    }
+
+    auto type_of = [&batch](const Operand &o) {
+        return o.isColumn() ? batch.column(o.column).dataType() : o.value.type();
+    };
+
+    mask.resize(batch.rows());
+
+    // signed vs unsigned integers are compared exactly, the signed one
+    // goes to the left
+    if (mixed_signs(type_of(*lhs), type_of(*rhs))) {
+        if (kind_of(type_of(*lhs)) == Kind::Unsigned) {
+            std::swap(lhs, rhs);
+            op = mirror(op);
+        }
+        if (!lhs->isColumn() && !rhs->isColumn()) {
+            uint8_t res;
+            compare_mixed(op, constant_value<int64_t>(lhs->value), constant_value<uint64_t>(rhs->value), &res, 1);
+            std::fill(mask.begin(), mask.end(), res);
+        } else {
+            compare_mixed_operands(op, *lhs, *rhs, batch, mask);
+        }
+        return;
+    }
+
+    const DataType ct = common_type(type_of(*lhs), type_of(*rhs));
+
+    if (!lhs->isColumn()) {
+        // constant expression
+        bool res;
+        switch (ct) {
+        case DataType::Int64:  res = compare_constants<int64_t>(op, lhs->value, rhs->value);     break;
+        case DataType::UInt64: res = compare_constants<uint64_t>(op, lhs->value, rhs->value);    break;
+        case DataType::String: res = compare_constants<std::string>(op, lhs->value, rhs->value); break;
+        default:               res = compare_constants<double>(op, lhs->value, rhs->value);
+        }
+        std::fill(mask.begin(), mask.end(), res ? 1 : 0);
+        return;
+    }
+
+    switch (ct) {
+    case DataType::Int64:  compare_typed<int64_t>(op, *lhs, *rhs, batch, mask);     break;
+    case DataType::UInt64: compare_typed<uint64_t>(op, *lhs, *rhs, batch, mask);    break;
+    case DataType::String: compare_typed<std::string>(op, *lhs, *rhs, batch, mask); break;
+    default:               compare_typed<double>(op, *lhs, *rhs, batch, mask);
+    }
+}
@@ -197,27 +197,26 @@ std::vector<Property> Section::inheritedProperties() const {
 // Operators and other functions
 //------------------------------------------------------
 
-size_t Section::tree_depth() const{
-  const std::vector<Section> children = sections();
-  size_t depth = 0;
-  if (children.size() > 0) {
-      for (auto &child : children) {
-          depth = std::max(depth, child.tree_depth());
-      }
-      depth += 1;
-  }
-  return depth;
-}
-
-
 std::vector<Section> Section::findDownstream(const std::function<bool(Section)> &filter) const {
     std::vector<Section> results;
-    size_t max_depth = tree_depth();
-    size_t actual_depth = 1;
-    while (results.size() == 0 && actual_depth <= max_depth) {
-        results = findSections(filter, actual_depth);
-        actual_depth += 1;
+    std::vector<Section> level = sections();
+
+    // walk the tree level by level and stop at the first level that has
+    // matches; every subsection list is read at most once
+    while (!level.empty()) {
+        std::copy_if(level.begin(), level.end(), std::back_inserter(results), filter);
+        if (!results.empty()) {
+            break;
+        }
+
+        std::vector<Section> next;
+        for (const auto &s : level) {
+            std::vector<Section> children = s.sections();
+            next.insert(next.end(), children.begin(), children.end());
+        }
+        level.swap(next);
     }
+
     return results;
 }
 
@@ -239,21 +238,12 @@ std::vector<Section> Section::findAmongParents(const std::function<bool(Section)
 
 std::vector<Section> Section::findSideways(const std::function<bool(Section)> &filter, const std::string &caller_id) const{
     std::vector<Section> results;
-    Section p = parent();
-    if (p != none) {
-        results = p.findSections(filter,1);
+    for (Section p = parent(); p != none; p = p.parent()) {
+        results = p.sections(filter);
         if (results.size() > 0) {
-
-            results.erase(remove_if(results.begin(),
-                                    results.end(),
-                                    [&caller_id](const Section &section) {
-                                        return section.id() == caller_id;
-                                    }),
-                          results.end());
-
-            return results;
+            erase_section_with_id(results, caller_id);
+            break;
         }
-        return p.findSideways(filter, caller_id);
     }
     return results;
 }
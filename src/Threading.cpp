@@ -0,0 +1,80 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include <nix/Threading.hpp>
+
+#include <atomic>
+#include <mutex>
+
+#ifndef NIX_THREAD_SAFE
+#define NIX_THREAD_SAFE 0
+#endif
+
+namespace nix {
+
+namespace {
+
+// never destroyed, entities may still be released by static destructors
+std::recursive_mutex &backend_mutex() {
+    static std::recursive_mutex *mutex = new std::recursive_mutex();
+    return *mutex;
+}
+
+std::atomic<bool> locking(NIX_THREAD_SAFE != 0);
+
+// number of LockingHold objects
+std::atomic<int> holds(0);
+
+}
+
+
+void threadSafe(bool enable) {
+    locking.store(enable);
+}
+
+
+bool threadSafe() {
+    return locking.load() || holds.load() > 0;
+}
+
+namespace base {
+
+BackendLock::BackendLock()
+    : locked(locking.load(std::memory_order_relaxed) || holds.load(std::memory_order_relaxed) > 0)
+{
+    if (locked) {
+        backend_mutex().lock();
+    }
+}
+
+
+BackendLock::BackendLock(BackendLock &&other)
+    : locked(other.locked)
+{
+    other.locked = false;
+}
+
+
+BackendLock::~BackendLock() {
+    if (locked) {
+        backend_mutex().unlock();
+    }
+}
+
+
+LockingHold::LockingHold() {
+    holds.fetch_add(1);
+}
+
+
+LockingHold::~LockingHold() {
+    holds.fetch_sub(1);
+}
+
+} // namespace base
+} // namespace nix
@@ -0,0 +1,544 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include <nix/util/convert.hpp>
+
+#include <nix/Block.hpp>
+#include <nix/DataArray.hpp>
+#include <nix/DataFrame.hpp>
+#include <nix/Feature.hpp>
+#include <nix/Group.hpp>
+#include <nix/MultiTag.hpp>
+#include <nix/Property.hpp>
+#include <nix/Section.hpp>
+#include <nix/Source.hpp>
+#include <nix/Tag.hpp>
+
+#include "hdf5/FileHDF5.hpp"
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nix {
+namespace util {
+
+namespace {
+
+// assumed size of a string element when splitting data into blocks
+const size_t STRING_SIZE = 64;
+
+
+struct Context {
+    ConvertOptions opts;
+    bool           overlap;
+};
+
+
+size_t element_size(DataType dtype) {
+    return dtype == DataType::String ? STRING_SIZE : data_type_to_size(dtype);
+}
+
+
+/*
+ * Give the copy the id of the original; must happen before the copy is
+ * linked to anything, links refer to entities by id.
+ */
+template<typename T>
+void adopt(const T &src, T &dst) {
+    dst.forceId(src.id());
+}
+
+
+/*
+ * Set the time stamps of the copy to those of the original; must happen
+ * after the copy is complete, since every change updates the time stamp.
+ */
+template<typename T>
+void stamp(const T &src, T &dst) {
+    dst.forceCreatedAt(src.createdAt());
+    dst.forceUpdatedAt(src.updatedAt());
+}
+
+
+template<typename T>
+void copy_definition(const T &src, T &dst) {
+    boost::optional<std::string> definition = src.definition();
+    if (definition) {
+        dst.definition(*definition);
+    }
+}
+
+
+template<typename T>
+void copy_metadata(const T &src, T &dst) {
+    Section metadata = src.metadata();
+    if (metadata) {
+        dst.metadata(metadata.id());
+    }
+}
+
+
+template<typename T>
+void copy_sources(const T &src, T &dst) {
+    for (ndsize_t i = 0; i < src.sourceCount(); i++) {
+        dst.addSource(src.getSource(static_cast<size_t>(i)).id());
+    }
+}
+
+//
+// Metadata
+//
+
+void copy_property(const Property &src, Section &section) {
+    Property dst = section.createProperty(src.name(), src.dataType());
+    adopt(src, dst);
+    copy_definition(src, dst);
+
+    boost::optional<std::string> unit = src.unit();
+    if (unit) {
+        dst.unit(*unit);
+    }
+    boost::optional<double> uncertainty = src.uncertainty();
+    if (uncertainty) {
+        dst.uncertainty(*uncertainty);
+    }
+    if (src.valueCount() > 0) {
+        dst.values(src.values());
+    }
+
+    stamp(src, dst);
+}
+
+
+/*
+ * Sections link to other sections anywhere in the file, the links are
+ * set once all sections exist.
+ */
+struct SectionLink {
+    Section src;
+    Section dst;
+};
+
+
+template<typename P>
+void copy_section(const Section &src, P &parent, std::vector<SectionLink> &sections) {
+    Section dst = parent.createSection(src.name(), src.type());
+    adopt(src, dst);
+    copy_definition(src, dst);
+
+    boost::optional<std::string> repository = src.repository();
+    if (repository) {
+        dst.repository(*repository);
+    }
+
+    for (ndsize_t i = 0; i < src.propertyCount(); i++) {
+        copy_property(src.getProperty(i), dst);
+    }
+    for (ndsize_t i = 0; i < src.sectionCount(); i++) {
+        copy_section(src.getSection(i), dst, sections);
+    }
+
+    if (src.link()) {
+        sections.push_back(SectionLink{src, dst});
+    } else {
+        stamp(src, dst);
+    }
+}
+
+//
+// Data
+//
+
+/*
+ * The data of a DataArray in the type of the DataArray, strings are
+ * stored as std::string as the backends expect them.
+ */
+class DataBuffer {
+
+public:
+
+    DataBuffer(DataType dtype, ndsize_t count) : dtype(dtype) {
+        size_t n = check::fits_in_size_t(count, "Block of data exceeds memory");
+        if (dtype == DataType::String) {
+            strings.resize(n);
+        } else {
+            bytes.resize(n * data_type_to_size(dtype));
+        }
+    }
+
+    void *data() {
+        return dtype == DataType::String ? static_cast<void *>(strings.data()) : bytes.data();
+    }
+
+private:
+
+    DataType                 dtype;
+    std::vector<char>        bytes;
+    std::vector<std::string> strings;
+};
+
+
+struct Selection {
+    NDSize offset;
+    NDSize count;
+};
+
+
+/*
+ * Split the extent into blocks of at most block_bytes bytes (but at least
+ * one element); the blocks span whole rows of the trailing dimensions if
+ * possible, so that they are contiguous in both files.
+ */
+std::vector<Selection> split(const NDSize &extent, size_t esize, size_t block_bytes) {
+    std::vector<Selection> blocks;
+    const size_t rank = extent.size();
+    if (rank == 0 || extent.nelms() == 0) {
+        return blocks;
+    }
+
+    NDSize count(extent);
+    ndsize_t bytes = esize;
+    for (size_t d = rank; d-- > 0;) {
+        if (bytes * extent[d] <= block_bytes) {
+            bytes *= extent[d];
+            continue;
+        }
+        count[d] = std::max<ndsize_t>(1, block_bytes / bytes);
+        for (size_t i = 0; i < d; i++) {
+            count[i] = 1;
+        }
+        break;
+    }
+
+    NDSize offset(rank, 0);
+    while (true) {
+        Selection sel{offset, count};
+        for (size_t i = 0; i < rank; i++) {
+            sel.count[i] = std::min(count[i], extent[i] - offset[i]);
+        }
+        blocks.push_back(sel);
+
+        size_t d = rank;
+        bool done = true;
+        while (d-- > 0) {
+            offset[d] += count[d];
+            if (offset[d] < extent[d]) {
+                done = false;
+                break;
+            }
+            offset[d] = 0;
+        }
+        if (done) {
+            return blocks;
+        }
+    }
+}
+
+
+/*
+ * Copy the data block by block; with ctx.overlap the next block is read
+ * in a second thread while the current one is written.
+ */
+void copy_data(const DataArray &src, DataArray &dst, const Context &ctx) {
+    const DataType dtype = src.dataType();
+    const std::vector<Selection> blocks = split(src.dataExtent(), element_size(dtype), ctx.opts.block_bytes);
+    if (blocks.empty()) {
+        return;
+    }
+
+    // polynomials and expansion origin are copied as they are, not applied
+    auto read = [src, dtype](const Selection &sel) {
+        DataBuffer buffer(dtype, sel.count.nelms());
+        src.getDataDirect(dtype, buffer.data(), sel.count, sel.offset);
+        return buffer;
+    };
+
+    const std::launch policy = ctx.overlap ? std::launch::async : std::launch::deferred;
+    DataBuffer current = read(blocks[0]);
+    for (size_t i = 0; i < blocks.size(); i++) {
+        std::future<DataBuffer> next;
+        if (i + 1 < blocks.size()) {
+            next = std::async(policy, read, blocks[i + 1]);
+        }
+        dst.setDataDirect(dtype, current.data(), blocks[i].count, blocks[i].offset);
+        if (next.valid()) {
+            current = next.get();
+        }
+    }
+}
+
+
+void copy_dimension(const Dimension &src, DataArray &dst) {
+    switch (src.dimensionType()) {
+        case DimensionType::Sample: {
+            SampledDimension s = src.asSampledDimension();
+            SampledDimension d = dst.appendSampledDimension(s.samplingInterval());
+            if (s.label()) {
+                d.label(*s.label());
+            }
+            if (s.unit()) {
+                d.unit(*s.unit());
+            }
+            if (s.offset()) {
+                d.offset(*s.offset());
+            }
+            break;
+        }
+        case DimensionType::Set: {
+            dst.appendSetDimension(src.asSetDimension().labels());
+            break;
+        }
+        case DimensionType::Range: {
+            RangeDimension s = src.asRangeDimension();
+            if (s.alias()) {
+                dst.appendAliasRangeDimension();
+                break;
+            }
+            RangeDimension d = dst.appendRangeDimension(s.ticks());
+            if (s.label()) {
+                d.label(*s.label());
+            }
+            if (s.unit()) {
+                d.unit(*s.unit());
+            }
+            break;
+        }
+    }
+}
+
+
+void copy_data_array(const DataArray &src, Block &block, const Context &ctx) {
+    DataArray dst = block.createDataArray(src.name(), src.type(), src.dataType(), src.dataExtent(),
+                                          ctx.opts.compression);
+    adopt(src, dst);
+    copy_definition(src, dst);
+    copy_metadata(src, dst);
+    copy_sources(src, dst);
+
+    if (src.label()) {
+        dst.label(*src.label());
+    }
+    if (src.unit()) {
+        dst.unit(*src.unit());
+    }
+    if (src.expansionOrigin()) {
+        dst.expansionOrigin(*src.expansionOrigin());
+    }
+    std::vector<double> coefficients = src.polynomCoefficients();
+    if (coefficients.size()) {
+        dst.polynomCoefficients(coefficients, ctx.opts.compression);
+    }
+
+    for (ndsize_t i = 1; i <= src.dimensionCount(); i++) {
+        copy_dimension(src.getDimension(i), dst);
+    }
+
+    copy_data(src, dst, ctx);
+    stamp(src, dst);
+}
+
+
+void copy_data_frame(const DataFrame &src, Block &block, const Context &ctx) {
+    const std::vector<Column> cols = src.columns();
+    DataFrame dst = block.createDataFrame(src.name(), src.type(), cols, ctx.opts.compression, src.layout());
+    adopt(src, dst);
+    copy_definition(src, dst);
+    copy_metadata(src, dst);
+    copy_sources(src, dst);
+
+    size_t row_bytes = 0;
+    for (const Column &col : cols) {
+        row_bytes += element_size(col.dtype);
+    }
+    const ndsize_t batch = std::max<ndsize_t>(1, ctx.opts.block_bytes / std::max<size_t>(row_bytes, 1));
+
+    const ndsize_t rows = src.rows();
+    for (ndsize_t offset = 0; offset < rows; offset += batch) {
+        dst.appendRows(src.readRows(offset, std::min(batch, rows - offset)));
+    }
+
+    stamp(src, dst);
+}
+
+//
+// Tags, groups and sources
+//
+
+template<typename T>
+void copy_features(const T &src, T &dst) {
+    for (ndsize_t i = 0; i < src.featureCount(); i++) {
+        Feature sf = src.getFeature(static_cast<size_t>(i));
+        Feature df = dst.createFeature(sf.data().id(), sf.linkType());
+        adopt(sf, df);
+        stamp(sf, df);
+    }
+}
+
+
+void copy_tag(const Tag &src, Block &block) {
+    Tag dst = block.createTag(src.name(), src.type(), src.position());
+    adopt(src, dst);
+    copy_definition(src, dst);
+    copy_metadata(src, dst);
+    copy_sources(src, dst);
+
+    std::vector<double> extent = src.extent();
+    if (extent.size()) {
+        dst.extent(extent);
+    }
+    std::vector<std::string> units = src.units();
+    if (units.size()) {
+        dst.units(units);
+    }
+    for (ndsize_t i = 0; i < src.referenceCount(); i++) {
+        dst.addReference(src.getReference(static_cast<size_t>(i)).id());
+    }
+    copy_features(src, dst);
+
+    stamp(src, dst);
+}
+
+
+void copy_multi_tag(const MultiTag &src, Block &block) {
+    MultiTag dst = block.createMultiTag(src.name(), src.type(), block.getDataArray(src.positions().id()));
+    adopt(src, dst);
+    copy_definition(src, dst);
+    copy_metadata(src, dst);
+    copy_sources(src, dst);
+
+    DataArray extents = src.extents();
+    if (extents) {
+        dst.extents(extents.id());
+    }
+    std::vector<std::string> units = src.units();
+    if (units.size()) {
+        dst.units(units);
+    }
+    for (ndsize_t i = 0; i < src.referenceCount(); i++) {
+        dst.addReference(src.getReference(static_cast<size_t>(i)).id());
+    }
+    copy_features(src, dst);
+
+    stamp(src, dst);
+}
+
+
+void copy_group(const Group &src, Block &block) {
+    Group dst = block.createGroup(src.name(), src.type());
+    adopt(src, dst);
+    copy_definition(src, dst);
+    copy_metadata(src, dst);
+    copy_sources(src, dst);
+
+    for (ndsize_t i = 0; i < src.dataArrayCount(); i++) {
+        dst.addDataArray(src.getDataArray(static_cast<size_t>(i)).id());
+    }
+    for (ndsize_t i = 0; i < src.dataFrameCount(); i++) {
+        dst.addDataFrame(src.getDataFrame(i).id());
+    }
+    for (ndsize_t i = 0; i < src.tagCount(); i++) {
+        dst.addTag(src.getTag(static_cast<size_t>(i)).id());
+    }
+    for (ndsize_t i = 0; i < src.multiTagCount(); i++) {
+        dst.addMultiTag(src.getMultiTag(static_cast<size_t>(i)).id());
+    }
+
+    stamp(src, dst);
+}
+
+
+template<typename P>
+void copy_source(const Source &src, P &parent) {
+    Source dst = parent.createSource(src.name(), src.type());
+    adopt(src, dst);
+    copy_definition(src, dst);
+    copy_metadata(src, dst);
+
+    for (ndsize_t i = 0; i < src.sourceCount(); i++) {
+        copy_source(src.getSource(i), dst);
+    }
+
+    stamp(src, dst);
+}
+
+
+/*
+ * Entities are created in an order in which everything they link to
+ * already exists: sources, data arrays and data frames, then the tags
+ * that refer to them and finally the groups.
+ */
+void copy_block(const Block &src, File &file, const Context &ctx) {
+    Block dst = file.createBlock(src.name(), src.type());
+    adopt(src, dst);
+    copy_definition(src, dst);
+    copy_metadata(src, dst);
+
+    for (ndsize_t i = 0; i < src.sourceCount(); i++) {
+        copy_source(src.getSource(i), dst);
+    }
+    for (ndsize_t i = 0; i < src.dataArrayCount(); i++) {
+        copy_data_array(src.getDataArray(i), dst, ctx);
+    }
+    for (ndsize_t i = 0; i < src.dataFrameCount(); i++) {
+        copy_data_frame(src.getDataFrame(i), dst, ctx);
+    }
+    for (ndsize_t i = 0; i < src.tagCount(); i++) {
+        copy_tag(src.getTag(i), dst);
+    }
+    for (ndsize_t i = 0; i < src.multiTagCount(); i++) {
+        copy_multi_tag(src.getMultiTag(i), dst);
+    }
+    for (ndsize_t i = 0; i < src.groupCount(); i++) {
+        copy_group(src.getGroup(i), dst);
+    }
+
+    stamp(src, dst);
+}
+
+
+bool is_hdf5(const File &file) {
+    return std::dynamic_pointer_cast<hdf5::FileHDF5>(file.impl()) != nullptr;
+}
+
+} // anonymous namespace
+
+
+void copyFile(const File &source, File &destination, const ConvertOptions &opts) {
+    Context ctx{opts, opts.parallel && !(is_hdf5(source) && is_hdf5(destination))};
+
+    std::vector<SectionLink> links;
+    for (ndsize_t i = 0; i < source.sectionCount(); i++) {
+        copy_section(source.getSection(i), destination, links);
+    }
+    for (SectionLink &link : links) {
+        link.dst.link(link.src.link().id());
+        stamp(link.src, link.dst);
+    }
+
+    for (ndsize_t i = 0; i < source.blockCount(); i++) {
+        copy_block(source.getBlock(i), destination, ctx);
+    }
+
+    destination.forceCreatedAt(source.createdAt());
+    destination.forceUpdatedAt(source.updatedAt());
+}
+
+
+File convertFile(const File &source, const std::string &path, const ConvertOptions &opts) {
+    File destination = File::open(path, FileMode::Overwrite, opts.backend, opts.compression);
+    copyFile(source, destination, opts);
+    destination.flush();
+    return destination;
+}
+
+} // namespace util
+} // namespace nix
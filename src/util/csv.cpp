@@ -0,0 +1,690 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include <nix/util/csv.hpp>
+
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace nix {
+namespace util {
+
+//
+// Locale independent number parsing
+//
+
+static bool equals_nocase(const char *s, size_t n, const char *word) {
+    if (std::strlen(word) != n) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        char c = s[i];
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+        if (c != word[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static bool parse_uint64(const char *s, size_t n, uint64_t &out) {
+    if (n == 0) {
+        return false;
+    }
+
+    uint64_t v = 0;
+    const uint64_t max = std::numeric_limits<uint64_t>::max();
+    for (size_t i = 0; i < n; i++) {
+        unsigned d = static_cast<unsigned char>(s[i]) - '0';
+        if (d > 9 || v > (max - d) / 10) {
+            return false;
+        }
+        v = v * 10 + d;
+    }
+
+    out = v;
+    return true;
+}
+
+
+static bool parse_int64(const char *s, size_t n, int64_t &out) {
+    bool neg = n > 0 && s[0] == '-';
+    if (n > 0 && (s[0] == '-' || s[0] == '+')) {
+        s++;
+        n--;
+    }
+
+    uint64_t v;
+    if (!parse_uint64(s, n, v)) {
+        return false;
+    }
+
+    const uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + (neg ? 1 : 0);
+    if (v > limit) {
+        return false;
+    }
+
+    out = neg ? static_cast<int64_t>(0 - v) : static_cast<int64_t>(v);
+    return true;
+}
+
+
+static bool parse_double_slow(const char *s, size_t n, double &out) {
+    std::istringstream ss(std::string(s, n));
+    ss.imbue(std::locale::classic());
+    ss >> out;
+    return !ss.fail() && ss.peek() == std::char_traits<char>::eof();
+}
+
+
+static bool parse_double(const char *s, size_t n, double &out) {
+    static const double pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    if (n == 0) {
+        out = std::numeric_limits<double>::quiet_NaN();
+        return true;
+    }
+
+    const char *p = s;
+    const char *end = s + n;
+    bool neg = *p == '-';
+    if (*p == '-' || *p == '+') {
+        p++;
+    }
+
+    if (equals_nocase(p, end - p, "nan")) {
+        out = std::numeric_limits<double>::quiet_NaN();
+        return true;
+    }
+    if (equals_nocase(p, end - p, "inf") || equals_nocase(p, end - p, "infinity")) {
+        out = neg ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+        return true;
+    }
+
+    // mantissa of up to 19 significant digits and a decimal exponent
+    uint64_t mant = 0;
+    int digits = 0;
+    int exp10 = 0;
+    bool any = false;
+    bool exact = true;
+
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        any = true;
+        if (digits < 19) {
+            mant = mant * 10 + static_cast<unsigned>(*p - '0');
+            digits += mant != 0;
+        } else {
+            exp10++;
+            exact = false;
+        }
+    }
+
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+            any = true;
+            if (digits < 19) {
+                mant = mant * 10 + static_cast<unsigned>(*p - '0');
+                digits += mant != 0;
+                exp10--;
+            } else {
+                exact = false;
+            }
+        }
+    }
+
+    if (!any) {
+        return false;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool eneg = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+')) {
+            p++;
+        }
+
+        int e = 0;
+        const char *estart = p;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (e < 100000) {
+                e = e * 10 + (*p - '0');
+            }
+        }
+        if (p == estart) {
+            return false;
+        }
+        exp10 += eneg ? -e : e;
+    }
+
+    if (p != end) {
+        return false;
+    }
+
+    // exact if mantissa and power of ten are both exactly representable
+    if (exact && mant <= (uint64_t(1) << 53) && exp10 >= -22 && exp10 <= 22) {
+        double v = static_cast<double>(mant);
+        v = exp10 < 0 ? v / pow10[-exp10] : v * pow10[exp10];
+        out = neg ? -v : v;
+        return true;
+    }
+
+    return parse_double_slow(s, n, out);
+}
+
+
+static bool parse_bool(const char *s, size_t n, bool &out) {
+    if (equals_nocase(s, n, "true") || (n == 1 && s[0] == '1')) {
+        out = true;
+        return true;
+    }
+    if (equals_nocase(s, n, "false") || (n == 1 && s[0] == '0')) {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+//
+// Records
+//
+
+/**
+ * Splits the input into records of fields, handles quoted fields
+ * that contain delimiters, quotes or line breaks.
+ */
+class RecordReader {
+public:
+
+    RecordReader(std::istream &in, char delimiter)
+        : in(in), delimiter(delimiter), lineno(0), blank_records(false)
+    {}
+
+    // with a single column a blank line is a record of one empty field,
+    // otherwise blank lines are skipped
+    void singleColumn(bool single) {
+        blank_records = single;
+    }
+
+    // reads the next record, false at the end of the input
+    bool next(std::vector<std::string> &fields) {
+        do {
+            if (!std::getline(in, line)) {
+                return false;
+            }
+            lineno++;
+            chomp(line);
+        } while (line.empty() && !blank_records);
+
+        record_line = lineno;
+        size_t count = 0;
+        size_t pos = 0;
+
+        while (true) {
+            if (count == fields.size()) {
+                fields.emplace_back();
+            }
+            std::string &field = fields[count++];
+
+            if (pos < line.size() && line[pos] == '"') {
+                pos = readQuoted(field, pos + 1);
+            } else {
+                size_t stop = line.find(delimiter, pos);
+                if (stop == std::string::npos) {
+                    stop = line.size();
+                }
+                field.assign(line, pos, stop - pos);
+                pos = stop;
+            }
+
+            if (pos >= line.size()) {
+                break;
+            }
+            if (line[pos] != delimiter) {
+                throw std::invalid_argument("CSV line " + std::to_string(lineno) + ": unexpected character after quoted field");
+            }
+            pos++;
+
+            if (pos == line.size()) {
+                // trailing delimiter, i.e. a last empty field
+                if (count == fields.size()) {
+                    fields.emplace_back();
+                }
+                fields[count++].clear();
+                break;
+            }
+        }
+
+        fields.resize(count);
+        return true;
+    }
+
+    // line number of the start of the last record
+    size_t line_number() const {
+        return record_line;
+    }
+
+private:
+
+    static void chomp(std::string &str) {
+        if (!str.empty() && str.back() == '\r') {
+            str.pop_back();
+        }
+    }
+
+    // reads a quoted field starting after the opening quote, continues
+    // with the next lines if the field contains line breaks
+    size_t readQuoted(std::string &field, size_t pos) {
+        field.clear();
+
+        while (true) {
+            size_t q = line.find('"', pos);
+            if (q == std::string::npos) {
+                field.append(line, pos, std::string::npos);
+                field += '\n';
+
+                std::string cont;
+                if (!std::getline(in, cont)) {
+                    throw std::invalid_argument("CSV line " + std::to_string(record_line) + ": unterminated quoted field");
+                }
+                lineno++;
+                chomp(cont);
+                line.swap(cont);
+                pos = 0;
+                continue;
+            }
+
+            field.append(line, pos, q - pos);
+            if (q + 1 < line.size() && line[q + 1] == '"') {
+                field += '"';
+                pos = q + 2;
+            } else {
+                return q + 1;
+            }
+        }
+    }
+
+    std::istream &in;
+    char          delimiter;
+    std::string   line;
+    size_t        lineno;
+    size_t        record_line = 0;
+    bool          blank_records;
+};
+
+
+static std::invalid_argument parse_error(size_t line, const std::string &value, const Column &col) {
+    return std::invalid_argument("CSV line " + std::to_string(line) + ": cannot read '" + value +
+                                 "' as " + data_type_to_string(col.dtype) + " (column " + col.name + ")");
+}
+
+
+static void parse_field(const std::string &value, ColumnBuffer &buf, size_t i, const Column &col, size_t line) {
+    const char *s = value.data();
+    const size_t n = value.size();
+    bool ok = false;
+
+    switch (col.dtype) {
+    case DataType::Bool:
+        ok = parse_bool(s, n, static_cast<bool *>(buf.data())[i]);
+        break;
+    case DataType::Int32: {
+        int64_t v = 0;
+        ok = parse_int64(s, n, v) && v >= std::numeric_limits<int32_t>::min() && v <= std::numeric_limits<int32_t>::max();
+        if (ok) {
+            static_cast<int32_t *>(buf.data())[i] = static_cast<int32_t>(v);
+        }
+        break;
+    }
+    case DataType::UInt32: {
+        uint64_t v = 0;
+        ok = parse_uint64(s, n, v) && v <= std::numeric_limits<uint32_t>::max();
+        if (ok) {
+            static_cast<uint32_t *>(buf.data())[i] = static_cast<uint32_t>(v);
+        }
+        break;
+    }
+    case DataType::Int64:
+        ok = parse_int64(s, n, static_cast<int64_t *>(buf.data())[i]);
+        break;
+    case DataType::UInt64:
+        ok = parse_uint64(s, n, static_cast<uint64_t *>(buf.data())[i]);
+        break;
+    case DataType::Double:
+        ok = parse_double(s, n, static_cast<double *>(buf.data())[i]);
+        break;
+    case DataType::String:
+        static_cast<std::string *>(buf.data())[i] = value;
+        ok = true;
+        break;
+    default:
+        // rejected by check_columns
+        throw std::invalid_argument("Unsupported DataType for column " + col.name);
+    }
+
+    if (!ok) {
+        throw parse_error(line, value, col);
+    }
+}
+
+
+// the types parse_field can read, which are also those of ColumnBuffer
+static void check_columns(const std::vector<Column> &cols) {
+    for (const Column &col : cols) {
+        switch (col.dtype) {
+        case DataType::Bool:
+        case DataType::Int32:
+        case DataType::UInt32:
+        case DataType::Int64:
+        case DataType::UInt64:
+        case DataType::Double:
+        case DataType::String:
+            break;
+        default:
+            throw std::invalid_argument("CSV: unsupported data type " + data_type_to_string(col.dtype) +
+                                        " for column " + col.name);
+        }
+    }
+}
+
+
+static DataType infer_type(const std::vector<std::vector<std::string>> &records, size_t col) {
+    bool is_int = true, is_double = true, is_bool = true;
+    bool any = false, have_empty = false;
+
+    for (const std::vector<std::string> &rec : records) {
+        if (col >= rec.size()) {
+            continue;
+        }
+
+        const std::string &value = rec[col];
+        if (value.empty()) {
+            have_empty = true;
+            continue;
+        }
+
+        any = true;
+        int64_t i;
+        double d;
+        bool b;
+        is_int = is_int && parse_int64(value.data(), value.size(), i);
+        is_double = is_double && parse_double(value.data(), value.size(), d);
+        is_bool = is_bool && parse_bool(value.data(), value.size(), b);
+    }
+
+    if (!any) {
+        return DataType::String;
+    }
+
+    // empty fields can only be represented as NaN
+    if (is_int && !have_empty) {
+        return DataType::Int64;
+    } else if (is_double) {
+        return DataType::Double;
+    } else if (is_bool && !have_empty) {
+        return DataType::Bool;
+    }
+
+    return DataType::String;
+}
+
+
+// parse the pending and all remaining records into the data frame;
+// column c is read from field order[c] of each record
+static ndsize_t import_records(DataFrame &df, const std::vector<Column> &cols,
+                               const std::vector<size_t> &order, RecordReader &reader,
+                               const std::vector<std::vector<std::string>> &pending,
+                               const std::vector<size_t> &pending_lines, size_t batch_rows) {
+    if (batch_rows == 0) {
+        throw std::invalid_argument("CSV: batch_rows must not be 0");
+    }
+
+    RowBatch batch(cols, batch_rows);
+    size_t k = 0;
+    ndsize_t total = 0;
+
+    auto add = [&](const std::vector<std::string> &rec, size_t line) {
+        if (rec.size() != cols.size()) {
+            throw std::invalid_argument("CSV line " + std::to_string(line) + ": expected " +
+                                        std::to_string(cols.size()) + " fields, got " + std::to_string(rec.size()));
+        }
+
+        for (size_t c = 0; c < cols.size(); c++) {
+            parse_field(rec[order[c]], batch.columns[c], k, cols[c], line);
+        }
+
+        if (++k == batch_rows) {
+            df.appendRows(batch);
+            total += k;
+            k = 0;
+        }
+    };
+
+    for (size_t i = 0; i < pending.size(); i++) {
+        add(pending[i], pending_lines[i]);
+    }
+
+    std::vector<std::string> fields;
+    while (reader.next(fields)) {
+        add(fields, reader.line_number());
+    }
+
+    if (k > 0) {
+        batch.resize(k);
+        df.appendRows(batch);
+        total += k;
+    }
+
+    return total;
+}
+
+
+DataFrame importCsv(Block &block, const std::string &name, const std::string &type,
+                    std::istream &in, const CsvOptions &opts) {
+    RecordReader reader(in, opts.delimiter);
+    std::vector<std::string> names;
+
+    if (opts.header && !reader.next(names)) {
+        throw std::invalid_argument("CSV: missing header line");
+    }
+    if (opts.header || !opts.dtypes.empty()) {
+        reader.singleColumn((opts.header ? names.size() : opts.dtypes.size()) == 1);
+    }
+
+    // keep the first rows to infer the column types (or, without a
+    // header, the number of columns) from
+    std::vector<std::vector<std::string>> pending;
+    std::vector<size_t> pending_lines;
+    const size_t keep = opts.dtypes.empty() ? std::max<size_t>(opts.infer_rows, 1) : (opts.header ? 0 : 1);
+
+    std::vector<std::string> fields;
+    while (pending.size() < keep && reader.next(fields)) {
+        pending.push_back(fields);
+        pending_lines.push_back(reader.line_number());
+        if (pending.size() == 1 && !opts.header && opts.dtypes.empty()) {
+            // the first record tells the number of columns
+            reader.singleColumn(fields.size() == 1);
+        }
+    }
+
+    if (!opts.header) {
+        size_t n = pending.empty() ? opts.dtypes.size() : pending[0].size();
+        for (size_t i = 0; i < n; i++) {
+            names.push_back("col" + std::to_string(i));
+        }
+    }
+
+    if (!opts.dtypes.empty() && opts.dtypes.size() != names.size()) {
+        throw std::invalid_argument("CSV: number of data types does not match the number of columns");
+    }
+
+    std::vector<Column> cols(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        cols[i].name = names[i];
+        cols[i].dtype = opts.dtypes.empty() ? infer_type(pending, i) : opts.dtypes[i];
+    }
+
+    check_columns(cols);
+    std::vector<size_t> order(cols.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    DataFrame df = block.createDataFrame(name, type, cols);
+    import_records(df, cols, order, reader, pending, pending_lines, opts.batch_rows);
+    return df;
+}
+
+
+ndsize_t importCsv(DataFrame &df, std::istream &in, const CsvOptions &opts) {
+    RecordReader reader(in, opts.delimiter);
+    std::vector<Column> cols = df.columns();
+    check_columns(cols);
+
+    std::vector<size_t> order(cols.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    // with a header, the fields are matched to the columns by name
+    std::vector<std::string> names;
+    if (opts.header && reader.next(names)) {
+        if (names.size() != cols.size()) {
+            throw std::invalid_argument("CSV: number of columns does not match the DataFrame");
+        }
+
+        for (size_t c = 0; c < cols.size(); c++) {
+            auto it = std::find(names.begin(), names.end(), cols[c].name);
+            if (it == names.end()) {
+                throw std::invalid_argument("CSV: no field for column " + cols[c].name + " in the header");
+            }
+            order[c] = static_cast<size_t>(it - names.begin());
+        }
+    }
+    reader.singleColumn(cols.size() == 1);
+
+    return import_records(df, cols, order, reader, {}, {}, opts.batch_rows);
+}
+
+//
+// Export
+//
+
+static void append_text(std::string &buf, const std::string &str, char delimiter) {
+    const char special[] = {delimiter, '"', '\n', '\r', '\0'};
+
+    if (str.find_first_of(special) == std::string::npos) {
+        buf += str;
+        return;
+    }
+
+    buf += '"';
+    for (char c : str) {
+        if (c == '"') {
+            buf += '"';
+        }
+        buf += c;
+    }
+    buf += '"';
+}
+
+
+static void append_double(std::string &buf, double v) {
+    if (std::isnan(v)) {
+        buf += "nan";
+        return;
+    } else if (std::isinf(v)) {
+        buf += v < 0 ? "-inf" : "inf";
+        return;
+    }
+
+    // printf honours LC_NUMERIC, put back the '.' if needed
+    const char dp = *std::localeconv()->decimal_point;
+    char tmp[32];
+    double back;
+    for (int prec : {15, 17}) {
+        int n = std::snprintf(tmp, sizeof(tmp), "%.*g", prec, v);
+        if (dp != '.') {
+            std::replace(tmp, tmp + n, dp, '.');
+        }
+        if (prec == 17 || (parse_double(tmp, static_cast<size_t>(n), back) && back == v)) {
+            buf.append(tmp, static_cast<size_t>(n));
+            return;
+        }
+    }
+}
+
+
+static void append_value(std::string &buf, const ColumnBuffer &col, size_t i, char delimiter) {
+    switch (col.dataType()) {
+    case DataType::Bool:   buf += col.values<bool>()[i] ? "true" : "false";      break;
+    case DataType::Int32:  buf += std::to_string(col.values<int32_t>()[i]);      break;
+    case DataType::UInt32: buf += std::to_string(col.values<uint32_t>()[i]);     break;
+    case DataType::Int64:  buf += std::to_string(col.values<int64_t>()[i]);      break;
+    case DataType::UInt64: buf += std::to_string(col.values<uint64_t>()[i]);     break;
+    case DataType::Double: append_double(buf, col.values<double>()[i]);          break;
+    case DataType::String: append_text(buf, col.values<std::string>()[i], delimiter); break;
+    default: throw std::invalid_argument("Unsupported DataType for column " + col.name());
+    }
+}
+
+
+void exportCsv(const DataFrame &df, std::ostream &out, const CsvOptions &opts) {
+    if (opts.batch_rows == 0) {
+        throw std::invalid_argument("CSV: batch_rows must not be 0");
+    }
+
+    std::vector<Column> cols = df.columns();
+    std::string buf;
+
+    if (opts.header) {
+        for (size_t c = 0; c < cols.size(); c++) {
+            if (c > 0) {
+                buf += opts.delimiter;
+            }
+            append_text(buf, cols[c].name, opts.delimiter);
+        }
+        buf += '\n';
+    }
+
+    RowBatch batch(cols);
+    const ndsize_t n = df.rows();
+    for (ndsize_t offset = 0; offset < n; offset += opts.batch_rows) {
+        const ndsize_t count = std::min<ndsize_t>(opts.batch_rows, n - offset);
+        df.readColumns(batch, offset, count);
+
+        for (size_t i = 0; i < count; i++) {
+            for (size_t c = 0; c < cols.size(); c++) {
+                if (c > 0) {
+                    buf += opts.delimiter;
+                }
+                append_value(buf, batch.columns[c], i, opts.delimiter);
+            }
+            buf += '\n';
+        }
+
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        buf.clear();
+    }
+
+    out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+}
+
+} // namespace util
+} // namespace nix
@@ -0,0 +1,360 @@
+// Copyright (c) 2017, German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include <nix/util/ioqueue.hpp>
+#include <nix/DataArray.hpp>
+#include <nix/Exception.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nix {
+namespace util {
+
+namespace {
+
+struct Request {
+    enum class Kind { Write, Append, Task };
+
+    Kind kind;
+    DataArray array;
+    DataType dtype;
+    std::shared_ptr<const void> owner;
+    const void *data;
+    NDSize count;
+    NDSize offset;
+    size_t axis;
+    std::function<void()> task;
+    std::vector<std::promise<void>> done;
+
+    Request() = default;
+
+    Request(Request &&other) = default;
+
+    // the promises can only be moved
+    Request(const Request &other) = delete;
+
+    size_t bytes() const {
+        return data_type_to_size(dtype) * count.nelms();
+    }
+};
+
+} // anonymous namespace
+
+
+struct IOQueueState {
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable idle;
+    std::deque<Request> requests;
+    size_t pending;
+    size_t coalesce_bytes;
+};
+
+
+namespace {
+
+/*
+ * Whether next can be written together with head: both write to the same
+ * array handle, next continues head along the first dimension and both
+ * agree in all others.
+ */
+bool continues(const Request &head, const Request &next) {
+    if (head.kind != next.kind || head.kind == Request::Kind::Task ||
+        head.array.impl() != next.array.impl() ||
+        head.dtype != next.dtype || head.dtype == DataType::String ||
+        head.count.size() != next.count.size() || head.count.size() == 0) {
+        return false;
+    }
+
+    for (size_t i = 1; i < head.count.size(); i++) {
+        if (head.count[i] != next.count[i]) {
+            return false;
+        }
+    }
+
+    if (head.kind == Request::Kind::Append) {
+        return head.axis == 0 && next.axis == 0;
+    }
+
+    for (size_t i = 1; i < head.offset.size(); i++) {
+        if (head.offset[i] != next.offset[i]) {
+            return false;
+        }
+    }
+    return next.offset[0] == head.offset[0] + head.count[0];
+}
+
+
+/*
+ * Merge the data of parts into the first part; the data of each part is
+ * contiguous in the first dimension, so it is simply concatenated.
+ */
+void merge(std::vector<Request> &parts) {
+    size_t total = 0;
+    for (const Request &r : parts) {
+        total += r.bytes();
+    }
+
+    std::shared_ptr<std::vector<char>> buffer = std::make_shared<std::vector<char>>(total);
+    Request &head = parts.front();
+    char *ptr = buffer->data();
+    memcpy(ptr, head.data, head.bytes());
+    ptr += head.bytes();
+    for (size_t i = 1; i < parts.size(); i++) {
+        Request &r = parts[i];
+        memcpy(ptr, r.data, r.bytes());
+        ptr += r.bytes();
+        head.count[0] += r.count[0];
+        for (std::promise<void> &p : r.done) {
+            head.done.push_back(std::move(p));
+        }
+    }
+    head.owner = buffer;
+    head.data = buffer->data();
+}
+
+
+// whether the queue was created, see IOQueue::drain()
+std::atomic<bool> started(false);
+
+
+// out of bounds writes fail here, before they get to the backend
+void check_bounds(const Request &request) {
+    const NDSize extent = request.array.dataExtent();
+    if (request.count.size() != extent.size() || request.offset.size() != extent.size()) {
+        throw IncompatibleDimensions("Count, offset and data have different ranks", "IOQueue::write");
+    }
+    for (size_t i = 0; i < extent.size(); i++) {
+        if (request.offset[i] + request.count[i] > extent[i]) {
+            throw OutOfBounds("Write exceeds the data", i);
+        }
+    }
+}
+
+
+// the checks of DataArray::appendData
+void check_append(const Request &request) {
+    const NDSize extent = request.array.dataExtent();
+    if (request.axis >= extent.size()) {
+        throw InvalidRank("axis is out of bounds");
+    }
+    if (request.count.size() != extent.size()) {
+        throw IncompatibleDimensions("Data and DataArray must have the same dimensionality", "IOQueue::append");
+    }
+    for (size_t i = 0; i < extent.size(); i++) {
+        if (i != request.axis && request.count[i] != extent[i]) {
+            throw IncompatibleDimensions("Shape of data and shape of DataArray must match in all dimension but axis!",
+                                         "IOQueue::append");
+        }
+    }
+}
+
+
+void fail(Request &request, std::exception_ptr error) {
+    for (std::promise<void> &p : request.done) {
+        p.set_exception(error);
+    }
+}
+
+
+/*
+ * Check a write or append before it is merged with others, so that an
+ * invalid request fails on its own; true if it can be run.
+ */
+bool check(Request &request) {
+    try {
+        if (request.kind == Request::Kind::Write) {
+            check_bounds(request);
+        } else if (request.kind == Request::Kind::Append) {
+            check_append(request);
+        }
+    } catch (...) {
+        fail(request, std::current_exception());
+        return false;
+    }
+    return true;
+}
+
+
+void run(Request &request) {
+    try {
+        switch (request.kind) {
+        case Request::Kind::Write:
+            request.array.setData(request.dtype, request.data, request.count, request.offset);
+            break;
+        case Request::Kind::Append:
+            request.array.appendData(request.dtype, request.data, request.count, request.axis);
+            break;
+        case Request::Kind::Task:
+            request.task();
+            break;
+        }
+        for (std::promise<void> &p : request.done) {
+            p.set_value();
+        }
+    } catch (...) {
+        fail(request, std::current_exception());
+    }
+}
+
+
+void work(std::shared_ptr<IOQueueState> state) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    for (;;) {
+        state->queued.wait(lock, [&state] { return !state->requests.empty(); });
+
+        // take the first request and those that continue it; each one is
+        // checked against the data before it is merged
+        std::vector<Request> parts;
+        size_t n = 0;
+        size_t total = 0;
+        for (;;) {
+            {
+                Request next = std::move(state->requests.front());
+                state->requests.pop_front();
+                n++;
+                lock.unlock();
+                if (check(next)) {
+                    total += next.kind == Request::Kind::Task ? 0 : next.bytes();
+                    parts.push_back(std::move(next));
+                }
+            }
+            lock.lock();
+            if (parts.empty() || state->requests.empty() ||
+                !continues(parts.back(), state->requests.front()) ||
+                total + state->requests.front().bytes() > state->coalesce_bytes) {
+                break;
+            }
+        }
+        lock.unlock();
+
+        if (parts.size() > 1) {
+            merge(parts);
+        }
+        if (!parts.empty()) {
+            run(parts.front());
+        }
+        // handles and buffers are released before the requests count as done
+        parts.clear();
+
+        lock.lock();
+        state->pending -= n;
+        if (state->pending == 0) {
+            state->idle.notify_all();
+        }
+    }
+}
+
+
+std::future<void> push(IOQueueState &state, Request &&request) {
+    request.done.emplace_back();
+    std::future<void> result = request.done.back().get_future();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.requests.push_back(std::move(request));
+        state.pending++;
+    }
+    state.queued.notify_one();
+    return result;
+}
+
+} // anonymous namespace
+
+
+IOQueue::IOQueue()
+    : state(std::make_shared<IOQueueState>())
+{
+    state->pending = 0;
+    state->coalesce_bytes = 1024 * 1024;
+
+    // the lock is enabled by hold, before the I/O thread starts
+    std::thread(work, state).detach();
+    started.store(true);
+}
+
+
+IOQueue &IOQueue::instance() {
+    // never destroyed, the I/O thread may still run while the process exits
+    static IOQueue *queue = new IOQueue();
+    return *queue;
+}
+
+
+std::future<void> IOQueue::write(const DataArray &array, DataType dtype, const std::shared_ptr<const void> &owner,
+                                 const void *data, const NDSize &count, const NDSize &offset) {
+    Request request;
+    request.kind = Request::Kind::Write;
+    request.array = array;
+    request.dtype = dtype;
+    request.owner = owner;
+    request.data = data;
+    request.count = count;
+    request.offset = offset;
+    request.axis = 0;
+    return push(*state, std::move(request));
+}
+
+
+std::future<void> IOQueue::append(const DataArray &array, DataType dtype, const std::shared_ptr<const void> &owner,
+                                  const void *data, const NDSize &count, size_t axis) {
+    Request request;
+    request.kind = Request::Kind::Append;
+    request.array = array;
+    request.dtype = dtype;
+    request.owner = owner;
+    request.data = data;
+    request.count = count;
+    request.axis = axis;
+    return push(*state, std::move(request));
+}
+
+
+void IOQueue::submit(const std::function<void()> &task) {
+    Request request;
+    request.kind = Request::Kind::Task;
+    request.dtype = DataType::Nothing;
+    request.data = nullptr;
+    request.axis = 0;
+    request.task = task;
+    push(*state, std::move(request));
+}
+
+
+void IOQueue::wait() {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->idle.wait(lock, [this] { return state->pending == 0; });
+}
+
+
+void IOQueue::drain() {
+    if (started.load()) {
+        instance().wait();
+    }
+}
+
+
+size_t IOQueue::coalesceBytes() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->coalesce_bytes;
+}
+
+
+void IOQueue::coalesceBytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->coalesce_bytes = bytes;
+}
+
+} // namespace util
+} // namespace nix
@@ -43,9 +43,15 @@ const map<string, double> PREFIX_FACTORS = {{"y", 1.0e-24}, {"z", 1.0e-21}, {"a"
 
 string createId() {
     typedef boost::mt19937::result_type seed_type;
+    static std::mutex mutex;
     static boost::mt19937 ran(static_cast<seed_type>(std::time(0)));
     static boost::uuids::basic_random_generator<boost::mt19937> gen(&ran);
-    boost::uuids::uuid u = gen();
+    boost::uuids::uuid u;
+    {
+        // the generator is shared, ids are also created outside of the backend lock
+        std::lock_guard<std::mutex> lock(mutex);
+        u = gen();
+    }
     return boost::uuids::to_string(u);
 }
 
@@ -374,6 +374,81 @@ void BaseTestBlock::testGroupAccess() {
 }
 
 
+void BaseTestBlock::testEntityFilter() {
+    Source src = block.createSource("source", "channel");
+    std::vector<std::string> ids;
+
+    for (int i = 0; i < 6; i++) {
+        std::string type = i % 2 ? "nix.odd" : "nix.even";
+        DataArray da = block.createDataArray("array_" + nix::util::numToStr(i), type,
+                                             DataType::Double, nix::NDSize({ 0 }));
+        if (i % 3 == 0) {
+            da.metadata(section);
+            da.addSource(src);
+        }
+        ids.push_back(da.id());
+    }
+
+    // the standard filters and equivalent lambdas (not evaluated by the backend)
+    // must select the same entities in the same order
+    auto check = [this](const util::Filter<DataArray>::type &filter,
+                        const std::function<bool(const DataArray &)> &plain) {
+        std::vector<DataArray> filtered = block.dataArrays(filter);
+        std::vector<DataArray> expected = block.dataArrays(plain);
+        CPPUNIT_ASSERT_EQUAL(expected.size(), filtered.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            CPPUNIT_ASSERT_EQUAL(expected[i].id(), filtered[i].id());
+        }
+        return filtered.size();
+    };
+
+    size_t n = check(util::NameFilter<DataArray>("array_2"),
+                     [](const DataArray &da) { return da.name() == "array_2"; });
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), n);
+
+    n = check(util::NameFilter<DataArray>("nonexistent"),
+              [](const DataArray &da) { return da.name() == "nonexistent"; });
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), n);
+
+    const std::string id = ids[4];
+    n = check(util::IdFilter<DataArray>(id),
+              [&id](const DataArray &da) { return da.id() == id; });
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), n);
+
+    std::vector<std::string> some_ids = {ids[1], ids[3], "not-an-id"};
+    n = check(util::IdsFilter<DataArray>(some_ids),
+              [&some_ids](const DataArray &da) {
+                  return std::find(some_ids.begin(), some_ids.end(), da.id()) != some_ids.end();
+              });
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), n);
+
+    n = check(util::TypeFilter<DataArray>("nix.odd"),
+              [](const DataArray &da) { return da.type() == "nix.odd"; });
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), n);
+
+    n = check(util::TypeFilter<DataArray>("ODD", false),
+              [](const DataArray &da) { return da.type() == "nix.odd"; });
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), n);
+
+    n = check(util::TypeFilter<DataArray>("nix\\..*"),
+              [](const DataArray &da) { return true; });
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), n);
+
+    const std::string sec_id = section.id();
+    n = check(util::MetadataFilter<DataArray>(sec_id),
+              [&sec_id](const DataArray &da) { return da.metadata() && da.metadata().id() == sec_id; });
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), n);
+
+    const std::string src_id = src.id();
+    n = check(util::SourceFilter<DataArray>(src_id),
+              [&src_id](const DataArray &da) { return da.hasSource(src_id); });
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), n);
+
+    std::vector<Source> sources = block.sources(util::TypeFilter<Source>("channel"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), sources.size());
+}
+
+
 void BaseTestBlock::testOperators() {
     CPPUNIT_ASSERT(block_null == false);
     CPPUNIT_ASSERT(block_null == none);
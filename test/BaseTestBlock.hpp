@@ -36,6 +36,7 @@ public:
     void testTagAccess();
     void testMultiTagAccess();
     void testGroupAccess();
+    void testEntityFilter();
 
     void testOperators();
     void testUpdatedAt();
@@ -21,6 +21,7 @@
 #include <nix/util/util.hpp>
 #include <nix/valid/validate.hpp>
 #include <nix/hydra/multiArray.hpp>
+#include <nix/NDArray.hpp>
 
 #include "BaseTestDataArray.hpp"
 
@@ -518,3 +519,254 @@ void BaseTestDataArray::testOperator() {
     CPPUNIT_ASSERT(array1 == false);
     CPPUNIT_ASSERT(array1 == none);
 }
+
+
+void BaseTestDataArray::testAsync() {
+    DataArray da = block.createDataArray("async", "double", DataType::Double, {10, 4});
+
+    // one row at a time, the writes are merged in the queue
+    std::vector<std::future<void>> writes;
+    NDSize offset(2, 0);
+    for (size_t i = 0; i < 10; i++) {
+        std::vector<double> row = {i * 1.0, i * 2.0, i * 3.0, i * 4.0};
+        offset[0] = i;
+        writes.push_back(da.setDataAsync(row, {1, 4}, offset));
+    }
+    std::future<std::vector<double>> read = da.getDataAsync<double>({10, 4}, {0, 0});
+    for (auto &w : writes) {
+        w.get();
+    }
+    std::vector<double> values = read.get();
+    CPPUNIT_ASSERT_EQUAL(size_t(40), values.size());
+    for (size_t i = 0; i < 10; i++) {
+        CPPUNIT_ASSERT_EQUAL(i * 1.0, values[i * 4]);
+        CPPUNIT_ASSERT_EQUAL(i * 4.0, values[i * 4 + 3]);
+    }
+
+    std::future<void> append;
+    for (size_t i = 0; i < 5; i++) {
+        append = da.appendDataAsync(std::vector<double>(8, -1.0 * i), {2, 4}, 0);
+    }
+    append.get();
+    util::IOQueue::instance().wait();
+    CPPUNIT_ASSERT(da.dataExtent() == NDSize({20, 4}));
+    values = da.getDataAsync<double>({2, 4}, {18, 0}).get();
+    CPPUNIT_ASSERT(values == std::vector<double>(8, -4.0));
+
+    std::vector<int> ints = da.getDataAsync<int>({1, 4}, {3, 0}).get();
+    CPPUNIT_ASSERT(ints == std::vector<int>({3, 6, 9, 12}));
+
+    CPPUNIT_ASSERT_THROW(da.setDataAsync(std::vector<double>(3), {1, 4}, {0, 0}), IncompatibleDimensions);
+    std::future<void> outside = da.setDataAsync(std::vector<double>(4), {1, 4}, {30, 0});
+    CPPUNIT_ASSERT_THROW(outside.get(), OutOfBounds);
+
+    // an invalid write does not take the valid one it would be merged with down
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    util::IOQueue::instance().submit([opened] { opened.wait(); });
+    std::future<void> inside = da.setDataAsync(std::vector<double>(4, 9.0), {1, 4}, {19, 0});
+    outside = da.setDataAsync(std::vector<double>(4, 9.0), {1, 4}, {20, 0});
+    gate.set_value();
+    CPPUNIT_ASSERT_NO_THROW(inside.get());
+    CPPUNIT_ASSERT_THROW(outside.get(), OutOfBounds);
+    CPPUNIT_ASSERT(da.getDataAsync<double>({1, 4}, {19, 0}).get() == std::vector<double>(4, 9.0));
+
+    // flushing the file waits for the queued writes
+    da.setDataAsync(std::vector<double>(4, 7.0), {1, 4}, {5, 0});
+    file.flush();
+    values.resize(4);
+    da.getData(DataType::Double, values.data(), {1, 4}, {5, 0});
+    CPPUNIT_ASSERT(values == std::vector<double>(4, 7.0));
+
+    const std::vector<bool> flags = {true, false, true, true};
+    DataArray bools = block.createDataArray("async_bool", "bool", DataType::Bool, {4});
+    bools.setDataAsync(flags, {4}, {0}).get();
+    CPPUNIT_ASSERT(bools.getDataAsync<bool>({4}, {0}).get() == flags);
+    CPPUNIT_ASSERT(!bools.mappedView<bool>()({1}));
+}
+
+
+void BaseTestDataArray::testWriteBuffer() {
+    DataArray da = block.createDataArray("buffered", "double", DataType::Double, {10, 4});
+    CPPUNIT_ASSERT_EQUAL(size_t(0), da.writeBufferSize());
+    da.writeBufferSize(1024);
+    CPPUNIT_ASSERT_EQUAL(size_t(1024), da.writeBufferSize());
+
+    NDSize offset(2, 0);
+    for (size_t i = 0; i < 10; i++) {
+        std::vector<double> row = {i * 1.0, i * 2.0, i * 3.0, i * 4.0};
+        offset[0] = i;
+        da.setData(DataType::Double, row.data(), {1, 4}, offset);
+    }
+    std::vector<double> values(40);
+    da.getData(DataType::Double, values.data(), {10, 4}, {0, 0});
+    for (size_t i = 0; i < 10; i++) {
+        CPPUNIT_ASSERT_EQUAL(i * 1.0, values[i * 4]);
+        CPPUNIT_ASSERT_EQUAL(i * 4.0, values[i * 4 + 3]);
+    }
+
+    for (size_t i = 0; i < 5; i++) {
+        std::vector<double> rows(8, -1.0 * i);
+        da.appendData(DataType::Double, rows.data(), {2, 4}, 0);
+    }
+    CPPUNIT_ASSERT(da.dataExtent() == NDSize({20, 4}));
+
+    // another handle only sees the data after the file is flushed
+    offset[0] = 18;
+    std::vector<double> row(4, 42.0);
+    da.setData(DataType::Double, row.data(), {1, 4}, offset);
+    file.flush();
+    DataArray other = block.getDataArray("buffered");
+    values.resize(4);
+    other.getData(DataType::Double, values.data(), {1, 4}, offset);
+    CPPUNIT_ASSERT(values == std::vector<double>(4, 42.0));
+    other.getData(DataType::Double, values.data(), {1, 4}, {12, 0});
+    CPPUNIT_ASSERT(values == std::vector<double>(4, -1.0));
+
+    // writes outside of the data are not buffered and fail at once
+    CPPUNIT_ASSERT_THROW(da.setData(DataType::Double, row.data(), {1, 4}, {30, 0}), OutOfBounds);
+
+    da.writeBufferSize(0);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), da.writeBufferSize());
+}
+
+
+void BaseTestDataArray::testReadAhead() {
+    std::vector<double> data(100 * 4);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i * 1.0;
+    }
+    DataArray da = block.createDataArray("read_ahead", "double", DataType::Double, {100, 4});
+    da.setData(DataType::Double, data.data(), {100, 4}, {0, 0});
+
+    CPPUNIT_ASSERT_EQUAL(size_t(0), da.readAheadSize());
+    da.readAheadSize(512);
+    CPPUNIT_ASSERT_EQUAL(size_t(512), da.readAheadSize());
+
+    // row by row, the rows after the second read are read ahead
+    std::vector<double> row(4);
+    NDSize offset(2, 0);
+    for (size_t i = 0; i < 100; i++) {
+        offset[0] = i;
+        da.getData(DataType::Double, row.data(), {1, 4}, offset);
+        for (size_t k = 0; k < 4; k++) {
+            CPPUNIT_ASSERT_EQUAL(i * 4.0 + k, row[k]);
+        }
+    }
+
+    // column by column, in another type
+    std::vector<int> column(100);
+    offset[0] = 0;
+    for (size_t k = 0; k < 4; k++) {
+        offset[1] = k;
+        da.getData(DataType::Int32, column.data(), {100, 1}, offset);
+        for (size_t i = 0; i < 100; i++) {
+            CPPUNIT_ASSERT_EQUAL(static_cast<int>(i * 4 + k), column[i]);
+        }
+    }
+
+    // writes drop the data read ahead
+    offset[1] = 0;
+    for (size_t i = 0; i < 3; i++) {
+        offset[0] = i;
+        da.getData(DataType::Double, row.data(), {1, 4}, offset);
+    }
+    std::vector<double> changed(4, -1.0);
+    da.setData(DataType::Double, changed.data(), {1, 4}, {3, 0});
+    offset[0] = 3;
+    da.getData(DataType::Double, row.data(), {1, 4}, offset);
+    CPPUNIT_ASSERT(row == changed);
+
+    da.readAheadSize(0);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), da.readAheadSize());
+}
+
+
+void BaseTestDataArray::testMappedView() {
+    std::vector<double> data(10 * 4);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i * 0.5;
+    }
+    DataArray da = block.createDataArray("mapped", "double", DataType::Double, {10, 4});
+    da.setData(DataType::Double, data.data(), {10, 4}, {0, 0});
+
+    MappedView<double> view = da.mappedView<double>();
+    CPPUNIT_ASSERT(view);
+    CPPUNIT_ASSERT_EQUAL(NDSize({10, 4}), view.shape());
+    CPPUNIT_ASSERT_EQUAL(NDSize({4, 1}), view.strides());
+    CPPUNIT_ASSERT_EQUAL(ndsize_t(40), view.size());
+    for (size_t i = 0; i < 10; i++) {
+        for (size_t k = 0; k < 4; k++) {
+            CPPUNIT_ASSERT_EQUAL(data[i * 4 + k], view({i, k}));
+        }
+    }
+    CPPUNIT_ASSERT_THROW(view.at({10, 0}), OutOfBounds);
+
+    // a part of the data, strided like the whole data if mapped
+    MappedView<double> part = da.mappedView<double>({3, 2}, {5, 1});
+    CPPUNIT_ASSERT_EQUAL(NDSize({3, 2}), part.shape());
+    CPPUNIT_ASSERT_EQUAL(view.mapped(), part.mapped());
+    NDSize strides({2, 1});
+    if (part.mapped()) {
+        strides[0] = 4;
+    }
+    CPPUNIT_ASSERT_EQUAL(strides, part.strides());
+    CPPUNIT_ASSERT_EQUAL(data[5 * 4 + 1], part.at({0, 0}));
+    CPPUNIT_ASSERT_EQUAL(data[7 * 4 + 2], part.at({2, 1}));
+    CPPUNIT_ASSERT_THROW(da.mappedView<double>({3, 2}, {8, 1}), OutOfBounds);
+    CPPUNIT_ASSERT_THROW(da.mappedView<double>({3}, {8}), IncompatibleDimensions);
+
+    // other types and transformed data are read into a buffer
+    MappedView<int> ints = da.mappedView<int>();
+    CPPUNIT_ASSERT(!ints.mapped());
+    CPPUNIT_ASSERT_EQUAL(19, ints({9, 3}));
+
+    da.polynomCoefficients({1.0, 2.0});
+    MappedView<double> poly = da.mappedView<double>();
+    CPPUNIT_ASSERT(!poly.mapped());
+    CPPUNIT_ASSERT_EQUAL(1.0 + 2.0 * data[13], poly({3, 1}));
+
+    // the view outlives the data array and the file
+    da = none;
+    file.close();
+    CPPUNIT_ASSERT_EQUAL(data[39], view({9, 3}));
+}
+
+
+void BaseTestDataArray::testNDArrayView() {
+    NDArray data(DataType::Double, {4, 6});
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t k = 0; k < 6; k++) {
+            data.set<double>(NDSize({i, k}), i * 10.0 + k);
+        }
+    }
+
+    // a transposed view is written through a buffer
+    DataArray da = block.createDataArray("view", "double", DataType::Double, {6, 4});
+    NDArrayView transposed = data.view().transpose();
+    CPPUNIT_ASSERT(!transposed.contiguous());
+    da.setData(transposed, {0, 0});
+
+    NDArray read(DataType::Double, {0, 0});
+    da.getData(read);
+    CPPUNIT_ASSERT_EQUAL(NDSize({6, 4}), read.shape());
+    CPPUNIT_ASSERT_EQUAL(21.0, read.get<double>(NDSize({1, 2})));
+    CPPUNIT_ASSERT_EQUAL(35.0, read.get<double>(NDSize({5, 3})));
+
+    // a row of the data is contiguous and read directly into place
+    NDArrayView row = read.view().slice(0, 2, 1);
+    CPPUNIT_ASSERT(row.contiguous());
+    da.getData(row, {1, 0});
+    CPPUNIT_ASSERT_EQUAL(31.0, read.get<double>(NDSize({2, 3})));
+
+    // a column is strided
+    NDArray target(DataType::Double, {4, 3});
+    NDArrayView column = target.view().slice(1, 1, 1);
+    da.getData(column, {4, 1}, {0, 2});
+    for (size_t i = 0; i < 4; i++) {
+        CPPUNIT_ASSERT_EQUAL(0.0, target.get<double>(i * 3));
+        CPPUNIT_ASSERT_EQUAL(20.0 + i, target.get<double>(i * 3 + 1));
+        CPPUNIT_ASSERT_EQUAL(0.0, target.get<double>(i * 3 + 2));
+    }
+    CPPUNIT_ASSERT_THROW(da.getData(column, {3, 1}, {0, 0}), InvalidRank);
+}
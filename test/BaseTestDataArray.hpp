@@ -38,6 +38,11 @@ public:
     void testAliasRangeDimension();
     void testOperator();
     void testValidate();
+    void testAsync();
+    void testWriteBuffer();
+    void testReadAhead();
+    void testMappedView();
+    void testNDArrayView();
 };
 
 #endif // NIX_BASETESTDATAARRAY_HPP
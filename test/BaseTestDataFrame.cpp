@@ -13,9 +13,12 @@
 #include <iterator>
 #include <stdexcept>
 #include <limits>
+#include <cmath>
 
 #include "BaseTestDataFrame.hpp"
 
+#include <nix/util/csv.hpp>
+
 #include <cppunit/extensions/HelperMacros.h>
 
 
@@ -29,7 +32,8 @@ void BaseTestDataFrame::testBasic() {
         {"string", "", nix::DataType::String},
         {"double", "mV", nix::DataType::Double}};
 
-    nix::DataFrame f1 = block.createDataFrame("isd", "isd", cols);
+    nix::DataFrame f1 = block.createDataFrame("isd", "isd", cols, nix::Compression::Auto, layout);
+    CPPUNIT_ASSERT(f1.layout() == layout);
 
     std::vector<std::string> names(cols.size());
 
@@ -75,17 +79,17 @@ void BaseTestDataFrame::testBasic() {
 
 }
 
-nix::DataFrame createStandardFrame(nix::Block b) {
+nix::DataFrame createStandardFrame(nix::Block b, nix::DataFrameLayout layout) {
         std::vector<nix::Column> cols = {
         {"int32", "V", nix::DataType::Int32},
         {"string", "", nix::DataType::String},
         {"double", "mV", nix::DataType::Double}};
 
-    return b.createDataFrame("frame", "frame", cols);
+    return b.createDataFrame("frame", "frame", cols, nix::Compression::Auto, layout);
 }
 
 void BaseTestDataFrame::testRowIO() {
-    nix::DataFrame df = createStandardFrame(block);
+    nix::DataFrame df = createStandardFrame(block, layout);
 
     std::vector<nix::Variant> vals = {nix::Variant(10),
                                       nix::Variant("test"),
@@ -123,7 +127,7 @@ void BaseTestDataFrame::testRowIO() {
 }
 
 void BaseTestDataFrame::testColIO() {
-    nix::DataFrame df = createStandardFrame(block);
+    nix::DataFrame df = createStandardFrame(block, layout);
     size_t n = 10;
 
     df.rows(n);
@@ -212,7 +216,7 @@ void BaseTestDataFrame::testColIO() {
 }
 
 void BaseTestDataFrame::testCellIO() {
-    nix::DataFrame df = createStandardFrame(block);
+    nix::DataFrame df = createStandardFrame(block, layout);
 
     df.rows(1);
     CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(1), df.rows());
@@ -244,3 +248,275 @@ void BaseTestDataFrame::testCellIO() {
     }
 
 }
+
+void BaseTestDataFrame::testRowsIO() {
+    nix::DataFrame df = createStandardFrame(block, layout);
+    const size_t n = 1000;
+
+    nix::RowBatch batch(df.columns(), n);
+    CPPUNIT_ASSERT_EQUAL(n, batch.rows());
+
+    int32_t *i32 = batch.column("int32").values<int32_t>();
+    std::string *str = batch.column("string").values<std::string>();
+    double *dbl = batch.column("double").values<double>();
+
+    for (size_t i = 0; i < n; i++) {
+        i32[i] = static_cast<int32_t>(i);
+        str[i] = std::to_string(i);
+        dbl[i] = i / static_cast<double>(n);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(0), df.appendRows(batch));
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(n), df.appendRows(batch));
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(2 * n), df.rows());
+
+    nix::RowBatch out = df.readRows(n / 2, n);
+    CPPUNIT_ASSERT_EQUAL(n, out.rows());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), out.columns.size());
+
+    for (size_t i = 0; i < n; i++) {
+        size_t k = (i + n / 2) % n;
+        CPPUNIT_ASSERT_EQUAL(i32[k], out.column("int32").values<int32_t>()[i]);
+        CPPUNIT_ASSERT_EQUAL(str[k], out.column("string").values<std::string>()[i]);
+        CPPUNIT_ASSERT_EQUAL(dbl[k], out.column("double").values<double>()[i]);
+    }
+
+    // same data via the row and variant based API
+    std::vector<nix::Variant> row = df.readRow(n + 3);
+    CPPUNIT_ASSERT_EQUAL(row[1], out.columns[1].get(n / 2 + 3));
+
+    // partial rows: only the given columns are written
+    nix::RowBatch part({{"double", "", nix::DataType::Double}}, 2);
+    part.columns[0].set(0, nix::Variant(-1.0));
+    part.columns[0].set(1, nix::Variant(-2.0));
+    df.writeRows(10, part);
+
+    out = df.readRows(10, 2);
+    CPPUNIT_ASSERT_EQUAL(-1.0, out.column("double").values<double>()[0]);
+    CPPUNIT_ASSERT_EQUAL(-2.0, out.column("double").values<double>()[1]);
+    CPPUNIT_ASSERT_EQUAL(int32_t(10), out.column("int32").values<int32_t>()[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("11"), out.column("string").values<std::string>()[1]);
+
+    /* Error handling */
+    CPPUNIT_ASSERT_THROW(df.readRows(2 * n, 1), nix::OutOfBounds);
+    CPPUNIT_ASSERT_THROW(df.writeRows(2 * n - 1, part), nix::OutOfBounds);
+    CPPUNIT_ASSERT_THROW(out.column("int32").values<int64_t>(), std::invalid_argument);
+    CPPUNIT_ASSERT_THROW(out.column("foo"), std::invalid_argument);
+}
+
+void BaseTestDataFrame::testColumnsIO() {
+    nix::DataFrame df = createStandardFrame(block, layout);
+    const size_t n = 100;
+    df.rows(n);
+
+    std::vector<int32_t> i32(n);
+    std::vector<double> dbl(n);
+    for (size_t i = 0; i < n; i++) {
+        i32[i] = static_cast<int32_t>(i * 2);
+        dbl[i] = i / static_cast<double>(n);
+    }
+
+    df.writeColumn("int32", i32);
+    df.writeColumn("double", dbl);
+
+    nix::RowBatch out = df.readColumns({"double", "int32"}, 10, 20);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), out.columns.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(20), out.rows());
+    CPPUNIT_ASSERT_EQUAL(std::string("double"), out.columns[0].name());
+
+    for (size_t i = 0; i < 20; i++) {
+        CPPUNIT_ASSERT_EQUAL(dbl[i + 10], out.columns[0].values<double>()[i]);
+        CPPUNIT_ASSERT_EQUAL(i32[i + 10], out.columns[1].values<int32_t>()[i]);
+    }
+
+    // all rows from the offset on
+    out = df.readColumns({"int32"}, 90);
+    CPPUNIT_ASSERT_EQUAL(size_t(10), out.rows());
+
+    // caller provided buffers, with type conversion
+    nix::RowBatch dst({{"int32", "", nix::DataType::Int64}});
+    df.readColumns(dst, 0, n);
+    CPPUNIT_ASSERT_EQUAL(n, dst.rows());
+    for (size_t i = 0; i < n; i++) {
+        CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(i32[i]), dst.columns[0].values<int64_t>()[i]);
+    }
+
+    CPPUNIT_ASSERT_THROW(df.readColumns({"int32"}, n + 1), nix::OutOfBounds);
+    CPPUNIT_ASSERT_THROW(df.readColumns(dst, n - 1, 2), nix::OutOfBounds);
+}
+
+void BaseTestDataFrame::testSelect() {
+    std::vector<nix::Column> cols = {
+        {"trial", "", nix::DataType::UInt32},
+        {"rt", "s", nix::DataType::Double},
+        {"correct", "", nix::DataType::Bool},
+        {"stimulus", "", nix::DataType::String}};
+
+    nix::DataFrame df = block.createDataFrame("trials", "frame", cols, nix::Compression::Auto, layout);
+    const size_t n = 1000;
+
+    nix::RowBatch batch(cols, n);
+    for (size_t i = 0; i < n; i++) {
+        batch.columns[0].values<uint32_t>()[i] = static_cast<uint32_t>(i);
+        batch.columns[1].values<double>()[i] = (i % 10) / 10.0;
+        batch.columns[2].values<bool>()[i] = i % 2 == 0;
+        batch.columns[3].values<std::string>()[i] = i % 3 == 0 ? "A" : "B";
+    }
+    df.appendRows(batch);
+
+    // chunk size not a divisor of the number of rows
+    std::vector<nix::ndsize_t> idx = df.select(nix::col("rt") > 0.3 && nix::col("correct") == true, 64);
+    CPPUNIT_ASSERT_EQUAL(size_t(300), idx.size());
+    for (nix::ndsize_t i : idx) {
+        CPPUNIT_ASSERT(i % 2 == 0 && i % 10 > 3);
+    }
+    CPPUNIT_ASSERT(std::is_sorted(idx.begin(), idx.end()));
+
+    // mixed integer types, negation, strings and or
+    idx = df.select(nix::col("trial") < int64_t(-1) || nix::col("trial") >= 995);
+    CPPUNIT_ASSERT_EQUAL(size_t(5), idx.size());
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(995), idx[0]);
+
+    idx = df.select(!(nix::col("stimulus") == "A"));
+    CPPUNIT_ASSERT_EQUAL(size_t(666), idx.size());
+
+    idx = df.select(nix::col("trial") == nix::col("trial") && nix::col("rt") != nix::col("rt"));
+    CPPUNIT_ASSERT(idx.empty());
+
+    // signed vs unsigned 64 bit integers are compared exactly
+    std::vector<nix::Column> ints = {{"s", "", nix::DataType::Int64}, {"u", "", nix::DataType::UInt64}};
+    nix::DataFrame wide = block.createDataFrame("wide", "frame", ints, nix::Compression::Auto, layout);
+    const int64_t big = (int64_t(1) << 53) + 1;
+    nix::RowBatch wide_rows(ints, 3);
+    const int64_t svals[] = {big, -1, 5};
+    const uint64_t uvals[] = {uint64_t(1) << 53, UINT64_MAX, 5};
+    for (size_t i = 0; i < 3; i++) {
+        wide_rows.columns[0].values<int64_t>()[i] = svals[i];
+        wide_rows.columns[1].values<uint64_t>()[i] = uvals[i];
+    }
+    wide.appendRows(wide_rows);
+    CPPUNIT_ASSERT(wide.select(nix::col("s") == (uint64_t(1) << 53)).empty());
+    CPPUNIT_ASSERT(wide.select(nix::col("s") > (uint64_t(1) << 53)) == std::vector<nix::ndsize_t>({0}));
+    CPPUNIT_ASSERT(wide.select(nix::col("s") < nix::col("u")) == std::vector<nix::ndsize_t>({1}));
+    CPPUNIT_ASSERT(wide.select(nix::col("u") >= nix::col("s")) == std::vector<nix::ndsize_t>({1, 2}));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), wide.select(nix::col("u") > int64_t(-1)).size());
+
+    // materialized rows
+    nix::RowBatch sel = df.selectRows(nix::col("trial") > 990 && nix::col("stimulus") == "B", {"stimulus", "rt"}, 7);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), sel.columns.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(6), sel.rows());
+    CPPUNIT_ASSERT_EQUAL(std::string("B"), sel.column("stimulus").values<std::string>()[0]);
+    CPPUNIT_ASSERT_EQUAL(0.1, sel.column("rt").values<double>()[0]);
+
+    sel = df.selectRows(nix::col("trial") < 3);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), sel.columns.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), sel.rows());
+    CPPUNIT_ASSERT_EQUAL(uint32_t(2), sel.column("trial").values<uint32_t>()[2]);
+
+    /* Error handling */
+    CPPUNIT_ASSERT_THROW(df.select(nix::col("stimulus") > 1.0), std::invalid_argument);
+    CPPUNIT_ASSERT_THROW(df.select(nix::col("foo") > 1.0), std::invalid_argument);
+}
+
+void BaseTestDataFrame::testCsv() {
+    std::stringstream csv;
+    csv << "trial,rt,correct,stimulus\r\n"
+        << "1,0.25,true,plain\n"
+        << "2,1e-3,false,\"with, comma\"\n"
+        << "\n"
+        << "3,,TRUE,\"two\nlines and \"\"quotes\"\"\"\n"
+        << "-4,-7.5e2,false,x\n";
+
+    nix::util::CsvOptions opts;
+    opts.batch_rows = 3;
+    nix::DataFrame df = nix::util::importCsv(block, "csv", "frame", csv, opts);
+
+    std::vector<nix::Column> cols = df.columns();
+    CPPUNIT_ASSERT_EQUAL(size_t(4), cols.size());
+    CPPUNIT_ASSERT_EQUAL(nix::DataType::Int64, cols[0].dtype);
+    CPPUNIT_ASSERT_EQUAL(nix::DataType::Double, cols[1].dtype);
+    CPPUNIT_ASSERT_EQUAL(nix::DataType::Bool, cols[2].dtype);
+    CPPUNIT_ASSERT_EQUAL(nix::DataType::String, cols[3].dtype);
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(4), df.rows());
+
+    nix::RowBatch rows = df.readRows(0, 4);
+    CPPUNIT_ASSERT_EQUAL(int64_t(-4), rows.column("trial").values<int64_t>()[3]);
+    CPPUNIT_ASSERT_EQUAL(0.001, rows.column("rt").values<double>()[1]);
+    CPPUNIT_ASSERT_EQUAL(-750.0, rows.column("rt").values<double>()[3]);
+    CPPUNIT_ASSERT(std::isnan(rows.column("rt").values<double>()[2]));
+    CPPUNIT_ASSERT(rows.column("correct").values<bool>()[2]);
+    CPPUNIT_ASSERT_EQUAL(std::string("with, comma"), rows.column("stimulus").values<std::string>()[1]);
+    CPPUNIT_ASSERT_EQUAL(std::string("two\nlines and \"quotes\""), rows.column("stimulus").values<std::string>()[2]);
+
+    // round trip as TSV, appended to the same frame
+    std::stringstream tsv;
+    opts.delimiter = '\t';
+    nix::util::exportCsv(df, tsv, opts);
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(4), nix::util::importCsv(df, tsv, opts));
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(8), df.rows());
+
+    nix::RowBatch again = df.readRows(4, 4);
+    for (size_t i = 0; i < 4; i++) {
+        CPPUNIT_ASSERT_EQUAL(rows.columns[0].values<int64_t>()[i], again.columns[0].values<int64_t>()[i]);
+        CPPUNIT_ASSERT_EQUAL(rows.columns[3].values<std::string>()[i], again.columns[3].values<std::string>()[i]);
+    }
+    CPPUNIT_ASSERT_EQUAL(0.001, again.column("rt").values<double>()[1]);
+
+    // appended fields are matched to the columns by the header
+    std::stringstream shuffled("stimulus,trial,correct,rt\nlast,9,true,2.5\n");
+    opts.delimiter = ',';
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(1), nix::util::importCsv(df, shuffled, opts));
+    nix::RowBatch last = df.readRows(8, 1);
+    CPPUNIT_ASSERT_EQUAL(int64_t(9), last.column("trial").values<int64_t>()[0]);
+    CPPUNIT_ASSERT_EQUAL(2.5, last.column("rt").values<double>()[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("last"), last.column("stimulus").values<std::string>()[0]);
+    std::stringstream renamed("stimulus,trial,correct,time\nx,1,true,2.5\n");
+    CPPUNIT_ASSERT_THROW(nix::util::importCsv(df, renamed, opts), std::invalid_argument);
+
+    // explicit types, no header
+    std::stringstream plain("1;0.1\n2;0.2\n");
+    opts.delimiter = ';';
+    opts.header = false;
+    opts.dtypes = {nix::DataType::Int32, nix::DataType::Double};
+    nix::DataFrame typed = nix::util::importCsv(block, "typed", "frame", plain, opts);
+    CPPUNIT_ASSERT_EQUAL(nix::DataType::Int32, typed.columns()[0].dtype);
+    CPPUNIT_ASSERT_EQUAL(std::string("col1"), typed.columns()[1].name);
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(2), typed.rows());
+
+    /* Error handling */
+    std::stringstream bad("1;x\n");
+    CPPUNIT_ASSERT_THROW(nix::util::importCsv(typed, bad, opts), std::invalid_argument);
+    std::stringstream short_row("1\n");
+    CPPUNIT_ASSERT_THROW(nix::util::importCsv(typed, short_row, opts), std::invalid_argument);
+    std::stringstream too_big("1;0.1\n4294967296;0.2\n");
+    CPPUNIT_ASSERT_THROW(nix::util::importCsv(typed, too_big, opts), std::invalid_argument);
+
+    std::stringstream floats("1;0.1\n");
+    opts.dtypes = {nix::DataType::Int32, nix::DataType::Float};
+    CPPUNIT_ASSERT_THROW(nix::util::importCsv(block, "floats", "frame", floats, opts), std::invalid_argument);
+    CPPUNIT_ASSERT(!block.hasDataFrame("floats"));
+
+    // with a single column, empty lines are records
+    std::stringstream single("s\na\n\nb\n");
+    opts.delimiter = ',';
+    opts.header = true;
+    opts.dtypes = {};
+    nix::DataFrame strs = nix::util::importCsv(block, "single", "frame", single, opts);
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(3), strs.rows());
+    CPPUNIT_ASSERT_EQUAL(std::string(""), strs.readRows(0, 3).columns[0].values<std::string>()[1]);
+
+    std::stringstream exported;
+    nix::util::exportCsv(strs, exported, opts);
+    CPPUNIT_ASSERT_EQUAL(std::string("s\na\n\nb\n"), exported.str());
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(3), nix::util::importCsv(strs, exported, opts));
+    nix::RowBatch twice = strs.readRows(3, 3);
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), twice.columns[0].values<std::string>()[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string(""), twice.columns[0].values<std::string>()[1]);
+    CPPUNIT_ASSERT_EQUAL(std::string("b"), twice.columns[0].values<std::string>()[2]);
+
+    std::stringstream nums("1.5\n\n2\n");
+    opts.header = false;
+    nix::DataFrame dbl = nix::util::importCsv(block, "nums", "frame", nums, opts);
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(3), dbl.rows());
+    CPPUNIT_ASSERT(std::isnan(dbl.readRows(1, 1).columns[0].values<double>()[0]));
+}
@@ -21,6 +21,7 @@ class BaseTestDataFrame : public CPPUNIT_NS::TestFixture {
 protected:
     nix::File file;
     nix::Block block;
+    nix::DataFrameLayout layout;
     time_t startup_time;
 
 public:
@@ -28,6 +29,10 @@ public:
     void testRowIO();
     void testColIO();
     void testCellIO();
+    void testRowsIO();
+    void testColumnsIO();
+    void testSelect();
+    void testCsv();
 };
 
 #endif // NIX_BASETESTDATAFRAME_HPP
@@ -26,6 +26,11 @@ using namespace nix;
 void BaseTestEntity::testId() {
     CPPUNIT_ASSERT(block.id().size() == 36);
     CPPUNIT_ASSERT(util::toId(block).compare(block.id()) == 0);
+
+    std::string id = util::createId();
+    block.forceId(id);
+    CPPUNIT_ASSERT_EQUAL(id, block.id());
+    CPPUNIT_ASSERT_EQUAL(block.name(), file.getBlock(id).name());
 }
 
 
@@ -62,6 +67,9 @@ void BaseTestEntity::testCreatedAt() {
 
 void BaseTestEntity::testUpdatedAt() {
     CPPUNIT_ASSERT(block.updatedAt() >= startup_time);
+    time_t past_time = time(NULL) - 10000000;
+    block.forceUpdatedAt(past_time);
+    CPPUNIT_ASSERT_EQUAL(past_time, block.updatedAt());
 }
 
 
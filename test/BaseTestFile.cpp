@@ -9,8 +9,11 @@
 #include "BaseTestFile.hpp"
 
 #include <nix/util/util.hpp>
+#include <nix/util/convert.hpp>
 #include <nix/valid/validate.hpp>
 #include <ctime>
+#include <set>
+#include <thread>
 #include <boost/filesystem.hpp>
 
 using namespace nix;
@@ -207,3 +210,239 @@ void BaseTestFile::testFlags() {
     flags = static_cast<OpenFlags>(0xFF); // simulate we have more flags
     ASSERT_FLAGS_EQUAL(nix::OpenFlags::Force, flags & nix::OpenFlags::Force);
 }
+
+
+void BaseTestFile::testConvert() {
+    Section section = file_open.createSection("session", "recording");
+    section.createProperty("rate", Variant(44.1)).unit("kHz");
+    Section linked = section.createSection("subject", "subject");
+    Section other = file_open.createSection("template", "subject");
+    linked.link(other);
+
+    block = file_open.createBlock("data", "session");
+    block.metadata(section);
+    Source source = block.createSource("electrode", "hardware");
+    Source channel = source.createSource("channel", "hardware");
+
+    std::vector<double> values(40 * 25);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = i * 0.5;
+    }
+    DataArray da = block.createDataArray("signal", "trace", DataType::Double, {40, 25});
+    da.setData(DataType::Double, values.data(), {40, 25}, {0, 0});
+    da.label("voltage");
+    da.unit("mV");
+    da.addSource(channel);
+    da.appendSampledDimension(0.1).unit("ms");
+    da.appendSetDimension({"a", "b"});
+
+    DataArray positions = block.createDataArray("positions", "events", DataType::Int32, {3});
+    positions.setData(std::vector<int32_t>{1, 5, 9});
+
+    Tag tag = block.createTag("stimulus", "event", {1.0, 2.0});
+    tag.extent({0.5, 1.0});
+    tag.addReference(da);
+    Feature feature = tag.createFeature(positions, LinkType::Indexed);
+    MultiTag mtag = block.createMultiTag("spikes", "event", positions);
+    mtag.addReference(da);
+
+    Group group = block.createGroup("trial", "trial");
+    group.addDataArray(da);
+    group.addTag(tag);
+
+    time_t past_time = time(NULL) - 10000000;
+    da.forceCreatedAt(past_time);
+    da.forceUpdatedAt(past_time + 1);
+
+    // small blocks, the data is copied in several pieces
+    util::ConvertOptions opts;
+    opts.block_bytes = 1000;
+
+    std::vector<std::string> backends = {"hdf5"};
+#ifdef ENABLE_FS_BACKEND
+    backends.push_back("file");
+#endif
+    for (const std::string &backend : backends) {
+        opts.backend = backend;
+        File copy = util::convertFile(file_open, "test_file_convert_" + backend, opts);
+
+        CPPUNIT_ASSERT_EQUAL(file_open.createdAt(), copy.createdAt());
+        CPPUNIT_ASSERT_EQUAL(ndsize_t(2), copy.sectionCount());
+        Section s = copy.getSection(section.id());
+        CPPUNIT_ASSERT_EQUAL(std::string("session"), s.name());
+        if (backend == "hdf5") {
+            // property values are not stored by the file backend yet
+            CPPUNIT_ASSERT(s.getProperty("rate").values() == section.getProperty("rate").values());
+        }
+        CPPUNIT_ASSERT_EQUAL(std::string("kHz"), *s.getProperty("rate").unit());
+        CPPUNIT_ASSERT_EQUAL(other.id(), s.getSection(linked.id()).link().id());
+
+        Block b = copy.getBlock(block.id());
+        CPPUNIT_ASSERT_EQUAL(section.id(), b.metadata().id());
+        CPPUNIT_ASSERT_EQUAL(channel.id(), b.getSource(source.id()).getSource(0).id());
+
+        DataArray d = b.getDataArray(da.id());
+        CPPUNIT_ASSERT(d.dataExtent() == NDSize({40, 25}));
+        std::vector<double> check(values.size());
+        d.getData(DataType::Double, check.data(), {40, 25}, {0, 0});
+        CPPUNIT_ASSERT(check == values);
+        CPPUNIT_ASSERT_EQUAL(std::string("mV"), *d.unit());
+        CPPUNIT_ASSERT_EQUAL(channel.id(), d.getSource(0).id());
+        CPPUNIT_ASSERT_EQUAL(ndsize_t(2), d.dimensionCount());
+        CPPUNIT_ASSERT_EQUAL(0.1, d.getDimension(1).asSampledDimension().samplingInterval());
+        CPPUNIT_ASSERT(d.getDimension(2).asSetDimension().labels() == std::vector<std::string>({"a", "b"}));
+        CPPUNIT_ASSERT_EQUAL(past_time, d.createdAt());
+        CPPUNIT_ASSERT_EQUAL(past_time + 1, d.updatedAt());
+
+        std::vector<int32_t> pos;
+        b.getDataArray(positions.id()).getData(pos);
+        CPPUNIT_ASSERT(pos == std::vector<int32_t>({1, 5, 9}));
+
+        Tag t = b.getTag(tag.id());
+        CPPUNIT_ASSERT(t.extent() == tag.extent());
+        CPPUNIT_ASSERT_EQUAL(da.id(), t.getReference(0).id());
+        CPPUNIT_ASSERT_EQUAL(positions.id(), t.getFeature(feature.id()).data().id());
+        CPPUNIT_ASSERT(t.getFeature(feature.id()).linkType() == LinkType::Indexed);
+
+        MultiTag mt = b.getMultiTag(mtag.id());
+        CPPUNIT_ASSERT_EQUAL(positions.id(), mt.positions().id());
+        CPPUNIT_ASSERT_EQUAL(da.id(), mt.getReference(0).id());
+
+        Group g = b.getGroup(group.id());
+        CPPUNIT_ASSERT(g.hasDataArray(da.id()));
+        CPPUNIT_ASSERT(g.hasTag(tag.id()));
+
+        copy.close();
+    }
+}
+
+
+void BaseTestFile::testThreads() {
+    const bool thread_safe = threadSafe();
+    threadSafe(true);
+
+    const size_t n_threads = 8, n_rounds = 25;
+    std::vector<double> values(1000);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = i * 0.25;
+    }
+    block = file_open.createBlock("shared", "threads");
+    DataArray shared = block.createDataArray("values", "threads", values);
+    const std::string block_id = block.id();
+    const std::string shared_id = shared.id();
+
+    // every thread uses its own handles on the shared entities, copied
+    // before the threads start
+    std::vector<File> files(n_threads, file_open);
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<std::string>> ids(n_threads);
+    std::vector<std::string> errors(n_threads);
+    for (size_t t = 0; t < n_threads; t++) {
+        threads.emplace_back([&, t] {
+            try {
+                File &f = files[t];
+                Block b = f.getBlock(block_id);
+                for (size_t r = 0; r < n_rounds; r++) {
+                    std::vector<double> check;
+                    b.getDataArray(shared_id).getData(check);
+                    if (check != values) {
+                        throw std::runtime_error("data read differs");
+                    }
+
+                    std::string name = "da_" + util::numToStr(t) + "_" + util::numToStr(r);
+                    DataArray da = b.createDataArray(name, "threads", DataType::Int32, {r + 1});
+                    ids[t].push_back(da.id());
+                    ids[t].push_back(util::createId());
+
+                    Section s = f.createSection(name, "threads");
+                    if (b.getDataArray(name).id() != da.id() || f.getSection(s.id()).name() != name) {
+                        throw std::runtime_error("created entity not found");
+                    }
+                    b.dataArrayCount();
+                }
+            } catch (const std::exception &e) {
+                errors[t] = e.what();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    files.clear();
+    threadSafe(thread_safe);
+
+    for (const std::string &error : errors) {
+        CPPUNIT_ASSERT_EQUAL(std::string(), error);
+    }
+    CPPUNIT_ASSERT_EQUAL(ndsize_t(1 + n_threads * n_rounds), block.dataArrayCount());
+    CPPUNIT_ASSERT_EQUAL(ndsize_t(n_threads * n_rounds), file_open.sectionCount());
+
+    std::set<std::string> unique;
+    for (const auto &thread_ids : ids) {
+        unique.insert(thread_ids.begin(), thread_ids.end());
+    }
+    CPPUNIT_ASSERT_EQUAL(2 * n_threads * n_rounds, unique.size());
+}
+
+
+void BaseTestFile::testFilePool() {
+    const bool thread_safe = threadSafe();
+
+    std::vector<double> values(500);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = i * 1.5;
+    }
+    block = file_open.createBlock("pooled", "pool");
+    DataArray da = block.createDataArray("values", "pool", values);
+    file_open.flush();
+
+    std::vector<std::string> errors(6);
+    {
+        FilePool pool(file_open, 3);
+        CPPUNIT_ASSERT_EQUAL(size_t(3), pool.size());
+        CPPUNIT_ASSERT(pool.concurrent() != threadSafe());
+        {
+            FilePool::Handle handle = pool.acquire();
+            File f = handle.file();
+            CPPUNIT_ASSERT(f.fileMode() == FileMode::ReadOnly);
+            CPPUNIT_ASSERT_EQUAL(block.id(), handle.block(block.id()).id());
+            CPPUNIT_ASSERT_EQUAL(da.id(), handle.dataArray(da).id());
+            CPPUNIT_ASSERT(!handle.dataArray(util::createId()));
+
+            FilePool::Handle other = pool.acquire();
+            CPPUNIT_ASSERT(other.file() != f);
+            FilePool::Handle last = pool.acquire();
+            CPPUNIT_ASSERT(!pool.tryAcquire());
+        }
+        CPPUNIT_ASSERT(pool.tryAcquire());
+
+        // more workers than handles, some of them have to wait
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < errors.size(); t++) {
+            threads.emplace_back([&, t] {
+                try {
+                    for (size_t r = 0; r < 20; r++) {
+                        FilePool::Handle handle = pool.acquire();
+                        std::vector<double> check;
+                        handle.dataArray(da.id()).getData(check);
+                        if (check != values) {
+                            throw std::runtime_error("data read differs");
+                        }
+                    }
+                } catch (const std::exception &e) {
+                    errors[t] = e.what();
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+    // the lock the pool enabled ends with it
+    CPPUNIT_ASSERT_EQUAL(thread_safe, threadSafe());
+
+    for (const std::string &error : errors) {
+        CPPUNIT_ASSERT_EQUAL(std::string(), error);
+    }
+}
@@ -51,6 +51,9 @@ public:
     void testCheckHeader();
     void testCompare();
     void testFlags();
+    void testConvert();
+    void testThreads();
+    void testFilePool();
 
 };
 
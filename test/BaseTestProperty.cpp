@@ -105,6 +105,53 @@ void BaseTestProperty::testValues()
 }
 
 
+void BaseTestProperty::testTypedValues()
+{
+    nix::Section section = file.createSection("Area52", "Calibration");
+
+    std::vector<double> table(1000);
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = 0.5 * i;
+    }
+
+    nix::Property p1 = section.createProperty("table", nix::DataType::Double);
+    p1.setValues(table);
+    CPPUNIT_ASSERT_EQUAL(p1.valueCount(), static_cast<ndsize_t>(table.size()));
+
+    std::vector<double> ctrl;
+    p1.getValues(ctrl);
+    CPPUNIT_ASSERT(ctrl == table);
+
+    // the Variant API sees the same values
+    std::vector<nix::Variant> vs = p1.values();
+    CPPUNIT_ASSERT_EQUAL(vs.size(), table.size());
+    CPPUNIT_ASSERT_EQUAL(vs[3].get<double>(), table[3]);
+
+    // numeric conversion on read, type check on write
+    nix::Property p2 = section.createProperty("channels", nix::Variant(int32_t(7)));
+    std::vector<int32_t> channels = {1, 2, 3, 5, 8};
+    p2.setValues(channels);
+    std::vector<double> as_double;
+    p2.getValues(as_double);
+    CPPUNIT_ASSERT_EQUAL(as_double.size(), channels.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0, as_double[4], 1e-12);
+    CPPUNIT_ASSERT_THROW(p2.setValues(table), std::invalid_argument);
+
+    std::vector<std::string> strs = {"Freude", "schoener", "Goetterfunken"};
+    nix::Property p3 = section.createProperty("strings", nix::DataType::String);
+    p3.setValues(strs);
+    std::vector<std::string> str_ctrl;
+    p3.getValues(str_ctrl);
+    CPPUNIT_ASSERT(str_ctrl == strs);
+    CPPUNIT_ASSERT_EQUAL(p3.values()[1].get<std::string>(), strs[1]);
+
+    p3.setValues(std::vector<std::string>());
+    CPPUNIT_ASSERT_EQUAL(p3.valueCount(), static_cast<ndsize_t>(0));
+    p3.getValues(str_ctrl);
+    CPPUNIT_ASSERT(str_ctrl.empty());
+}
+
+
 void BaseTestProperty::testDataType() {
     nix::Section section = file.createSection("Area51", "Boolean");
     std::vector<nix::Variant> strValues = { nix::Variant("Freude"),
@@ -11,7 +11,10 @@
 #include <nix.hpp>
 #include <nix/NDArray.hpp>
 
+#include <atomic>
 #include <cstdio>
+#include <cstdlib>
+#include <new>
 #include <queue>
 #include <random>
 #include <type_traits>
@@ -22,6 +25,7 @@
 #include <stdexcept>
 #include <cstdio>
 #include <string>
+#include <sstream>
 #include <cstdint>
 #include <utility>
 
@@ -410,6 +414,24 @@ public:
     }
 };
 
+class ReadAheadBenchmark : public ReadBenchmark {
+
+public:
+    ReadAheadBenchmark(const Config &cfg)
+            : ReadBenchmark(cfg) {
+    };
+
+    void run(nix::Block block) override {
+        nix::DataArray da = openDataArray(block);
+        da.readAheadSize(4 * 1024 * 1024);
+        test_read_io(da);
+    }
+
+    std::string id() override {
+        return "A";
+    }
+};
+
 class DiskBenchmark : public Benchmark {
 public:
     DiskBenchmark(const Config &cfg)
@@ -533,6 +555,175 @@ public:
 
 /* ************************************ */
 
+// all allocations of the process are counted, see AllocationBenchmark
+static std::atomic<size_t> allocations(0);
+
+void *operator new(std::size_t size) {
+    allocations++;
+    void *ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+
+class AllocationBenchmark : public Benchmark {
+
+public:
+    AllocationBenchmark(const Config &cfg)
+            : Benchmark(cfg), per_read(0.0) {
+    };
+
+    void run(nix::Block block) override {
+        nix::DataArray da = openDataArray(block);
+        nix::NDArray array(config.dtype(), config.size());
+        nix::NDSize pos(config.size().size(), 0);
+        const size_t N = 1000;
+
+        // the first read opens and caches what it needs
+        da.getData(config.dtype(), array.data(), config.size(), pos);
+
+        size_t before = allocations;
+        ssize_t ms = time_it([this, &da, &array, &pos, N] {
+            for (size_t i = 0; i < N; i++) {
+                da.getData(config.dtype(), array.data(), config.size(), pos);
+            }
+        });
+        per_read = static_cast<double>(allocations - before) / N;
+
+        this->count = N;
+        this->millis = ms;
+    }
+
+    double allocationsPerRead() const {
+        return per_read;
+    }
+
+    std::string id() override {
+        return "M";
+    }
+
+private:
+    double per_read;
+};
+
+/* ************************************ */
+
+class SectionTreeBenchmark {
+public:
+    SectionTreeBenchmark(size_t fanout, size_t depth)
+            : fanout(fanout), depth(depth), nsections(0), ms_create(0), ms_find(0), nfound(0) {
+    };
+
+    static std::string level_type(size_t level) {
+        return "nix.bench.level" + std::to_string(level);
+    }
+
+    void run(nix::File fd) {
+        nix::Section root = fd.createSection("tree", "nix.bench.tree");
+
+        ms_create = time_it([this, &root] {
+            std::vector<nix::Section> level = {root};
+            for (size_t d = 1; d <= depth; d++) {
+                std::vector<nix::Section> next;
+                for (nix::Section &parent : level) {
+                    for (size_t i = 0; i < fanout; i++) {
+                        next.push_back(parent.createSection("s" + std::to_string(i), level_type(d)));
+                    }
+                }
+                nsections += next.size();
+                level.swap(next);
+            }
+        });
+
+        // worst case: the only matches are the leaves of the tree
+        nix::util::TypeFilter<nix::Section> filter(level_type(depth));
+        std::vector<nix::Section> found;
+        ms_find = time_it([&root, &filter, &found] {
+            found = root.findRelated(filter);
+        });
+        nfound = found.size();
+    }
+
+    void report() const {
+        std::cout << "Section tree {" << fanout << "^" << depth << " = " << nsections << " sections}, "
+                  << "create: " << ms_create << " ms, "
+                  << "findRelated: " << ms_find << " ms (" << nfound << " found)" << std::endl;
+    }
+
+private:
+    template<typename F>
+    static ssize_t time_it(F func) {
+        Stopwatch watch;
+        func();
+        return watch.ms();
+    }
+
+    size_t fanout;
+    size_t depth;
+    size_t nsections;
+    ssize_t ms_create;
+    ssize_t ms_find;
+    size_t nfound;
+};
+
+/* ************************************ */
+
+class LabelsBenchmark {
+public:
+    LabelsBenchmark(size_t nlabels)
+            : nlabels(nlabels), ms_write(0), ms_read(0) {
+    };
+
+    void run(nix::Block block) {
+        std::vector<std::string> labels;
+        labels.reserve(nlabels);
+        for (size_t i = 0; i < nlabels; i++) {
+            labels.push_back("label " + std::to_string(i));
+        }
+
+        nix::DataArray da = block.createDataArray("labels", "nix.bench.labels", nix::DataType::Double, {nlabels});
+        nix::SetDimension dim = da.appendSetDimension();
+        ms_write = time_it([&dim, &labels] {
+            dim.labels(labels);
+        });
+
+        std::vector<std::string> read;
+        ms_read = time_it([&dim, &read] {
+            read = dim.labels();
+        });
+
+        if (read != labels) {
+            throw std::runtime_error("Labels read do not match the labels written.");
+        }
+    }
+
+    void report(const std::string &backend) const {
+        std::cout << backend << ", SetDimension {" << nlabels << " labels}, "
+                  << "write: " << ms_write << " ms, "
+                  << "read: " << ms_read << " ms" << std::endl;
+    }
+
+private:
+    template<typename F>
+    static ssize_t time_it(F func) {
+        Stopwatch watch;
+        func();
+        return watch.ms();
+    }
+
+    size_t nlabels;
+    ssize_t ms_write;
+    ssize_t ms_read;
+};
+
+/* ************************************ */
+
 static std::vector<Config> make_configs() {
 
     std::vector<Config> configs;
@@ -543,65 +734,127 @@ static std::vector<Config> make_configs() {
     return configs;
 }
 
+struct BackendFile {
+    std::string name;
+    nix::File   fd;
+    nix::Block  block;
+};
+
+static std::vector<BackendFile> open_backends() {
+    std::vector<BackendFile> backends;
+
+    nix::File h5 = nix::File::open("iospeed.h5", nix::FileMode::Overwrite);
+    backends.push_back({"hdf5", h5, h5.createBlock("speed", "nix.test")});
+
+#ifdef ENABLE_FS_BACKEND
+    nix::File fs = nix::File::open("iospeed.nix", nix::FileMode::Overwrite, "file");
+    backends.push_back({"fs", fs, fs.createBlock("speed", "nix.test")});
+#endif
+
+    return backends;
+}
+
 int main(int argc, char **argv)
 {
-    nix::File fd = nix::File::open("iospeed.h5", nix::FileMode::Overwrite);
-    nix::Block block = fd.createBlock("speed", "nix.test");
+    std::vector<BackendFile> backends = open_backends();
+    nix::File fd = backends[0].fd;
+    nix::Block block = backends[0].block;
 
     std::vector<Config> configs = make_configs();
-    std::vector<Benchmark *> marks;
+    std::vector<std::pair<std::string, Benchmark *>> marks;
 
     std::cout << "Performing generators tests..." << std::endl;
     for (const Config &cfg : configs) {
         GeneratorBenchmark *benchmark = new GeneratorBenchmark(cfg);
         benchmark->run(block);
-        marks.push_back(benchmark);
+        marks.emplace_back("-", benchmark);
     }
 
     std::cout << "Performing disk IO tests..." << std::endl;
     for (const Config &cfg : configs) {
         DiskWriteBenchmark *b = new DiskWriteBenchmark(cfg);
         b->run(block);
-        marks.push_back(b);
+        marks.emplace_back("raw", b);
     }
 
     std::cout << "Performing read tests..." << std::endl;
     for (const Config &cfg : configs) {
         DiskReadBenchmark *b = new DiskReadBenchmark(cfg);
         b->run(block);
-        marks.push_back(b);
+        marks.emplace_back("raw", b);
     }
 
-    std::cout << "Performing write tests..." << std::endl;
-    for (const Config &cfg : configs) {
-        WriteBenchmark *benchmark = new WriteBenchmark(cfg);
-        benchmark->run(block);
-        marks.push_back(benchmark);
+    for (BackendFile &backend : backends) {
+        std::cout << "Performing write tests [" << backend.name << "]..." << std::endl;
+        for (const Config &cfg : configs) {
+            WriteBenchmark *benchmark = new WriteBenchmark(cfg);
+            benchmark->run(backend.block);
+            marks.emplace_back(backend.name, benchmark);
+        }
+
+        std::cout << "Performing read tests [" << backend.name << "]..." << std::endl;
+        for (const Config &cfg : configs) {
+            ReadBenchmark *benchmark = new ReadBenchmark(cfg);
+            benchmark->run(backend.block);
+            marks.emplace_back(backend.name, benchmark);
+        }
+
+        std::cout << "Performing read (read-ahead) tests [" << backend.name << "]..." << std::endl;
+        for (const Config &cfg : configs) {
+            ReadAheadBenchmark *benchmark = new ReadAheadBenchmark(cfg);
+            benchmark->run(backend.block);
+            marks.emplace_back(backend.name, benchmark);
+        }
+
+        std::cout << "Performing read (poly) tests [" << backend.name << "]..." << std::endl;
+        for (const Config &cfg : configs) {
+            ReadPolyBenchmark *benchmark = new ReadPolyBenchmark(cfg);
+            benchmark->run(backend.block);
+            marks.emplace_back(backend.name, benchmark);
+        }
     }
 
-    std::cout << "Performing read tests..." << std::endl;
-    for (const Config &cfg : configs) {
-        ReadBenchmark *benchmark = new ReadBenchmark(cfg);
-        benchmark->run(block);
-        marks.push_back(benchmark);
+    std::vector<std::pair<std::string, AllocationBenchmark *>> allocs;
+    for (BackendFile &backend : backends) {
+        std::cout << "Performing allocation tests [" << backend.name << "]..." << std::endl;
+        for (const Config &cfg : configs) {
+            AllocationBenchmark *benchmark = new AllocationBenchmark(cfg);
+            benchmark->run(backend.block);
+            allocs.emplace_back(backend.name, benchmark);
+        }
     }
 
-    std::cout << "Performing read (poly) tests..." << std::endl;
-    for (const Config &cfg : configs) {
-        ReadPolyBenchmark *benchmark = new ReadPolyBenchmark(cfg);
-        benchmark->run(block);
-        marks.push_back(benchmark);
+    std::vector<std::pair<std::string, LabelsBenchmark>> label_benches;
+    for (BackendFile &backend : backends) {
+        std::cout << "Performing label tests [" << backend.name << "]..." << std::endl;
+        label_benches.emplace_back(backend.name, LabelsBenchmark(1000 * 1000));
+        label_benches.back().second.run(backend.block);
     }
 
+    std::cout << "Performing metadata tree tests..." << std::endl;
+    SectionTreeBenchmark tree_bench(10, 5);
+    tree_bench.run(fd);
+
     std::cout << " === Reports ===" << std::endl;
     std::cout.precision(5);
     std::cout.unsetf (std::ios::floatfield);
-    for (Benchmark *mark : marks) {
-        std::cout << mark->cfg().name() << ", " << mark->id() << ", "
-                << mark->speed_in_mbs() << " MB/s, "
-                << mark->speed_in_nps() << " N/s" << std::endl;
-        delete mark;
-    }
+    for (auto &mark : marks) {
+        Benchmark *b = mark.second;
+        std::cout << mark.first << ", " << b->cfg().name() << ", " << b->id() << ", "
+                << b->speed_in_mbs() << " MB/s, "
+                << b->speed_in_nps() << " N/s" << std::endl;
+        delete b;
+    }
+    for (auto &mark : allocs) {
+        AllocationBenchmark *b = mark.second;
+        std::cout << mark.first << ", " << b->cfg().name() << ", " << b->id() << ", "
+                  << b->allocationsPerRead() << " allocations/getData" << std::endl;
+        delete b;
+    }
+    for (auto &mark : label_benches) {
+        mark.second.report(mark.first);
+    }
+    tree_bench.report();
 
 
     return 0;
@@ -28,10 +28,12 @@
 #include "hdf5/TestH5Group.hpp"
 #include "hdf5/TestDataArrayHDF5.hpp"
 #include "hdf5/TestDataFrameHDF5.hpp"
+#include "hdf5/TestDataFrameColumnsHDF5.hpp"
 #include "hdf5/TestBaseTagHDF5.hpp"
 #include "hdf5/TestMultiTagHDF5.hpp"
 #include "hdf5/TestTagHDF5.hpp"
 #include "hdf5/TestPropertyHDF5.hpp"
+#include "hdf5/TestPropertyTableHDF5.hpp"
 #include "hdf5/TestImplContainerHDF5.hpp"
 #include "hdf5/TestDimensionHDF5.hpp"
 #include "hdf5/TestFeatureHDF5.hpp"
@@ -72,12 +74,14 @@ int main(int argc, char* argv[]) {
     CPPUNIT_TEST_SUITE_REGISTRATION(TestDataAccessHDF5);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestDataArrayHDF5);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestDataFrameHDF5);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestDataFrameColumnsHDF5);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestBaseTagHDF5);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestMultiTagHDF5);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestTagHDF5);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestVariant);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestValue);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestPropertyHDF5);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestPropertyTableHDF5);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestNDArray);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestNDSize);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestUtil);
@@ -45,5 +45,79 @@ void TestNDArray::basic() {
 
 }
 
+void TestNDArray::storage() {
+    nix::NDArray A(nix::DataType::Double, nix::NDSize({ 3, 5 }));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), reinterpret_cast<uintptr_t>(A.data()) % nix::NDArray::alignment);
+    for (size_t i = 0; i != 15; ++i) {
+        CPPUNIT_ASSERT_EQUAL(0.0, A.get<double>(i));
+        A.set<double>(i, i);
+    }
+
+    // shrinking keeps the storage
+    const nix::NDArray::byte_type *before = A.data();
+    A.resize(nix::NDSize({ 2, 5 }));
+    CPPUNIT_ASSERT(before == A.data());
+    CPPUNIT_ASSERT_EQUAL(7.0, A.get<double>(nix::NDSize({ 1, 2 })));
+
+    // growing keeps the elements already there
+    A.resize(nix::NDSize({ 4, 5 }));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), reinterpret_cast<uintptr_t>(A.data()) % nix::NDArray::alignment);
+    CPPUNIT_ASSERT_EQUAL(9.0, A.get<double>(9));
+
+    nix::NDArray B = A;
+    CPPUNIT_ASSERT(B.data() != A.data());
+    CPPUNIT_ASSERT_EQUAL(9.0, B.get<double>(9));
+
+    nix::NDArray C(std::move(B));
+    CPPUNIT_ASSERT_EQUAL(nix::NDSize({ 4, 5 }), C.shape());
+    CPPUNIT_ASSERT_EQUAL(9.0, C.get<double>(9));
+
+    C = nix::NDArray(nix::DataType::Int32, nix::NDSize({ 2 }));
+    CPPUNIT_ASSERT_EQUAL(nix::DataType::Int32, C.dtype());
+    CPPUNIT_ASSERT_EQUAL(0, C.get<int32_t>(1));
+}
+
+void TestNDArray::views() {
+    nix::NDArray A(nix::DataType::Int32, nix::NDSize({ 3, 4, 5 }));
+    int32_t values = 0;
+    for (size_t i = 0; i != 60; ++i)
+        A.set<int32_t>(i, values++);
+
+    nix::NDArrayView all = A.view();
+    CPPUNIT_ASSERT(all.contiguous());
+    CPPUNIT_ASSERT_EQUAL(nix::NDSize({ 20, 5, 1 }), all.stride());
+    CPPUNIT_ASSERT_EQUAL(23, all.get<int32_t>(nix::NDSize({ 1, 0, 3 })));
+
+    nix::NDArrayView part = all.slice(1, 1, 2);
+    CPPUNIT_ASSERT(!part.contiguous());
+    CPPUNIT_ASSERT_EQUAL(nix::NDSize({ 3, 2, 5 }), part.shape());
+    CPPUNIT_ASSERT_EQUAL(5, part.get<int32_t>(nix::NDSize({ 0, 0, 0 })));
+    CPPUNIT_ASSERT_EQUAL(52, part.get<int32_t>(nix::NDSize({ 2, 1, 2 })));
+    CPPUNIT_ASSERT(all.slice(0, 1, 1).contiguous());
+    CPPUNIT_ASSERT_THROW(all.slice(3, 0, 1), nix::OutOfBounds);
+    CPPUNIT_ASSERT_THROW(all.slice(1, 3, 2), nix::OutOfBounds);
+
+    nix::NDArrayView T = all.transpose();
+    CPPUNIT_ASSERT_EQUAL(nix::NDSize({ 5, 4, 3 }), T.shape());
+    CPPUNIT_ASSERT_EQUAL(23, T.get<int32_t>(nix::NDSize({ 3, 0, 1 })));
+    nix::NDArrayView S = all.transpose(0, 2);
+    CPPUNIT_ASSERT_EQUAL(nix::NDSize({ 1, 5, 20 }), S.stride());
+
+    // writes through a view change the array
+    part.set<int32_t>(nix::NDSize({ 1, 1, 4 }), -1);
+    CPPUNIT_ASSERT_EQUAL(-1, A.get<int32_t>(nix::NDSize({ 1, 2, 4 })));
+
+    std::vector<int32_t> buffer(30);
+    part.copyTo(buffer.data());
+    CPPUNIT_ASSERT_EQUAL(5, buffer[0]);
+    CPPUNIT_ASSERT_EQUAL(-1, buffer[19]);
+    CPPUNIT_ASSERT_EQUAL(54, buffer[29]);
+
+    std::vector<int32_t> columns(12, 7);
+    all.slice(2, 4, 1).copyFrom(columns.data());
+    CPPUNIT_ASSERT_EQUAL(7, A.get<int32_t>(nix::NDSize({ 2, 3, 4 })));
+    CPPUNIT_ASSERT_EQUAL(58, A.get<int32_t>(nix::NDSize({ 2, 3, 3 })));
+}
+
 void TestNDArray::tearDown() {
 }
@@ -110,3 +110,47 @@ void TestNDSize::testAll() {
     CPPUNIT_ASSERT(!(t <= s));
     CPPUNIT_ASSERT(!(t < u));
 }
+
+
+void TestNDSize::testStorage() {
+    using namespace nix;
+
+    // small sizes are stored inline, larger ones on the heap; copies,
+    // moves and swaps between both must keep the values
+    NDSize small({1, 2, 3});
+    NDSize large(12, 7);
+    large[11] = 42;
+
+    NDSize copy_small(small), copy_large(large);
+    CPPUNIT_ASSERT(copy_small == small);
+    CPPUNIT_ASSERT(copy_large == large);
+    CPPUNIT_ASSERT(copy_small.data() != small.data());
+    CPPUNIT_ASSERT(copy_large.data() != large.data());
+
+    NDSize moved_small(std::move(copy_small));
+    NDSize moved_large(std::move(copy_large));
+    CPPUNIT_ASSERT(moved_small == small);
+    CPPUNIT_ASSERT(moved_large == large);
+    CPPUNIT_ASSERT(copy_small.empty());
+    CPPUNIT_ASSERT(copy_large.empty());
+
+    moved_small.swap(moved_large);
+    CPPUNIT_ASSERT(moved_small == large);
+    CPPUNIT_ASSERT(moved_large == small);
+
+    moved_small = small;
+    moved_large = std::move(large);
+    CPPUNIT_ASSERT(moved_small == small);
+    CPPUNIT_ASSERT_EQUAL(static_cast<NDSize::value_type>(42), moved_large[11]);
+
+    moved_small = moved_small;
+    CPPUNIT_ASSERT(moved_small == small);
+
+    // the full inline rank
+    NDSize eight(8, 1);
+    NDSize nine = eight;
+    nine = NDSize(9, 2);
+    eight = nine;
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(9), eight.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<NDSize::value_type>(512), eight.nelms());
+}
@@ -73,3 +73,38 @@ void TestAttributesFS::testReadField() {
     attrs.get(vector_field, vector_return);
     CPPUNIT_ASSERT(vector_values == vector_return);
 }
+
+void TestAttributesFS::testCache() {
+    boost::filesystem::path p = this->location / "attributes";
+    {
+        file::AttributesFS attrs(this->location.string(), FileMode::Overwrite);
+        attrs.set("format", "nix");
+        attrs.set("created_at", "2015-01-01");
+        CPPUNIT_ASSERT_EQUAL(static_cast<uintmax_t>(0), boost::filesystem::file_size(p));
+
+        // all objects for the same file share the pending changes
+        file::AttributesFS other(this->location.string(), FileMode::ReadOnly);
+        CPPUNIT_ASSERT(other.has("format"));
+
+        attrs.flush();
+        YAML::Node node = YAML::LoadFile(p.string());
+        CPPUNIT_ASSERT_EQUAL(string("nix"), node["format"].as<string>());
+        CPPUNIT_ASSERT(!boost::filesystem::exists(this->location / "attributes.tmp"));
+
+        attrs.remove("format");
+    }
+
+    // written when the last object is gone
+    YAML::Node node = YAML::LoadFile(p.string());
+    CPPUNIT_ASSERT(!node["format"]);
+    CPPUNIT_ASSERT_EQUAL(string("2015-01-01"), node["created_at"].as<string>());
+
+    {
+        file::AttributesFS attrs(this->location.string(), FileMode::ReadWrite);
+        attrs.set("format", "nix");
+        file::AttributesFS::invalidate(this->location);
+    }
+
+    node = YAML::LoadFile(p.string());
+    CPPUNIT_ASSERT(!node["format"]);
+}
@@ -34,6 +34,7 @@ private:
     CPPUNIT_TEST(testHasField);
     CPPUNIT_TEST(testWriteField);
     CPPUNIT_TEST(testReadField);
+    CPPUNIT_TEST(testCache);
     CPPUNIT_TEST_SUITE_END ();
 
     nix::File file;
@@ -55,4 +56,6 @@ public:
 
     void testReadField();
 
+    void testCache();
+
 };
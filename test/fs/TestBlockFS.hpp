@@ -10,6 +10,9 @@
 
 #include "BaseTestBlock.hpp"
 
+#include <boost/filesystem.hpp>
+#include <yaml-cpp/yaml.h>
+
 class TestBlockFS : public BaseTestBlock {
 
     CPPUNIT_TEST_SUITE(TestBlockFS);
@@ -26,12 +29,14 @@ class TestBlockFS : public BaseTestBlock {
     CPPUNIT_TEST(testTagAccess);
     CPPUNIT_TEST(testMultiTagAccess);
     CPPUNIT_TEST(testGroupAccess);
+    CPPUNIT_TEST(testEntityFilter);
 
     CPPUNIT_TEST(testOperators);
     CPPUNIT_TEST(testUpdatedAt);
     CPPUNIT_TEST(testCreatedAt);
 
     CPPUNIT_TEST(testCompare);
+    CPPUNIT_TEST(testEntityIndex);
 
     CPPUNIT_TEST_SUITE_END ();
 
@@ -52,6 +57,36 @@ public:
         file.close();
     }
 
+    void testEntityIndex() {
+        namespace bfs = boost::filesystem;
+        const bfs::path index("test_block/data/block_one/data_arrays/.entity_ids");
+
+        nix::DataArray da = block.createDataArray("indexed", "double", nix::DataType::Double, nix::NDSize({10}));
+        std::string id = da.id();
+        CPPUNIT_ASSERT(block.hasDataArray(id));
+
+        // written when the file is flushed
+        file.close();
+        CPPUNIT_ASSERT(bfs::exists(index));
+        YAML::Node node = YAML::LoadFile(index.string());
+        CPPUNIT_ASSERT_EQUAL(std::string("indexed"), node[id].as<std::string>());
+
+        file = nix::File::open("test_block", nix::FileMode::ReadWrite, "file");
+        block = file.getBlock("block_one");
+        CPPUNIT_ASSERT_EQUAL(std::string("indexed"), block.getDataArray(id).name());
+
+        // a stale index is corrected on lookup
+        block.deleteDataArray(id);
+        CPPUNIT_ASSERT(!block.hasDataArray(id));
+        CPPUNIT_ASSERT_EQUAL(static_cast<nix::ndsize_t>(0), block.dataArrayCount());
+        file.close();
+        node = YAML::LoadFile(index.string());
+        CPPUNIT_ASSERT(!node[id]);
+
+        file = nix::File::open("test_block", nix::FileMode::ReadWrite, "file");
+        block = file.getBlock("block_one");
+    }
+
 };
 
 #endif //NIX_TESTBLOCKFS_HPP
@@ -11,6 +11,12 @@
 
 #include "BaseTestDataArray.hpp"
 
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
 class TestDataArrayFS : public BaseTestDataArray {
 
     CPPUNIT_TEST_SUITE(TestDataArrayFS);
@@ -26,6 +32,15 @@ class TestDataArrayFS : public BaseTestDataArray {
     CPPUNIT_TEST(testAliasRangeDimension);
     CPPUNIT_TEST(testOperator);
     CPPUNIT_TEST(testValidate);
+    CPPUNIT_TEST(testAsync);
+    CPPUNIT_TEST(testWriteBuffer);
+    CPPUNIT_TEST(testReadAhead);
+    CPPUNIT_TEST(testMappedView);
+    CPPUNIT_TEST(testNDArrayView);
+    CPPUNIT_TEST(testChunkStorage);
+    CPPUNIT_TEST(testNpyChunks);
+    CPPUNIT_TEST(testAppendChunks);
+    CPPUNIT_TEST(testMappedChunk);
     CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -58,8 +73,169 @@ public:
         file.close();
     }
 
-    void testData() {
-        // TODO data is not implemented yet
+    void testChunkStorage() {
+        namespace bfs = boost::filesystem;
+        const bfs::path data_dir("test_DataArray/data/block_one/data_arrays/chunked/data");
+
+        // the first dimension grows
+        nix::DataArray da = block.createDataArray("chunked", "int", nix::DataType::Int32, nix::NDSize({0, 300}));
+        CPPUNIT_ASSERT(bfs::is_directory(data_dir));
+        CPPUNIT_ASSERT(!bfs::exists(data_dir / "0.0.npy"));
+
+        std::vector<int32_t> values(1000 * 300);
+        for (size_t i = 0; i < values.size(); i++) {
+            values[i] = static_cast<int32_t>(i);
+        }
+        da.dataExtent({1000, 300});
+        da.setData(nix::DataType::Int32, values.data(), {1000, 300}, {0, 0});
+
+        // 512 x 300 int32 chunks, split along the growing dimension only
+        CPPUNIT_ASSERT(bfs::exists(data_dir / "0.0.npy"));
+        CPPUNIT_ASSERT(bfs::exists(data_dir / "1.0.npy"));
+        CPPUNIT_ASSERT(!bfs::exists(data_dir / "2.0.npy"));
+        CPPUNIT_ASSERT(!bfs::exists(data_dir / "0.1.npy"));
+
+        // a fixed extent is stored in one file, whatever its size
+        const bfs::path fixed_dir("test_DataArray/data/block_one/data_arrays/fixed/data");
+        nix::DataArray fixed = block.createDataArray("fixed", "int", nix::DataType::Int32, nix::NDSize({1000, 300}));
+        fixed.setData(nix::DataType::Int32, values.data(), {1000, 300}, {0, 0});
+        CPPUNIT_ASSERT(bfs::exists(fixed_dir / "0.0.npy"));
+        CPPUNIT_ASSERT(!bfs::exists(fixed_dir / "1.0.npy"));
+        CPPUNIT_ASSERT(fixed.mappedView<int32_t>().mapped());
+
+        // hyperslab across the chunk boundary, converted to double
+        std::vector<double> slab(300 * 280);
+        da.getData(nix::DataType::Double, slab.data(), {300, 280}, {400, 10});
+        for (size_t i = 0; i < 300; i++) {
+            for (size_t j = 0; j < 280; j++) {
+                CPPUNIT_ASSERT_EQUAL(static_cast<double>((400 + i) * 300 + 10 + j), slab[i * 280 + j]);
+            }
+        }
+
+        // shrinking zeroes the data beyond the new extent ...
+        da.dataExtent({600, 300});
+        CPPUNIT_ASSERT(bfs::exists(data_dir / "1.0.npy"));
+        da.dataExtent({1000, 300});
+        std::vector<int32_t> check(1000 * 300);
+        da.getData(nix::DataType::Int32, check.data(), {1000, 300}, {0, 0});
+        for (size_t i = 0; i < check.size(); i++) {
+            CPPUNIT_ASSERT_EQUAL(i < 600 * 300 ? values[i] : 0, check[i]);
+        }
+
+        // ... and removes the chunks outside of it
+        da.dataExtent({500, 300});
+        CPPUNIT_ASSERT(!bfs::exists(data_dir / "1.0.npy"));
+
+        CPPUNIT_ASSERT_THROW(da.getData(nix::DataType::Int32, check.data(), {1, 300}, {500, 0}), nix::OutOfBounds);
+
+        file.close();
+        file = nix::File::open("test_DataArray", nix::FileMode::ReadOnly, "file");
+        da = file.getBlock("block_one").getDataArray("chunked");
+        CPPUNIT_ASSERT_EQUAL(nix::NDSize({500, 300}), da.dataExtent());
+
+        int32_t value = 0;
+        da.getData(value, {499, 299});
+        CPPUNIT_ASSERT_EQUAL(values[499 * 300 + 299], value);
+        CPPUNIT_ASSERT_THROW(da.setData(nix::DataType::Int32, values.data(), {1, 1}, {0, 0}), std::logic_error);
+    }
+
+    void testNpyChunks() {
+        namespace bfs = boost::filesystem;
+        const bfs::path chunk("test_DataArray/data/block_one/data_arrays/npy/data/0.0.npy");
+
+        nix::DataArray da = block.createDataArray("npy", "int", nix::DataType::Int16, nix::NDSize({2, 3}));
+        std::vector<int16_t> values = {1, 2, 3, -4, 5, 256};
+        da.setData(nix::DataType::Int16, values.data(), {2, 3}, {0, 0});
+
+        std::ifstream ifs(chunk.string(), std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        ifs.close();
+
+        // version 1.0 header, aligned payload in little-endian order; the
+        // chunk has room for rows appended later, up to 1 MiB
+        const size_t rows = 131072;
+        CPPUNIT_ASSERT_EQUAL(std::string("\x93NUMPY\x01\x00", 8), content.substr(0, 8));
+        const size_t hlen = static_cast<unsigned char>(content[8]) | static_cast<unsigned char>(content[9]) << 8;
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), (10 + hlen) % 64);
+        CPPUNIT_ASSERT_EQUAL(std::string("{'descr': '<i2', 'fortran_order': False, 'shape': (131072, 3), }"),
+                             content.substr(10, content.find('}') - 9));
+        CPPUNIT_ASSERT_EQUAL('\n', content[9 + hlen]);
+        CPPUNIT_ASSERT_EQUAL(10 + hlen + rows * 3 * sizeof(int16_t), content.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("\x00\x01", 2), content.substr(10 + hlen + 10, 2));
+
+        // files written by numpy itself are read as well ...
+        std::string dict = "{'descr': '<i2', 'fortran_order': False, 'shape': (131072, 3)}";
+        dict.append(128 - 12 - dict.size() - 1, ' ');
+        dict += '\n';
+        std::string foreign = std::string("\x93NUMPY\x02\x00", 8);
+        foreign += static_cast<char>(dict.size());
+        foreign += std::string(3, '\0');
+        foreign += dict;
+        for (int16_t v : {6, 5, 4, 3, 2, 1}) {
+            foreign += static_cast<char>(v);
+            foreign += '\0';
+        }
+        foreign.resize(12 + dict.size() + rows * 3 * sizeof(int16_t), '\0');
+        std::ofstream(chunk.string(), std::ios::binary | std::ios::trunc) << foreign;
+
+        std::vector<int16_t> check(6);
+        da.getData(nix::DataType::Int16, check.data(), {2, 3}, {0, 0});
+        CPPUNIT_ASSERT(check == std::vector<int16_t>({6, 5, 4, 3, 2, 1}));
+
+        // ... but not if they do not match the data
+        dict.replace(dict.find("<i2"), 3, "<f8");
+        std::ofstream(chunk.string(), std::ios::binary | std::ios::trunc) << foreign.substr(0, 12) + dict;
+        CPPUNIT_ASSERT_THROW(da.getData(nix::DataType::Int16, check.data(), {2, 3}, {0, 0}), std::runtime_error);
+    }
+
+    void testAppendChunks() {
+        namespace bfs = boost::filesystem;
+        const bfs::path data_dir("test_DataArray/data/block_one/data_arrays/appended/data");
+
+        // data with a fixed extent that grows later is split into chunks
+        // like growing data, not into chunks of the original extent
+        nix::DataArray da = block.createDataArray("appended", "double", nix::DataType::Double, nix::NDSize({1, 100}));
+        std::vector<double> row(100);
+        for (size_t i = 0; i < 2000; i++) {
+            std::fill(row.begin(), row.end(), static_cast<double>(i));
+            da.appendData(nix::DataType::Double, row.data(), {1, 100}, 0);
+        }
+        CPPUNIT_ASSERT_EQUAL(nix::NDSize({2001, 100}), da.dataExtent());
+
+        // 1024 x 100 doubles per chunk
+        size_t files = 0;
+        for (bfs::directory_iterator it(data_dir), end; it != end; ++it) {
+            files += it->path().extension() == ".npy" ? 1 : 0;
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), files);
+
+        double value = 0;
+        da.getData(value, {2000, 99});
+        CPPUNIT_ASSERT_EQUAL(1999.0, value);
+    }
+
+    void testMappedChunk() {
+        // data in a single chunk is mapped ...
+        nix::DataArray da = block.createDataArray("single", "int", nix::DataType::Int32, nix::NDSize({100, 3}));
+        std::vector<int32_t> values(100 * 3);
+        for (size_t i = 0; i < values.size(); i++) {
+            values[i] = static_cast<int32_t>(i);
+        }
+        da.setData(nix::DataType::Int32, values.data(), {100, 3}, {0, 0});
+
+        nix::MappedView<int32_t> view = da.mappedView<int32_t>();
+        CPPUNIT_ASSERT(view.mapped());
+        CPPUNIT_ASSERT_EQUAL(values[99 * 3 + 2], view({99, 2}));
+
+        // ... and shows later writes
+        values[0] = -1;
+        da.setData(nix::DataType::Int32, values.data(), {1, 1}, {0, 0});
+        CPPUNIT_ASSERT_EQUAL(-1, view({0, 0}));
+
+        // data in several chunks or never written is read
+        nix::DataArray chunked = block.createDataArray("several", "int", nix::DataType::Int32, nix::NDSize({1000, 300}));
+        CPPUNIT_ASSERT(!chunked.mappedView<int32_t>({2, 2}, {0, 0}).mapped());
+        CPPUNIT_ASSERT(!block.createDataArray("empty", "int", nix::DataType::Int32, nix::NDSize({4, 4})).mappedView<int32_t>().mapped());
     }
 
     void testPolynomial() {
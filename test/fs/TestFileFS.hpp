@@ -27,6 +27,9 @@ class TestFileFS: public BaseTestFile {
     CPPUNIT_TEST(testReopen);
     CPPUNIT_TEST(testCheckHeader);
     CPPUNIT_TEST(testFlags);
+    CPPUNIT_TEST(testConvert);
+    CPPUNIT_TEST(testThreads);
+    CPPUNIT_TEST(testFilePool);
     CPPUNIT_TEST(testNonNix);
 
     CPPUNIT_TEST_SUITE_END ();
@@ -13,6 +13,8 @@
 
 #include "BaseTestDataArray.hpp"
 
+#include "hdf5/h5x/H5Group.hpp"
+
 class TestDataArrayHDF5 : public BaseTestDataArray {
 
     CPPUNIT_TEST_SUITE(TestDataArrayHDF5);
@@ -28,6 +30,12 @@ class TestDataArrayHDF5 : public BaseTestDataArray {
     CPPUNIT_TEST(testAliasRangeDimension);
     CPPUNIT_TEST(testOperator);
     CPPUNIT_TEST(testValidate);
+    CPPUNIT_TEST(testAsync);
+    CPPUNIT_TEST(testWriteBuffer);
+    CPPUNIT_TEST(testReadAhead);
+    CPPUNIT_TEST(testMappedView);
+    CPPUNIT_TEST(testNDArrayView);
+    CPPUNIT_TEST(testMappedContiguous);
     CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -60,6 +68,43 @@ public:
         file.close();
     }
 
+    void testMappedContiguous() {
+        std::vector<double> values(100 * 3);
+        for (size_t i = 0; i < values.size(); i++) {
+            values[i] = i * 0.25;
+        }
+        nix::DataArray da = block.createDataArray("contiguous", "double", nix::DataType::Double, nix::NDSize({100, 3}));
+        da.setData(nix::DataType::Double, values.data(), {100, 3}, {0, 0});
+        CPPUNIT_ASSERT(!da.mappedView<double>().mapped());
+        file.close();
+
+        {
+            // replace the chunked data by data stored in one piece
+            namespace h5x = nix::hdf5;
+            h5x::H5Object fd = H5Fopen("test_DataArray.h5", H5F_ACC_RDWR, H5P_DEFAULT);
+            h5x::H5Group root = H5Gopen(fd.h5id(), "/", H5P_DEFAULT);
+            h5x::H5Group group = root.openGroup("data", false).openGroup("block_one", false)
+                                     .openGroup("data_arrays", false).openGroup("contiguous", false);
+            group.removeData("data");
+            h5x::DataSet ds = group.createData("data", h5x::data_type_to_h5_filetype(nix::DataType::Double),
+                                               {100, 3}, nix::Compression::None, {}, {}, false, false);
+            ds.write(values.data(), h5x::data_type_to_h5_memtype(nix::DataType::Double), {100, 3}, {0, 0});
+        }
+
+        file = nix::File::open("test_DataArray.h5", nix::FileMode::ReadOnly);
+        da = file.getBlock("block_one").getDataArray("contiguous");
+        nix::MappedView<double> view = da.mappedView<double>({10, 2}, {90, 1});
+        CPPUNIT_ASSERT(view.mapped());
+        CPPUNIT_ASSERT_EQUAL(nix::NDSize({3, 1}), view.strides());
+        CPPUNIT_ASSERT_EQUAL(values[90 * 3 + 1], view({0, 0}));
+        CPPUNIT_ASSERT_EQUAL(values[99 * 3 + 2], view({9, 1}));
+
+        // other types are converted while reading
+        nix::MappedView<float> floats = da.mappedView<float>();
+        CPPUNIT_ASSERT(!floats.mapped());
+        CPPUNIT_ASSERT_EQUAL(static_cast<float>(values[5]), floats({1, 2}));
+    }
+
 };
 
 #endif //NIX_TESTDATAARRAYHDF5_HPP
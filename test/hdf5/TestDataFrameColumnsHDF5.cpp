@@ -0,0 +1,67 @@
+// Copyright © 2017 German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include "TestDataFrameColumnsHDF5.hpp"
+
+#include "hdf5/h5x/H5Group.hpp"
+
+#include <algorithm>
+
+void TestDataFrameColumnsHDF5::testColumnStorage() {
+    std::vector<nix::Column> cols = {
+        {"time", "s", nix::DataType::Double},
+        {"label", "", nix::DataType::String}};
+
+    nix::DataFrame df = block.createDataFrame("columnar", "frame", cols,
+                                              nix::Compression::DeflateNormal, layout);
+    nix::DataFrame rf = block.createDataFrame("rowwise", "frame", cols);
+    CPPUNIT_ASSERT(df.layout() == nix::DataFrameLayout::Columns);
+    CPPUNIT_ASSERT(rf.layout() == nix::DataFrameLayout::Rows);
+
+    const size_t n = 500;
+    std::vector<double> time(n);
+    for (size_t i = 0; i < n; i++) {
+        time[i] = i * 0.5;
+    }
+
+    df.rows(n);
+    df.writeColumn("time", time);
+    df.writeCells(7, {{"label", nix::Variant("seven")}});
+    std::string frame_id = df.id();
+    file.close();
+
+    // one dataset per column, no compound dataset
+    {
+        nix::hdf5::H5Object fd = H5Fopen("test_DataFrameColumns.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+        nix::hdf5::H5Group root = H5Gopen(fd.h5id(), "/", H5P_DEFAULT);
+        nix::hdf5::H5Group frames = root.openGroup("data", false).openGroup("b1", false).openGroup("data_frames", false);
+        nix::hdf5::H5Group group = frames.openGroup("columnar", false);
+        CPPUNIT_ASSERT(!group.hasData("data"));
+        CPPUNIT_ASSERT(group.openGroup("columns", false).hasData("0"));
+        CPPUNIT_ASSERT(group.openGroup("columns", false).hasData("1"));
+        CPPUNIT_ASSERT(frames.openGroup("rowwise", false).hasData("data"));
+
+        // the column layout is a format feature, older versions refuse the file
+        std::vector<std::string> features;
+        CPPUNIT_ASSERT(root.getAttr("features", features));
+        CPPUNIT_ASSERT(std::find(features.begin(), features.end(), "column_frames") != features.end());
+    }
+
+    // the layout is detected when reopening the file
+    file = nix::File::open("test_DataFrameColumns.h5", nix::FileMode::ReadOnly);
+    df = file.getBlock("b1").getDataFrame(frame_id);
+    CPPUNIT_ASSERT(df.layout() == nix::DataFrameLayout::Columns);
+    CPPUNIT_ASSERT(file.version() == std::vector<int>({1, 2, 0}));
+    CPPUNIT_ASSERT_EQUAL(nix::ndsize_t(n), df.rows());
+    CPPUNIT_ASSERT_EQUAL(std::string("s"), df.columns()[0].unit);
+
+    std::vector<double> time_out(n);
+    df.readColumn("time", time_out);
+    CPPUNIT_ASSERT(time == time_out);
+    CPPUNIT_ASSERT_EQUAL(nix::Variant("seven"), df.readCell(7, "label"));
+}
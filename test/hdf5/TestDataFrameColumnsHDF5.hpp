@@ -0,0 +1,50 @@
+// Copyright © 2017 German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#ifndef NIX_TESTDATAFRAMECOLUMNSHDF5_HPP
+#define NIX_TESTDATAFRAMECOLUMNSHDF5_HPP
+
+#include "BaseTestDataFrame.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+/**
+ * Runs the data frame tests against frames that store each column
+ * in a dataset of its own (DataFrameLayout::Columns).
+ */
+class TestDataFrameColumnsHDF5 : public BaseTestDataFrame {
+
+    CPPUNIT_TEST_SUITE(TestDataFrameColumnsHDF5);
+    CPPUNIT_TEST(testBasic);
+    CPPUNIT_TEST(testRowIO);
+    CPPUNIT_TEST(testColIO);
+    CPPUNIT_TEST(testCellIO);
+    CPPUNIT_TEST(testRowsIO);
+    CPPUNIT_TEST(testColumnsIO);
+    CPPUNIT_TEST(testSelect);
+    CPPUNIT_TEST(testCsv);
+    CPPUNIT_TEST(testColumnStorage);
+    CPPUNIT_TEST_SUITE_END ();
+
+public:
+    void setUp() {
+        startup_time = time(NULL);
+        file = nix::File::open("test_DataFrameColumns.h5", nix::FileMode::Overwrite);
+        block = file.createBlock("b1", "dataset");
+        layout = nix::DataFrameLayout::Columns;
+    }
+
+    void tearDown() {
+        file.close();
+    }
+
+    void testColumnStorage();
+
+};
+
+#endif //NIX_TESTDATAFRAMECOLUMNSHDF5_HPP
@@ -20,6 +20,10 @@ class TestDataFrameHDF5 : public BaseTestDataFrame {
     CPPUNIT_TEST(testRowIO);
     CPPUNIT_TEST(testColIO);
     CPPUNIT_TEST(testCellIO);
+    CPPUNIT_TEST(testRowsIO);
+    CPPUNIT_TEST(testColumnsIO);
+    CPPUNIT_TEST(testSelect);
+    CPPUNIT_TEST(testCsv);
     CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -27,6 +31,7 @@ public:
         startup_time = time(NULL);
         file = nix::File::open("test_DataFrame.h5", nix::FileMode::Overwrite);
         block = file.createBlock("b1", "dataset");
+        layout = nix::DataFrameLayout::Rows;
     }
 
     void tearDown() {
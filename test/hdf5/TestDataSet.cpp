@@ -328,6 +328,34 @@ void TestDataSet::testOpaqueIO() {
     CPPUNIT_ASSERT(memcmp(bytes, bytes_read, sizeof(bytes)) == 0);
 }
 
+void TestDataSet::testStringIO() {
+    // enough strings to fill several blocks of the arena, one larger than a block
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < 2000; i++) {
+        strings.push_back("string " + std::to_string(i));
+    }
+    strings[7] = "";
+    strings[42] = std::string(10000, 'x');
+
+    h5group.setData("strings", strings);
+    std::vector<std::string> read;
+    CPPUNIT_ASSERT(h5group.getData("strings", read));
+    CPPUNIT_ASSERT(strings == read);
+
+    // reading over existing strings replaces them
+    hdf5::DataSet ds = h5group.openData("strings");
+    hdf5::DataSpace fileSpace, memSpace;
+    std::tie(memSpace, fileSpace) = ds.offsetCount2DataSpaces({3}, {41});
+    std::vector<std::string> part = {"a", "b", "c"};
+    {
+        hdf5::StringWriter writer({3}, part.data());
+        ds.read(writer, hdf5::data_type_to_h5_memtype(DataType::String), memSpace, fileSpace);
+    }
+    CPPUNIT_ASSERT_EQUAL(strings[41], part[0]);
+    CPPUNIT_ASSERT_EQUAL(strings[42], part[1]);
+    CPPUNIT_ASSERT_EQUAL(strings[43], part[2]);
+}
+
 void TestDataSet::tearDown() {
     h5group.close();
     H5Fclose(h5file);
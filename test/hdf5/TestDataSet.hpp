@@ -40,6 +40,7 @@ public:
     void testNDArrayIO();
     void testValArrayIO();
     void testOpaqueIO();
+    void testStringIO();
     void tearDown();
 
 private:
@@ -58,6 +59,7 @@ private:
     CPPUNIT_TEST(testNDArrayIO);
     CPPUNIT_TEST(testValArrayIO);
     CPPUNIT_TEST(testOpaqueIO);
+    CPPUNIT_TEST(testStringIO);
     CPPUNIT_TEST_SUITE_END ();
 };
 
@@ -94,8 +94,10 @@ void TestFileHDF5::testVersion() {
     // but cannot write
     ASSERT_NOOPEN(nbc.c_str(), nix::FileMode::ReadWrite);
 
-    // newer y (major breaking change), neither read nor write
-    std::string mbc = make_file_with_version(ver.x(), ver.y() + 1, ver.z());
+    // newer y than the newest supported format (major breaking change),
+    // neither read nor write
+    nix::FormatVersion newest = HDF5_FF_TABLE_VERSION;
+    std::string mbc = make_file_with_version(newest.x(), newest.y() + 1, newest.z());
     ASSERT_NOOPEN(mbc.c_str(), nix::FileMode::ReadWrite);
     ASSERT_NOOPEN(mbc.c_str(), nix::FileMode::ReadOnly);
 
@@ -115,3 +117,93 @@ void TestFileHDF5::testVersion() {
         f.close();
     }
 }
+
+void TestFileHDF5::testIntegerTimestamps() {
+    time_t t = time(NULL) - 1000;
+    std::string block_id;
+
+    {
+        nix::File f = nix::File::open("test_file_int_timestamps.h5", nix::FileMode::Overwrite, "hdf5",
+                                      nix::Compression::Auto, nix::OpenFlags::IntegerTimestamps);
+        CPPUNIT_ASSERT(f.version() == std::vector<int>({1, 2, 0}));
+
+        nix::Block b = f.createBlock("block", "test");
+        b.forceCreatedAt(t);
+        CPPUNIT_ASSERT_EQUAL(b.createdAt(), t);
+        block_id = b.id();
+
+        nix::Section s = f.createSection("section", "test");
+        nix::Property p = s.createProperty("prop", nix::Variant(42));
+        p.forceCreatedAt(t);
+        CPPUNIT_ASSERT_EQUAL(p.createdAt(), t);
+        CPPUNIT_ASSERT(p.updatedAt() >= startup_time);
+        f.close();
+    }
+
+    {
+        h5x::H5Object fd = H5Fopen("test_file_int_timestamps.h5", H5F_ACC_RDWR, H5P_DEFAULT);
+        h5x::H5Group root = H5Gopen(fd.h5id(), "/", H5P_DEFAULT);
+        h5x::H5Group block = root.openGroup("data", false).openGroup("block", false);
+
+        int64_t raw;
+        CPPUNIT_ASSERT(block.getAttr("created_at", raw));
+        CPPUNIT_ASSERT_EQUAL(static_cast<time_t>(raw), t);
+
+        // simulate a time stamp in the legacy string form
+        block.removeAttr("updated_at");
+        block.setAttr("updated_at", nix::util::timeToStr(t));
+    }
+
+    nix::File f = nix::File::open("test_file_int_timestamps.h5", nix::FileMode::ReadWrite);
+    nix::Block b = f.getBlock(block_id);
+    CPPUNIT_ASSERT_EQUAL(b.updatedAt(), t);
+    b.forceUpdatedAt();
+    CPPUNIT_ASSERT(b.updatedAt() >= startup_time);
+    CPPUNIT_ASSERT(f.createBlock("other", "test").createdAt() >= startup_time);
+    f.close();
+
+    {
+        // the feature is kept when the file is reopened
+        h5x::H5Object fd = H5Fopen("test_file_int_timestamps.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+        h5x::H5Group root = H5Gopen(fd.h5id(), "/", H5P_DEFAULT);
+        h5x::H5Group other = root.openGroup("data", false).openGroup("other", false);
+        int64_t raw;
+        CPPUNIT_ASSERT(other.getAttr("created_at", raw));
+    }
+
+    // files without the flag keep using strings
+    CPPUNIT_ASSERT(file_open.version() == std::vector<int>({1, 1, 1}));
+    CPPUNIT_ASSERT(file_open.createdAt() >= startup_time);
+}
+
+void TestFileHDF5::testEntityIdentity() {
+    nix::Block b = file_open.createBlock("identity", "test");
+    nix::DataArray da = b.createDataArray("data", "test", nix::DataType::Double, {10});
+    nix::Tag tag = b.createTag("tag", "test", {1.0});
+    tag.addReference(da);
+    nix::Section s = file_open.createSection("identity", "test");
+    s.createSection("sub", "test");
+
+    // every lookup of an entity in use yields the same backend object
+    CPPUNIT_ASSERT(file_open.getBlock("identity").impl() == b.impl());
+    CPPUNIT_ASSERT(file_open.getBlock(b.id()).impl() == b.impl());
+    CPPUNIT_ASSERT(b.getDataArray("data").impl() == da.impl());
+    CPPUNIT_ASSERT(b.getDataArray(0).impl() == da.impl());
+    CPPUNIT_ASSERT(tag.getReference("data").impl() == da.impl());
+    CPPUNIT_ASSERT(file_open.getSection("identity").impl() == s.impl());
+    nix::Section sub = s.getSection("sub");
+    CPPUNIT_ASSERT(s.getSection(0).impl() == sub.impl());
+
+    // so are their settings
+    da.writeBufferSize(1024);
+    CPPUNIT_ASSERT_EQUAL(size_t(1024), tag.getReference(0).writeBufferSize());
+
+    // an entity deleted and created again is a new one
+    std::string id = da.id();
+    tag = nix::none;
+    CPPUNIT_ASSERT(b.deleteDataArray("data"));
+    da = nix::none;
+    nix::DataArray other = b.createDataArray("data", "test", nix::DataType::Double, {10});
+    CPPUNIT_ASSERT(b.getDataArray("data").id() != id);
+    CPPUNIT_ASSERT(b.getDataArray("data").impl() == other.impl());
+}
@@ -23,6 +23,11 @@ class TestFileHDF5: public BaseTestFile {
     CPPUNIT_TEST(testOperators);
     CPPUNIT_TEST(testReopen);
     CPPUNIT_TEST(testFlags);
+    CPPUNIT_TEST(testConvert);
+    CPPUNIT_TEST(testThreads);
+    CPPUNIT_TEST(testFilePool);
+    CPPUNIT_TEST(testIntegerTimestamps);
+    CPPUNIT_TEST(testEntityIdentity);
     CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -31,6 +36,10 @@ public:
 
     void testVersion() override;
 
+    void testIntegerTimestamps();
+
+    void testEntityIdentity();
+
     void setUp() override {
         startup_time = time(NULL);
         file_open = nix::File::open("test_file.h5", nix::FileMode::Overwrite);
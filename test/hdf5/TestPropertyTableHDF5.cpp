@@ -0,0 +1,134 @@
+// Copyright © 2014 German Neuroinformatics Node (G-Node)
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted under the terms of the BSD License. See
+// LICENSE file in the root of the Project.
+
+#include "TestPropertyTableHDF5.hpp"
+
+#include "hdf5/h5x/H5Group.hpp"
+
+#include <nix/util/util.hpp>
+
+void TestPropertyTableHDF5::testTableStorage() {
+    CPPUNIT_ASSERT(file.version() == std::vector<int>({1, 2, 0}));
+
+    nix::Section s = file.createSection("table section", "test");
+    nix::Property p1 = s.createProperty("p1", nix::Variant(1.0));
+    nix::Property p2 = s.createProperty("p2", nix::Variant("foo"));
+    nix::Property p3 = s.createProperty("p3", nix::Variant(int64_t(42)));
+    p3.unit("mV");
+
+    CPPUNIT_ASSERT_EQUAL(s.propertyCount(), static_cast<nix::ndsize_t>(3));
+    CPPUNIT_ASSERT_EQUAL(s.getProperty(1).name(), std::string("p2"));
+    CPPUNIT_ASSERT_EQUAL(s.getProperty(p3.id()).name(), std::string("p3"));
+
+    // growing and shrinking the values
+    std::vector<std::string> strs = {"a", "bb", "ccc"};
+    p2.setValues(strs);
+    std::vector<std::string> strs_back;
+    p2.getValues(strs_back);
+    CPPUNIT_ASSERT(strs == strs_back);
+
+    p2.setValues(std::vector<std::string>{"d"});
+    CPPUNIT_ASSERT_EQUAL(p2.valueCount(), static_cast<nix::ndsize_t>(1));
+    CPPUNIT_ASSERT_EQUAL(p2.values()[0].get<std::string>(), std::string("d"));
+
+    // handles stay valid if other rows move
+    CPPUNIT_ASSERT(s.deleteProperty(p1.name()));
+    CPPUNIT_ASSERT_EQUAL(s.propertyCount(), static_cast<nix::ndsize_t>(2));
+    CPPUNIT_ASSERT(!p1.isValidEntity());
+    CPPUNIT_ASSERT(p3.isValidEntity());
+    CPPUNIT_ASSERT_EQUAL(*p3.unit(), std::string("mV"));
+    CPPUNIT_ASSERT_EQUAL(p3.values()[0].get<int64_t>(), int64_t(42));
+    CPPUNIT_ASSERT(!s.deleteProperty("p1"));
+
+    std::string section_id = s.id();
+    file.close();
+
+    // properties are stored in the table, not as datasets
+    {
+        nix::hdf5::H5Object fd = H5Fopen("test_property_table.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+        nix::hdf5::H5Group root = H5Gopen(fd.h5id(), "/", H5P_DEFAULT);
+        nix::hdf5::H5Group group = root.openGroup("metadata", false).openGroup("table section", false);
+        CPPUNIT_ASSERT(group.hasData("property_table"));
+        CPPUNIT_ASSERT(!group.hasGroup("properties"));
+    }
+
+    file = nix::File::open("test_property_table.h5", nix::FileMode::ReadWrite);
+    s = file.getSection(section_id);
+    CPPUNIT_ASSERT_EQUAL(s.propertyCount(), static_cast<nix::ndsize_t>(2));
+    CPPUNIT_ASSERT_EQUAL(s.getProperty("p2").values()[0].get<std::string>(), std::string("d"));
+    CPPUNIT_ASSERT_EQUAL(*s.getProperty("p3").unit(), std::string("mV"));
+    file.close();
+
+    file = nix::File::open("test_property_table.h5", nix::FileMode::ReadOnly);
+    CPPUNIT_ASSERT(file.version() == std::vector<int>({1, 2, 0}));
+    CPPUNIT_ASSERT(file.getSection(section_id).hasProperty("p3"));
+
+    // files without the flag keep the classic layout
+    nix::File classic = nix::File::open("test_property_classic.h5", nix::FileMode::Overwrite);
+    CPPUNIT_ASSERT(classic.version() == std::vector<int>({1, 1, 1}));
+    classic.close();
+}
+
+
+static std::vector<nix::Variant> doubles(std::initializer_list<double> vals) {
+    std::vector<nix::Variant> res;
+    for (double v : vals) {
+        res.emplace_back(v);
+    }
+    return res;
+}
+
+
+void TestPropertyTableHDF5::testValueHeap() {
+    nix::Section s = file.createSection("heap section", "test");
+    nix::Property a = s.createProperty("a", doubles({1.0, 2.0, 3.0}));
+    nix::Property b = s.createProperty("b", doubles({4.0, 5.0}));
+
+    // shrinking keeps the slot and gives back the rest
+    a.values(doubles({7.0}));
+    // growing moves the values to the end of the heap
+    a.values(doubles({1.0, 2.0, 3.0, 4.0}));
+    CPPUNIT_ASSERT(b.values() == doubles({4.0, 5.0}));
+    // the last slot grows in place
+    a.values(doubles({1.0, 2.0, 3.0, 4.0, 5.0}));
+
+    nix::Property x = s.createProperty("x", std::vector<nix::Variant>{nix::Variant("a"), nix::Variant("bb")});
+    nix::Property y = s.createProperty("y", nix::Variant("ccc"));
+    x.setValues(std::vector<std::string>{"d", "e", "f"});
+    std::vector<std::string> strs;
+    y.getValues(strs);
+    CPPUNIT_ASSERT(strs == std::vector<std::string>{"ccc"});
+    CPPUNIT_ASSERT(s.deleteProperty("x"));
+    CPPUNIT_ASSERT(s.deleteProperty("y"));
+
+    // rows created and deleted through other handles of the section
+    std::string section_id = s.id();
+    nix::Property c;
+    {
+        nix::Section other = file.getSection(section_id);
+        c = other.createProperty("c", doubles({6.0}));
+    }
+    CPPUNIT_ASSERT(s.hasProperty("c"));
+    CPPUNIT_ASSERT(file.getSection(section_id).deleteProperty("b"));
+    CPPUNIT_ASSERT(!s.hasProperty("b"));
+    CPPUNIT_ASSERT(!b.isValidEntity());
+    CPPUNIT_ASSERT_EQUAL(s.propertyCount(), static_cast<nix::ndsize_t>(2));
+    CPPUNIT_ASSERT(a.values() == doubles({1.0, 2.0, 3.0, 4.0, 5.0}));
+    CPPUNIT_ASSERT(c.values() == doubles({6.0}));
+    CPPUNIT_ASSERT_EQUAL(s.getProperty(1).name(), std::string("c"));
+    file.close();
+
+    // the heap holds the live values only
+    nix::hdf5::H5Object fd = H5Fopen("test_property_table.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    nix::hdf5::H5Group root = H5Gopen(fd.h5id(), "/", H5P_DEFAULT);
+    nix::hdf5::H5Group group = root.openGroup("metadata", false).openGroup("heap section", false);
+    nix::hdf5::DataSet heap = group.openGroup("property_values", false).openData("Double");
+    CPPUNIT_ASSERT_EQUAL(heap.size()[0], static_cast<nix::ndsize_t>(6));
+    heap = group.openGroup("property_values", false).openData("String");
+    CPPUNIT_ASSERT_EQUAL(heap.size()[0], static_cast<nix::ndsize_t>(0));
+}